@@ -36,6 +36,8 @@
 #include <boost/beast/core/make_printable.hpp>
 #include <boost/beast/core/multi_buffer.hpp>
 #include <boost/beast/core/ostream.hpp>
+#include <boost/beast/core/pooled_allocator.hpp>
+#include <boost/beast/core/proxy_protocol.hpp>
 #include <boost/beast/core/rate_policy.hpp>
 #include <boost/beast/core/read_size.hpp>
 #include <boost/beast/core/role.hpp>
@@ -46,5 +48,6 @@
 #include <boost/beast/core/stream_traits.hpp>
 #include <boost/beast/core/string.hpp>
 #include <boost/beast/core/tcp_stream.hpp>
+#include <boost/beast/core/timeout_service.hpp>
 
 #endif
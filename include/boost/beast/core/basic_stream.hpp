@@ -16,6 +16,7 @@
 #include <boost/beast/core/rate_policy.hpp>
 #include <boost/beast/core/role.hpp>
 #include <boost/beast/core/stream_traits.hpp>
+#include <boost/beast/core/timeout_service.hpp>
 #include <boost/asio/async_result.hpp>
 #include <boost/asio/basic_stream_socket.hpp>
 #include <boost/asio/connect.hpp>
@@ -24,6 +25,7 @@
 #include <boost/core/empty_value.hpp>
 #include <boost/config/workaround.hpp>
 #include <boost/enable_shared_from_this.hpp>
+#include <boost/optional.hpp>
 #include <boost/shared_ptr.hpp>
 #include <chrono>
 #include <limits>
@@ -58,6 +60,10 @@ namespace beast {
     @li A <em>RatePolicy</em> may be associated with the stream, to implement
     rate limiting through the policy's interface.
 
+    Timers are only created once a timeout or rate limit first applies.
+    With @ref unlimited_rate_policy and no timeout set, reads and writes
+    pass the caller's buffers directly to the socket.
+
     Although the stream supports multiple concurrent outstanding asynchronous
     operations, the stream object is not thread-safe. The caller is responsible
     for ensuring that the stream is accessed from only one thread at a time.
@@ -237,6 +243,23 @@ private:
         net::is_executor<Executor>::value || net::execution::is_executor<Executor>::value,
         "Executor type requirements not met");
 
+    struct impl_type;
+
+    // A timeout tracked by a timeout_service
+    struct timeout_entry : timeout_service::entry
+    {
+        impl_type* impl = nullptr;
+        op_state* state = nullptr;
+        tick_type tick = 0;
+
+        timeout_entry() noexcept
+            : timeout_service::entry(&on_expire)
+        {
+        }
+
+        static void on_expire(timeout_service::entry& e);
+    };
+
     struct impl_type
         : boost::enable_shared_from_this<impl_type>
         , boost::empty_value<RatePolicy>
@@ -254,9 +277,13 @@ private:
                 std::chrono::steady_clock>,
             Executor> timer; // rate timer;
 #else
-        net::steady_timer timer;
+        // created the first time a rate limit applies
+        boost::optional<net::steady_timer> timer;
 #endif
         int waiting = 0;
+        timeout_service* wheel = nullptr;
+        timeout_entry read_entry;
+        timeout_entry write_entry;
 
         impl_type(impl_type&&) = default;
 
@@ -277,6 +304,14 @@ private:
             return this->socket.get_executor();
         }
 
+        net::steady_timer&
+        rate_timer()
+        {
+            if(! timer)
+                timer.emplace(ex());
+            return *timer;
+        }
+
         RatePolicy&
         policy() noexcept
         {
@@ -292,6 +327,10 @@ private:
         template<class Executor2>
         void on_timer(Executor2 const& ex2);
 
+        template<class Executor2>
+        void arm(op_state& st, Executor2 const& ex2);
+        std::size_t disarm(op_state& st);
+
         void reset();           // set timeouts to never
         void close() noexcept;  // cancel everything
     };
@@ -485,6 +524,31 @@ public:
     void
     expires_never();
 
+    /** Track the timeouts of this stream with a shared timeout service.
+
+        By default each stream waits on its own timers to implement
+        the timeouts set with @ref expires_after and @ref expires_at.
+        After this function is called, pending operations instead
+        arm an entry in the hashed timing wheel of `svc`, which costs
+        no allocation and no system timer per operation. Timeouts
+        may then be reported up to one @ref timeout_service::resolution
+        later than requested.
+
+        When a timeout expires, the stream is closed from a function
+        posted to the executor of the stream, rather than to the
+        executor associated with the completion handler of the
+        pending operation.
+
+        This function must not be called while any asynchronous
+        operation is outstanding.
+
+        @param svc The service to use. It is usually obtained with
+        `net::use_service<timeout_service>(ioc)`, where `ioc` is the
+        I/O context of the stream.
+    */
+    void
+    use_timeout_service(timeout_service& svc);
+
     /** Cancel all asynchronous operations associated with the socket.
 
         This function causes all outstanding asynchronous connect,
@@ -1450,6 +1514,50 @@ public:
         ConstBufferSequence const& buffers,
         WriteHandler&& handler =
             net::default_completion_token_t<Executor>{});
+
+    /** Wait for the socket to become ready asynchronously.
+
+        This function is used to asynchronously wait for the socket to
+        become ready to read, ready to write, or to have pending error
+        conditions. No data is transferred, which allows a caller to
+        defer allocating buffers until data has arrived.
+
+        This call always returns immediately. A wait for reading counts
+        as a read operation, and the program must ensure that no other
+        calls to @ref async_read_some are performed until it completes.
+        Likewise a wait for writing counts as a write operation.
+
+        If the timeout timer for the corresponding direction expires
+        while the operation is outstanding, the operation will be
+        canceled and the completion handler will be invoked with the
+        error @ref error::timeout. The rate limit of the stream does
+        not apply to the wait.
+
+        @param w The type of wait to perform.
+
+        @param handler The completion handler to invoke when the operation
+        completes. The implementation takes ownership of the handler by
+        performing a decay-copy. The equivalent function signature of
+        the handler must be:
+        @code
+        void handler(
+            error_code const& error  // Result of operation.
+        );
+        @endcode
+        Regardless of whether the asynchronous operation completes
+        immediately or not, the handler will not be invoked from within
+        this function. Invocation of the handler will be performed in a
+        manner equivalent to using `net::post`.
+    */
+    template<
+        BOOST_BEAST_ASYNC_TPARAM1 WaitHandler =
+            net::default_completion_token_t<executor_type>
+    >
+    BOOST_BEAST_ASYNC_RESULT1(WaitHandler)
+    async_wait(
+        net::socket_base::wait_type w,
+        WaitHandler&& handler =
+            net::default_completion_token_t<executor_type>{});
 };
 
 } // beast
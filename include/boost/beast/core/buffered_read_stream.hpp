@@ -13,6 +13,7 @@
 #include <boost/beast/core/detail/config.hpp>
 #include <boost/beast/core/error.hpp>
 #include <boost/beast/core/multi_buffer.hpp>
+#include <boost/beast/core/read_size.hpp>
 #include <boost/beast/core/stream_traits.hpp>
 #include <boost/asio/async_result.hpp>
 #include <boost/asio/buffer.hpp>
@@ -101,6 +102,13 @@ class buffered_read_stream
     std::size_t capacity_ = 0;
     Stream next_layer_;
 
+    std::size_t
+    fill_size()
+    {
+        return read_size(buffer_, capacity_ > 0 ?
+            capacity_ : buffer_.max_size());
+    }
+
 public:
     /// The type of the internal buffer
     using buffer_type = DynamicBuffer;
@@ -271,6 +279,107 @@ public:
         ReadHandler&& handler =
             net::default_completion_token_t<executor_type>{});
 
+    /** Read more data into the internal buffer.
+
+        This function reads some data from the next layer and appends
+        it to the internal buffer, without consuming anything already
+        buffered. The received bytes may then be inspected in place
+        using `buffer().data()` and discarded using `buffer().consume()`,
+        and any bytes left in the buffer are returned by subsequent
+        reads. This allows protocol detection to examine the start of
+        a stream without copying it out of the buffer.
+
+        The call blocks until one or more bytes of data have been
+        read, or until an error occurs.
+
+        The number of bytes requested from the next layer is
+        determined by @ref read_size, using the value set with
+        @ref capacity as the maximum. If the capacity is zero, the
+        maximum size of the buffer is used instead.
+
+        @param ec Set to the error, if any occurred. If the internal
+        buffer cannot hold more bytes, the error is
+        `net::error::no_buffer_space`.
+
+        @return The number of bytes appended to the buffer.
+    */
+    std::size_t
+    fill(error_code& ec);
+
+    /** Read more data into the internal buffer.
+
+        This function reads some data from the next layer and appends
+        it to the internal buffer, without consuming anything already
+        buffered. The call blocks until one or more bytes of data have
+        been read, or until an error occurs.
+
+        @return The number of bytes appended to the buffer.
+
+        @throws system_error Thrown on failure.
+    */
+    std::size_t
+    fill();
+
+    /** Read more data into the internal buffer asynchronously.
+
+        This function reads some data from the next layer and appends
+        it to the internal buffer, without consuming anything already
+        buffered. The function call always returns immediately.
+
+        The received bytes may be inspected in place using
+        `buffer().data()`, for example to detect a protocol:
+
+        @code
+        template<class Stream>
+        void on_fill(
+            buffered_read_stream<Stream, flat_buffer>& stream,
+            error_code ec)
+        {
+            if(ec)
+                return fail(ec);
+            auto const b = stream.buffer().data();
+            if(b.size() < 5)
+                return stream.async_fill(
+                    [&stream](error_code ec, std::size_t)
+                    {
+                        on_fill(stream, ec);
+                    });
+            if(string_view(static_cast<char const*>(
+                b.data()), 5) == "PRI *")
+                ... // HTTP/2 connection preface
+
+            // The buffered bytes are handed to the HTTP
+            // parser without being copied.
+            http::async_read(stream.next_layer(),
+                stream.buffer(), parser, handler);
+        }
+        @endcode
+
+        @param handler The completion handler to invoke when the operation
+        completes. The implementation takes ownership of the handler by
+        performing a decay-copy. The equivalent function signature of
+        the handler must be:
+        @code
+        void handler(
+            error_code const& error,      // result of operation
+            std::size_t bytes_transferred // number of bytes appended
+        );
+        @endcode
+        Regardless of whether the asynchronous operation completes
+        immediately or not, the handler will not be invoked from within
+        this function. Invocation of the handler will be performed in a
+        manner equivalent to using `net::post`.
+
+        @see fill
+    */
+    template<
+        BOOST_BEAST_ASYNC_TPARAM2 ReadHandler =
+            net::default_completion_token_t<executor_type>>
+    BOOST_BEAST_ASYNC_RESULT2(ReadHandler)
+    async_fill(
+        ReadHandler&& handler =
+            net::default_completion_token_t<executor_type>{});
+
     /** Write some data to the stream.
 
         This function is used to write data to the stream.
@@ -0,0 +1,71 @@
+//
+// Copyright (c) 2016-2019 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/boostorg/beast
+//
+
+#ifndef BOOST_BEAST_DETAIL_BLOCK_CACHE_HPP
+#define BOOST_BEAST_DETAIL_BLOCK_CACHE_HPP
+
+#include <boost/beast/core/detail/config.hpp>
+#include <cstddef>
+
+namespace boost {
+namespace beast {
+namespace detail {
+
+// Thread-local, size-classed cache of memory blocks.
+//
+// Requests are rounded up to a power of two between
+// 512 bytes and 1 megabyte. Freed blocks are kept on a
+// free list belonging to the calling thread, up to a
+// limit per size class, and handed out again by later
+// requests of the same class on that thread. A block
+// may be freed on a different thread than the one
+// which allocated it. Larger requests, and all requests
+// when thread_local is unavailable, go straight to
+// the global operator new and delete.
+//
+struct block_cache
+{
+    // The size of the smallest class is 2^min_shift
+    static std::size_t constexpr min_shift = 9;
+
+    // The number of size classes
+    static std::size_t constexpr classes = 12;
+
+    // The number of bytes a full free list may
+    // hold, but at least two blocks are kept.
+    static std::size_t constexpr list_bytes = 1024 * 1024;
+
+    // Returns the size of the block used for n bytes
+    BOOST_BEAST_DECL
+    static
+    std::size_t
+    block_size(std::size_t n) noexcept;
+
+    // Returns a block of at least n bytes
+    BOOST_BEAST_DECL
+    static
+    void*
+    allocate(std::size_t n);
+
+    // Return a block allocated with the same n
+    BOOST_BEAST_DECL
+    static
+    void
+    deallocate(void* p, std::size_t n) noexcept;
+};
+
+} // detail
+} // beast
+} // boost
+
+#ifdef BOOST_BEAST_HEADER_ONLY
+#include <boost/beast/core/detail/impl/block_cache.ipp>
+#endif
+
+#endif
@@ -11,7 +11,9 @@
 #define BOOST_BEAST_CORE_DETAIL_FLAT_STREAM_HPP
 
 #include <boost/beast/core/buffer_traits.hpp>
+#include <boost/beast/core/detail/block_cache.hpp>
 #include <boost/asio/buffer.hpp>
+#include <boost/core/exchange.hpp>
 #include <cstdlib>
 
 namespace boost {
@@ -28,6 +30,47 @@ public:
     // Largest stack we will use to flatten
     static std::size_t constexpr max_stack = 8 * 1024;
 
+    // Memory for one flattened write, borrowed from the
+    // calling thread's block cache for the duration of
+    // the write instead of being kept in every stream.
+    class staging
+    {
+        void* p_ = nullptr;
+        std::size_t n_ = 0;
+
+    public:
+        staging() = default;
+        staging& operator=(staging&&) = delete;
+
+        staging(staging&& other) noexcept
+            : p_(boost::exchange(other.p_, nullptr))
+            , n_(other.n_)
+        {
+        }
+
+        ~staging()
+        {
+            reset();
+        }
+
+        void*
+        allocate(std::size_t n)
+        {
+            reset();
+            p_ = block_cache::allocate(n);
+            n_ = n;
+            return p_;
+        }
+
+        void
+        reset() noexcept
+        {
+            if(p_)
+                block_cache::deallocate(
+                    boost::exchange(p_, nullptr), n_);
+        }
+    };
+
     struct flatten_result
     {
         std::size_t size;
@@ -44,6 +87,10 @@ public:
         flatten_result result{0, false};
         auto first = net::buffer_sequence_begin(buffers);
         auto last = net::buffer_sequence_end(buffers);
+        // Leading empty buffers would otherwise make
+        // a write of a non-empty sequence transfer nothing
+        while(first != last && buffer_bytes(*first) == 0)
+            ++first;
         if(first != last)
         {
             result.size = buffer_bytes(*first);
@@ -0,0 +1,114 @@
+//
+// Copyright (c) 2016-2019 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/boostorg/beast
+//
+
+#ifndef BOOST_BEAST_DETAIL_IMPL_BLOCK_CACHE_IPP
+#define BOOST_BEAST_DETAIL_IMPL_BLOCK_CACHE_IPP
+
+#include <boost/beast/core/detail/block_cache.hpp>
+#include <boost/beast/core/detail/thread_local_instance.hpp>
+#include <algorithm>
+#include <new>
+
+namespace boost {
+namespace beast {
+namespace detail {
+
+struct block_cache_lists
+{
+    struct node
+    {
+        node* next;
+    };
+
+    node* head[block_cache::classes] = {};
+    std::size_t count[block_cache::classes] = {};
+
+    block_cache_lists() = default;
+    block_cache_lists(block_cache_lists const&) = delete;
+    block_cache_lists& operator=(block_cache_lists const&) = delete;
+
+    ~block_cache_lists()
+    {
+        for(auto& h : head)
+        {
+            while(h)
+            {
+                auto const next = h->next;
+                ::operator delete(h);
+                h = next;
+            }
+        }
+    }
+};
+
+// Returns the size class for n, or classes if uncached
+inline
+std::size_t
+block_cache_class(std::size_t n) noexcept
+{
+    std::size_t c = 0;
+    while(c < block_cache::classes &&
+        (std::size_t{1} << (block_cache::min_shift + c)) < n)
+        ++c;
+    return c;
+}
+
+std::size_t
+block_cache::
+block_size(std::size_t n) noexcept
+{
+    auto const c = block_cache_class(n);
+    if(c == classes)
+        return n;
+    return std::size_t{1} << (min_shift + c);
+}
+
+void*
+block_cache::
+allocate(std::size_t n)
+{
+    auto const c = block_cache_class(n);
+    if(c == classes)
+        return ::operator new(n);
+    auto const lists = thread_local_instance<block_cache_lists>();
+    if(lists && lists->head[c])
+    {
+        auto const p = lists->head[c];
+        lists->head[c] = p->next;
+        --lists->count[c];
+        return p;
+    }
+    return ::operator new(std::size_t{1} << (min_shift + c));
+}
+
+void
+block_cache::
+deallocate(void* p, std::size_t n) noexcept
+{
+    if(! p)
+        return;
+    auto const c = block_cache_class(n);
+    if(c == classes)
+        return ::operator delete(p);
+    auto const lists = thread_local_instance<block_cache_lists>();
+    auto const limit = (std::max)(std::size_t{2},
+        list_bytes >> (min_shift + c));
+    if(! lists || lists->count[c] >= limit)
+        return ::operator delete(p);
+    auto const node = ::new(p) block_cache_lists::node;
+    node->next = lists->head[c];
+    lists->head[c] = node;
+    ++lists->count[c];
+}
+
+} // detail
+} // beast
+} // boost
+
+#endif
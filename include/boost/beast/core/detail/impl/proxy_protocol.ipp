@@ -0,0 +1,328 @@
+//
+// Copyright (c) 2016-2019 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/boostorg/beast
+//
+
+#ifndef BOOST_BEAST_DETAIL_IMPL_PROXY_PROTOCOL_IPP
+#define BOOST_BEAST_DETAIL_IMPL_PROXY_PROTOCOL_IPP
+
+#include <boost/beast/core/detail/proxy_protocol.hpp>
+#include <boost/beast/core/proxy_protocol.hpp>
+#include <boost/beast/core/string.hpp>
+#include <boost/asio/ip/address.hpp>
+#include <algorithm>
+#include <cstring>
+
+namespace boost {
+namespace beast {
+namespace detail {
+
+struct proxy_header_parser
+{
+    using address = net::ip::address;
+    using endpoint = net::ip::tcp::endpoint;
+
+    // Returns the number of leading octets of p[0..n)
+    // which match the first octets of s[0..len).
+    // A full match of len octets means the prefix is
+    // present, fewer than min(n, len) is a mismatch.
+    static
+    std::size_t
+    match(
+        char const* p, std::size_t n,
+        char const* s, std::size_t len)
+    {
+        auto const m = (std::min)(n, len);
+        for(std::size_t i = 0; i < m; ++i)
+            if(p[i] != s[i])
+                return i;
+        return m;
+    }
+
+    // Split off the next token delimited by a single SP
+    static
+    bool
+    token(
+        char const*& it, char const* end,
+        char const*& first, char const*& last)
+    {
+        first = it;
+        while(it != end && *it != ' ')
+            ++it;
+        last = it;
+        if(it != end)
+            ++it;
+        return first != last;
+    }
+
+    static
+    bool
+    parse_address(
+        char const* first, char const* last,
+        bool v6, address& a)
+    {
+        // INET6_ADDRSTRLEN
+        char buf[46];
+        auto const len = static_cast<std::size_t>(last - first);
+        if(len >= sizeof(buf))
+            return false;
+        std::memcpy(buf, first, len);
+        buf[len] = 0;
+        error_code ec;
+        if(v6)
+            a = net::ip::make_address_v6(buf, ec);
+        else
+            a = net::ip::make_address_v4(buf, ec);
+        return ! ec;
+    }
+
+    static
+    bool
+    parse_port(
+        char const* first, char const* last,
+        unsigned short& port)
+    {
+        auto const len = last - first;
+        if(len < 1 || len > 5)
+            return false;
+        // no leading zeroes
+        if(len > 1 && *first == '0')
+            return false;
+        std::uint32_t v = 0;
+        for(; first != last; ++first)
+        {
+            if(*first < '0' || *first > '9')
+                return false;
+            v = 10 * v + static_cast<std::uint32_t>(*first - '0');
+        }
+        if(v > 65535)
+            return false;
+        port = static_cast<unsigned short>(v);
+        return true;
+    }
+
+    /*  Version 1
+
+        "PROXY" SP ( "UNKNOWN" *( %x20-7E ) /
+            ( "TCP4" / "TCP6" ) SP src-addr SP dst-addr
+            SP src-port SP dst-port ) CRLF
+
+        The complete line is at most 107 octets.
+    */
+    static
+    std::size_t
+    parse_v1(
+        char const* p, std::size_t n,
+        proxy_header& h, error_code& ec)
+    {
+        std::size_t const limit = 107;
+        auto const end = p + (std::min)(n, limit);
+        auto eol = p + 6;
+        for(;; ++eol)
+        {
+            if(eol == end)
+                break;
+            if(*eol == '\r')
+            {
+                if(end - eol < 2)
+                    break;
+                if(eol[1] == '\n')
+                    break;
+            }
+            if(*eol < 0x20 || *eol > 0x7e)
+            {
+                ec = error::bad_proxy_header;
+                return 0;
+            }
+        }
+        if(end - eol < 2)
+        {
+            if(n >= limit)
+                ec = error::bad_proxy_header;
+            // else need more
+            return 0;
+        }
+        std::size_t const used = eol + 2 - p;
+
+        h.version = 1;
+        auto it = p + 6;
+        char const* first;
+        char const* last;
+        token(it, eol, first, last);
+        string_view const proto(first, last - first);
+        if(proto == "UNKNOWN")
+            return used;
+        bool v6;
+        if(proto == "TCP4")
+            v6 = false;
+        else if(proto == "TCP6")
+            v6 = true;
+        else
+        {
+            ec = error::bad_proxy_header;
+            return 0;
+        }
+        address src;
+        address dst;
+        unsigned short src_port;
+        unsigned short dst_port;
+        if(! (
+            token(it, eol, first, last) &&
+                parse_address(first, last, v6, src) &&
+            token(it, eol, first, last) &&
+                parse_address(first, last, v6, dst) &&
+            token(it, eol, first, last) &&
+                parse_port(first, last, src_port) &&
+            token(it, eol, first, last) &&
+                parse_port(first, last, dst_port) &&
+            it == eol && last == eol))
+        {
+            ec = error::bad_proxy_header;
+            return 0;
+        }
+        h.proxied = true;
+        h.source = endpoint(src, src_port);
+        h.destination = endpoint(dst, dst_port);
+        return used;
+    }
+
+    static
+    unsigned short
+    get_uint16(char const* p)
+    {
+        return static_cast<unsigned short>(
+            (static_cast<unsigned char>(p[0]) << 8) +
+             static_cast<unsigned char>(p[1]));
+    }
+
+    /*  Version 2
+
+         0  12 octets   signature
+        12  1 octet     version (high nibble) and command
+        13  1 octet     address family (high nibble)
+                        and transport protocol
+        14  uint16      length of the remainder
+        16              addresses, followed by TLVs
+    */
+    static
+    std::size_t
+    parse_v2(
+        char const* p, std::size_t n,
+        std::size_t size, proxy_header& h,
+        error_code& ec)
+    {
+        if(n < 16)
+            return 0;
+        auto const ver_cmd =
+            static_cast<unsigned char>(p[12]);
+        auto const fam =
+            static_cast<unsigned char>(p[13]);
+        std::size_t const len = get_uint16(p + 14);
+        if( (ver_cmd >> 4) != 2 ||
+            (ver_cmd & 0x0f) > 1 ||
+            (fam >> 4) > 3 ||
+            (fam & 0x0f) > 2)
+        {
+            ec = error::bad_proxy_header;
+            return 0;
+        }
+        // AF_INET, AF_INET6 and AF_UNIX
+        static std::size_t const addr_len[] = { 0, 12, 36, 216 };
+        if(len < addr_len[fam >> 4])
+        {
+            ec = error::bad_proxy_header;
+            return 0;
+        }
+        if(size < 16 + len)
+            return 0;
+
+        h.version = 2;
+        // LOCAL connections and transports other
+        // than TCP carry no usable endpoints.
+        if((ver_cmd & 0x0f) == 0 || (fam & 0x0f) != 1)
+            return 16 + len;
+        switch(fam >> 4)
+        {
+        case 1:
+        {
+            net::ip::address_v4::bytes_type src;
+            net::ip::address_v4::bytes_type dst;
+            std::memcpy(src.data(), p + 16, 4);
+            std::memcpy(dst.data(), p + 20, 4);
+            h.source = endpoint(
+                net::ip::address_v4(src), get_uint16(p + 24));
+            h.destination = endpoint(
+                net::ip::address_v4(dst), get_uint16(p + 26));
+            h.proxied = true;
+            break;
+        }
+
+        case 2:
+        {
+            net::ip::address_v6::bytes_type src;
+            net::ip::address_v6::bytes_type dst;
+            std::memcpy(src.data(), p + 16, 16);
+            std::memcpy(dst.data(), p + 32, 16);
+            h.source = endpoint(
+                net::ip::address_v6(src), get_uint16(p + 48));
+            h.destination = endpoint(
+                net::ip::address_v6(dst), get_uint16(p + 50));
+            h.proxied = true;
+            break;
+        }
+
+        default:
+            break;
+        }
+        return 16 + len;
+    }
+};
+
+std::size_t
+parse_proxy_header(
+    char const* p,
+    std::size_t n,
+    std::size_t size,
+    proxy_header& h,
+    error_code& ec)
+{
+    static char const v1[] = "PROXY ";
+    static char const v2[] =
+        "\x0D\x0A\x0D\x0A\x00\x0D\x0A\x51\x55\x49\x54\x0A";
+
+    ec = {};
+    h = {};
+    if(n == 0)
+        return 0;
+    if(p[0] == v1[0])
+    {
+        auto const m = proxy_header_parser::match(
+            p, n, v1, sizeof(v1) - 1);
+        if(m == sizeof(v1) - 1)
+            return proxy_header_parser::parse_v1(p, n, h, ec);
+        if(m == n)
+            return 0;
+    }
+    else if(p[0] == v2[0])
+    {
+        auto const m = proxy_header_parser::match(
+            p, n, v2, sizeof(v2) - 1);
+        if(m == sizeof(v2) - 1)
+            return proxy_header_parser::parse_v2(
+                p, n, size, h, ec);
+        if(m == n)
+            return 0;
+    }
+    ec = error::bad_proxy_header;
+    return 0;
+}
+
+} // detail
+} // beast
+} // boost
+
+#endif
@@ -0,0 +1,162 @@
+//
+// Copyright (c) 2016-2019 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/boostorg/beast
+//
+
+#ifndef BOOST_BEAST_DETAIL_POOLED_STATIC_BUFFER_HPP
+#define BOOST_BEAST_DETAIL_POOLED_STATIC_BUFFER_HPP
+
+#include <boost/beast/core/static_buffer.hpp>
+#include <boost/beast/core/detail/block_cache.hpp>
+#include <boost/assert.hpp>
+#include <boost/optional.hpp>
+#include <cstddef>
+
+namespace boost {
+namespace beast {
+namespace detail {
+
+// A circular DynamicBuffer with a fixed capacity of N,
+// whose storage is borrowed from the block cache.
+//
+// Storage is acquired on the first call to prepare, and
+// may be handed back with release when the buffer holds
+// no readable bytes. This lets a long-lived object keep a
+// read buffer which occupies no memory while it is idle.
+//
+template<std::size_t N>
+class pooled_static_buffer
+{
+    boost::optional<static_buffer_base> b_;
+    void* p_ = nullptr;
+
+public:
+    using const_buffers_type =
+        static_buffer_base::const_buffers_type;
+
+    using mutable_buffers_type =
+        static_buffer_base::mutable_buffers_type;
+
+    pooled_static_buffer() = default;
+
+    pooled_static_buffer(pooled_static_buffer const&) = delete;
+    pooled_static_buffer& operator=(pooled_static_buffer const&) = delete;
+
+    ~pooled_static_buffer()
+    {
+        if(p_)
+            block_cache::deallocate(p_, N);
+    }
+
+    // Returns `true` if storage is currently held
+    bool
+    is_acquired() const noexcept
+    {
+        return p_ != nullptr;
+    }
+
+    // Acquire storage, if not already held
+    void
+    acquire()
+    {
+        if(p_)
+            return;
+        p_ = block_cache::allocate(N);
+        b_.emplace(p_, N);
+    }
+
+    // Give the storage back if the buffer is empty.
+    // Returns `true` if no storage is held afterwards.
+    bool
+    release() noexcept
+    {
+        if(! p_)
+            return true;
+        if(b_->size() > 0)
+            return false;
+        b_ = boost::none;
+        block_cache::deallocate(p_, N);
+        p_ = nullptr;
+        return true;
+    }
+
+    std::size_t
+    size() const noexcept
+    {
+        return b_ ? b_->size() : 0;
+    }
+
+    std::size_t
+    max_size() const noexcept
+    {
+        return N;
+    }
+
+    std::size_t
+    capacity() const noexcept
+    {
+        return N;
+    }
+
+    const_buffers_type
+    data() const noexcept
+    {
+        if(! b_)
+            return {};
+        return static_cast<
+            static_buffer_base const&>(*b_).data();
+    }
+
+    const_buffers_type
+    cdata() const noexcept
+    {
+        return data();
+    }
+
+    mutable_buffers_type
+    data() noexcept
+    {
+        if(! b_)
+            return {};
+        return b_->data();
+    }
+
+    mutable_buffers_type
+    prepare(std::size_t n)
+    {
+        acquire();
+        return b_->prepare(n);
+    }
+
+    void
+    commit(std::size_t n) noexcept
+    {
+        BOOST_ASSERT(b_ || n == 0);
+        if(b_)
+            b_->commit(n);
+    }
+
+    void
+    consume(std::size_t n) noexcept
+    {
+        if(b_)
+            b_->consume(n);
+    }
+
+    void
+    clear() noexcept
+    {
+        if(b_)
+            b_->clear();
+    }
+};
+
+} // detail
+} // beast
+} // boost
+
+#endif
@@ -0,0 +1,68 @@
+//
+// Copyright (c) 2016-2019 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/boostorg/beast
+//
+
+#ifndef BOOST_BEAST_CORE_DETAIL_POST_EXPIRY_HPP
+#define BOOST_BEAST_CORE_DETAIL_POST_EXPIRY_HPP
+
+#include <boost/beast/core/error.hpp>
+#include <boost/asio/post.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/weak_ptr.hpp>
+#include <type_traits>
+#include <utility>
+
+namespace boost {
+namespace beast {
+namespace detail {
+
+template<class T, class Handler>
+struct expiry_op
+{
+    boost::shared_ptr<T> sp;
+    Handler h;
+
+    void
+    operator()()
+    {
+        h(error_code{});
+    }
+};
+
+/*  Post the handler of an expired timeout_service entry.
+
+    This is called from the callback of the entry, which runs
+    with the lock of the service held. The reference to the
+    owner of the entry is moved into the posted operation, so
+    the owner is never destroyed while the lock is held, which
+    would deadlock when its entries disarm themselves.
+
+    `make_handler` is invoked with the locked owner and returns
+    the handler to invoke with a default error code. Nothing is
+    posted if the owner is already gone.
+*/
+template<class T, class MakeHandler>
+void
+post_expiry(
+    boost::weak_ptr<T> const& wp,
+    MakeHandler const& make_handler)
+{
+    auto sp = wp.lock();
+    if(! sp)
+        return;
+    auto h = make_handler(sp);
+    auto const ex = h.get_executor();
+    net::post(ex, expiry_op<T, decltype(h)>{
+        std::move(sp), std::move(h)});
+}
+
+} // detail
+} // beast
+} // boost
+
+#endif
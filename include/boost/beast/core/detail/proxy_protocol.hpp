@@ -0,0 +1,88 @@
+//
+// Copyright (c) 2016-2019 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/boostorg/beast
+//
+
+#ifndef BOOST_BEAST_DETAIL_PROXY_PROTOCOL_HPP
+#define BOOST_BEAST_DETAIL_PROXY_PROTOCOL_HPP
+
+#include <boost/beast/core/error.hpp>
+#include <boost/beast/core/buffer_traits.hpp>
+#include <boost/asio/buffer.hpp>
+#include <cstddef>
+
+namespace boost {
+namespace beast {
+
+struct proxy_header;
+
+namespace detail {
+
+// The largest prefix of a header which must be contiguous:
+// 107 octets for version 1, or the 16 octet version 2
+// preamble followed by the 216 octets of AF_UNIX addresses.
+// Any TLVs which follow the addresses are skipped, and
+// do not need to be examined.
+static std::size_t constexpr proxy_header_prefix = 232;
+
+// Parse a PROXY protocol header from the contiguous octets
+// `p[0..n)`, where `size` is the total number of octets
+// available to the caller. Either `n == size` or
+// `n >= proxy_header_prefix`.
+//
+// Returns the size of the header, or zero if `ec` is set
+// or more input is needed.
+//
+BOOST_BEAST_DECL
+std::size_t
+parse_proxy_header(
+    char const* p,
+    std::size_t n,
+    std::size_t size,
+    proxy_header& h,
+    error_code& ec);
+
+template<class ConstBufferSequence>
+std::size_t
+parse_proxy_header(
+    ConstBufferSequence const& buffers,
+    proxy_header& h,
+    error_code& ec)
+{
+    auto const size = buffer_bytes(buffers);
+    if(size == 0)
+    {
+        ec = {};
+        return 0;
+    }
+
+    // The header is parsed in place when the
+    // leading buffer holds enough of it, which
+    // is always true for flat buffers. Otherwise
+    // the prefix is gathered onto the stack.
+    net::const_buffer const b =
+        *net::buffer_sequence_begin(buffers);
+    if( b.size() == size ||
+        b.size() >= proxy_header_prefix)
+        return parse_proxy_header(
+            static_cast<char const*>(b.data()),
+            b.size(), size, h, ec);
+    char buf[proxy_header_prefix];
+    auto const n = net::buffer_copy(
+        net::mutable_buffer(buf, sizeof(buf)), buffers);
+    return parse_proxy_header(buf, n, size, h, ec);
+}
+
+} // detail
+} // beast
+} // boost
+
+#ifdef BOOST_BEAST_HEADER_ONLY
+#include <boost/beast/core/detail/impl/proxy_protocol.ipp>
+#endif
+
+#endif
@@ -13,6 +13,7 @@
 #include <boost/asio/steady_timer.hpp>
 #include <boost/assert.hpp>
 #include <boost/core/exchange.hpp>
+#include <boost/optional.hpp>
 #include <chrono>
 #include <cstdint>
 #include <utility>
@@ -41,17 +42,12 @@ struct stream_base
 
     struct op_state
     {
-        net::steady_timer timer;    // for timing out
+        // created the first time a timeout is armed
+        boost::optional<net::steady_timer> timer;
+        time_point expiry = never(); // when to time out
         tick_type tick = 0;         // counts waits
         bool pending = false;       // if op is pending
         bool timeout = false;       // if timed out
-
-        template<class... Args>
-        explicit
-        op_state(Args&&... args)
-            : timer(std::forward<Args>(args)...)
-        {
-        }
     };
 
     class pending_guard
@@ -127,6 +123,16 @@ struct stream_base
         return (time_point::max)();
     }
 
+    // Returns now + d, saturating at never()
+    static time_point after(
+        clock_type::duration d) noexcept
+    {
+        auto const now = clock_type::now();
+        if(d >= never() - now)
+            return never();
+        return now + d;
+    }
+
     static std::size_t constexpr no_limit =
         (std::numeric_limits<std::size_t>::max)();
 };
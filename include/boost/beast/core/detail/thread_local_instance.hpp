@@ -0,0 +1,68 @@
+//
+// Copyright (c) 2016-2019 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/boostorg/beast
+//
+
+#ifndef BOOST_BEAST_CORE_DETAIL_THREAD_LOCAL_INSTANCE_HPP
+#define BOOST_BEAST_CORE_DETAIL_THREAD_LOCAL_INSTANCE_HPP
+
+#include <boost/config.hpp>
+
+namespace boost {
+namespace beast {
+namespace detail {
+
+template<class T>
+struct thread_local_holder : T
+{
+    ~thread_local_holder()
+    {
+        destroyed() = true;
+    }
+
+    // Set once the instance of the calling thread is gone
+    static
+    bool&
+    destroyed() noexcept
+    {
+#ifndef BOOST_NO_CXX11_THREAD_LOCAL
+        thread_local static bool b = false;
+        return b;
+#else
+        static bool b = true;
+        return b;
+#endif
+    }
+};
+
+/*  Return the default constructed instance of T for the calling thread.
+
+    This returns `nullptr` when the platform has no thread_local
+    storage, or when called during thread exit after the instance
+    of the thread was destroyed, for example from the destructor of
+    another thread_local object. Callers are expected to fall back
+    to the global heap then.
+*/
+template<class T>
+T*
+thread_local_instance() noexcept
+{
+#ifndef BOOST_NO_CXX11_THREAD_LOCAL
+    if(thread_local_holder<T>::destroyed())
+        return nullptr;
+    thread_local static thread_local_holder<T> t;
+    return &t;
+#else
+    return nullptr;
+#endif
+}
+
+} // detail
+} // beast
+} // boost
+
+#endif
@@ -0,0 +1,121 @@
+//
+// Copyright (c) 2016-2019 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/boostorg/beast
+//
+
+#ifndef BOOST_BEAST_DETAIL_WAIT_READ_HPP
+#define BOOST_BEAST_DETAIL_WAIT_READ_HPP
+
+#include <boost/beast/core/error.hpp>
+#include <boost/asio/socket_base.hpp>
+#include <boost/assert.hpp>
+#include <boost/type_traits/make_void.hpp>
+#include <type_traits>
+#include <utility>
+
+namespace boost {
+namespace beast {
+
+template<class Protocol, class Executor, class RatePolicy>
+class basic_stream;
+
+namespace detail {
+
+//------------------------------------------------------------------------------
+//
+// is_wait_readable
+// wait_read
+// async_wait_read
+//
+// Waiting for a stream to become readable before reading
+// lets the caller defer committing buffer memory until data
+// has actually arrived. Only streams which read directly
+// from a socket qualify. A layered stream which buffers
+// internally, such as a TLS stream, may already hold data
+// while its socket is idle, and waiting there could block
+// forever.
+//
+
+template<class T, class = void>
+struct is_wait_readable : std::false_type
+{
+};
+
+template<class T>
+struct is_wait_readable<T, boost::void_t<decltype(
+    std::declval<T&>().wait(net::socket_base::wait_read))>>
+    : std::true_type
+{
+};
+
+template<class Protocol, class Executor, class RatePolicy>
+struct is_wait_readable<
+        basic_stream<Protocol, Executor, RatePolicy>>
+    : std::true_type
+{
+};
+
+template<class Stream>
+void
+wait_read(Stream& s, error_code& ec, std::true_type)
+{
+    s.wait(net::socket_base::wait_read, ec);
+}
+
+template<class Stream>
+void
+wait_read(Stream&, error_code&, std::false_type)
+{
+    // Callers must check is_wait_readable first
+    BOOST_ASSERT(false);
+}
+
+template<class Stream>
+void
+wait_read(Stream& s, error_code& ec)
+{
+    wait_read(s, ec, is_wait_readable<Stream>{});
+}
+
+template<class Protocol, class Executor, class RatePolicy>
+void
+wait_read(
+    basic_stream<Protocol, Executor, RatePolicy>& s,
+    error_code& ec)
+{
+    s.socket().wait(net::socket_base::wait_read, ec);
+}
+
+template<class Stream, class Handler>
+void
+async_wait_read(Stream& s, Handler&& handler, std::true_type)
+{
+    s.async_wait(net::socket_base::wait_read,
+        std::forward<Handler>(handler));
+}
+
+template<class Stream, class Handler>
+void
+async_wait_read(Stream&, Handler&&, std::false_type)
+{
+    // Callers must check is_wait_readable first
+    BOOST_ASSERT(false);
+}
+
+template<class Stream, class Handler>
+void
+async_wait_read(Stream& s, Handler&& handler)
+{
+    async_wait_read(s, std::forward<Handler>(handler),
+        is_wait_readable<Stream>{});
+}
+
+} // detail
+} // beast
+} // boost
+
+#endif
@@ -64,7 +64,15 @@ enum class error
 
         Error codes with this value will compare equal to @ref condition::timeout.
     */
-    timeout = 1
+    timeout = 1,
+
+    /** The PROXY protocol header is invalid
+
+        This error is returned by @ref read_proxy_header and
+        @ref async_read_proxy_header when the received data is not
+        a well-formed version 1 or version 2 PROXY protocol header.
+    */
+    bad_proxy_header
 };
 
 /// Error conditions corresponding to sets of library error codes.
@@ -12,7 +12,6 @@
 
 #include <boost/beast/core/detail/config.hpp>
 #include <boost/beast/core/error.hpp>
-#include <boost/beast/core/flat_buffer.hpp>
 #include <boost/beast/core/stream_traits.hpp>
 #include <boost/beast/core/detail/flat_stream.hpp>
 #include <boost/asio/async_result.hpp>
@@ -25,8 +24,11 @@ namespace beast {
 /** Stream wrapper to improve write performance.
 
     This wrapper flattens writes for buffer sequences having length
-    greater than 1 and total size below a predefined amount, using
-    a dynamic memory allocation. It is primarily designed to overcome
+    greater than 1 and total size below an adjustable limit, see
+    @ref coalesce_limit. Small writes are flattened on the stack.
+    Larger ones use memory borrowed from a per-thread cache, which
+    is held only while the write is in progress, so an idle stream
+    owns no write buffer. It is primarily designed to overcome
     a performance limitation of the current version of `net::ssl::stream`,
     which does not use OpenSSL's scatter/gather interface for its
     low-level read some and write some operations.
@@ -91,7 +93,7 @@ class flat_stream
 #endif
 {
     NextLayer stream_;
-    flat_buffer buffer_;
+    std::size_t limit_ = max_size;
 
     BOOST_STATIC_ASSERT(has_get_executor<NextLayer>::value);
 
@@ -175,6 +177,33 @@ public:
         return stream_;
     }
 
+    /** Set the largest number of bytes flattened by a write.
+
+        When the first buffer of a sequence passed to a write is
+        smaller than this limit, it is combined with as many of the
+        following buffers as will fit and written in one call to
+        the next layer. A first buffer at or above the limit is
+        passed through without copying. A value of zero disables
+        flattening, so each write transfers only the first buffer
+        which is not empty.
+
+        The default is 16 kilobytes, the size of one TLS record.
+
+        @param n The new limit, in bytes.
+    */
+    void
+    coalesce_limit(std::size_t n) noexcept
+    {
+        limit_ = n;
+    }
+
+    /// Returns the largest number of bytes flattened by a write.
+    std::size_t
+    coalesce_limit() const noexcept
+    {
+        return limit_;
+    }
+
     //--------------------------------------------------------------------------
 
     /** Read some data from the stream.
@@ -11,10 +11,13 @@
 #define BOOST_BEAST_CORE_IMPL_BASIC_STREAM_HPP
 
 #include <boost/beast/core/async_base.hpp>
+#include <boost/beast/core/bind_handler.hpp>
 #include <boost/beast/core/buffer_traits.hpp>
 #include <boost/beast/core/buffers_prefix.hpp>
+#include <boost/beast/core/detail/post_expiry.hpp>
 #include <boost/beast/websocket/teardown.hpp>
 #include <boost/asio/coroutine.hpp>
+#include <boost/asio/post.hpp>
 #include <boost/assert.hpp>
 #include <boost/make_shared.hpp>
 #include <boost/core/exchange.hpp>
@@ -33,9 +36,6 @@ basic_stream<Protocol, Executor, RatePolicy>::
 impl_type::
 impl_type(std::false_type, Args&&... args)
     : socket(std::forward<Args>(args)...)
-    , read(ex())
-    , write(ex())
-    , timer(ex())
 {
     reset();
 }
@@ -50,9 +50,6 @@ impl_type(std::true_type,
         boost::empty_init_t{},
         std::forward<RatePolicy_>(policy))
     , socket(std::forward<Args>(args)...)
-    , read(ex())
-    , write(ex())
-    , timer(ex())
 {
     reset();
 }
@@ -70,8 +67,13 @@ on_timer(Executor2 const& ex2)
     if(--waiting > 0)
         return;
 
+    // self-timed policies refill on their own,
+    // the timer only runs while someone waits.
+    if(rate_policy_access::is_self_timed<RatePolicy>::value)
+        return;
+
     // update the expiration time
-    BOOST_VERIFY(timer.expires_after(
+    BOOST_VERIFY(rate_timer().expires_after(
         std::chrono::seconds(1)) == 0);
 
     rate_policy_access::on_timer(policy());
@@ -104,7 +106,10 @@ on_timer(Executor2 const& ex2)
             if(! sp)
                 return;
             if(ec == net::error::operation_aborted)
+            {
+                --sp->waiting;
                 return;
+            }
             BOOST_ASSERT(! ec);
             if(ec)
                 return;
@@ -114,7 +119,8 @@ on_timer(Executor2 const& ex2)
 
     // wait on the timer again
     ++waiting;
-    timer.async_wait(handler(ex2, this->shared_from_this()));
+    rate_timer().async_wait(
+        handler(ex2, this->shared_from_this()));
 }
 
 template<class Protocol, class Executor, class RatePolicy>
@@ -131,12 +137,10 @@ reset()
     BOOST_ASSERT(! read.pending || ! write.pending);
 
     if(! read.pending)
-        BOOST_VERIFY(
-            read.timer.expires_at(never()) == 0);
+        read.expiry = never();
 
     if(! write.pending)
-        BOOST_VERIFY(
-            write.timer.expires_at(never()) == 0);
+        write.expiry = never();
 }
 
 template<class Protocol, class Executor, class RatePolicy>
@@ -149,9 +153,11 @@ close() noexcept
         error_code ec;
         socket.close(ec);
     }
+    if(! timer)
+        return;
     try
     {
-        timer.cancel();
+        timer->cancel();
     }
     catch(...)
     {
@@ -203,6 +209,62 @@ struct basic_stream<Protocol, Executor, RatePolicy>::
     }
 };
 
+template<class Protocol, class Executor, class RatePolicy>
+void
+basic_stream<Protocol, Executor, RatePolicy>::
+timeout_entry::
+on_expire(timeout_service::entry& e)
+{
+    // Called by the timeout service with its lock held,
+    // possibly while the implementation is being destroyed.
+    auto& te = static_cast<timeout_entry&>(e);
+    detail::post_expiry(te.impl->weak_from_this(),
+        [&te](boost::shared_ptr<impl_type> const& sp)
+        {
+            return timeout_handler<executor_type>{
+                *te.state, sp, te.tick, sp->ex()};
+        });
+}
+
+template<class Protocol, class Executor, class RatePolicy>
+template<class Executor2>
+void
+basic_stream<Protocol, Executor, RatePolicy>::
+impl_type::
+arm(op_state& st, Executor2 const& ex2)
+{
+    if(! wheel)
+    {
+        if(! st.timer)
+            st.timer.emplace(ex());
+        st.timer->expires_at(st.expiry);
+        st.timer->async_wait(
+            timeout_handler<Executor2>{
+                st,
+                this->weak_from_this(),
+                st.tick,
+                ex2});
+        return;
+    }
+    auto& te = &st == &read ? read_entry : write_entry;
+    te.impl = this;
+    te.state = &st;
+    te.tick = st.tick;
+    wheel->arm(te, st.expiry);
+}
+
+template<class Protocol, class Executor, class RatePolicy>
+std::size_t
+basic_stream<Protocol, Executor, RatePolicy>::
+impl_type::
+disarm(op_state& st)
+{
+    if(! wheel)
+        return st.timer->cancel();
+    return wheel->disarm(
+        &st == &read ? read_entry : write_entry) ? 1 : 0;
+}
+
 //------------------------------------------------------------------------------
 
 template<class Protocol, class Executor, class RatePolicy>
@@ -220,6 +282,11 @@ class transfer_op
 
     using is_read = std::integral_constant<bool, isRead>;
 
+    // With the default policy there is nothing to limit,
+    // the buffers are passed to the socket unchanged.
+    using is_unlimited = std::is_same<
+        RatePolicy, unlimited_rate_policy>;
+
     op_state&
     state()
     {
@@ -251,12 +318,41 @@ class transfer_op
                 transfer_write_bytes(impl_->policy(), n);
     }
 
+    void
+    prepare_wait(std::true_type)
+    {
+        // the first waiter arms the timer for as long
+        // as the policy needs to allow more bytes.
+        if(impl_->waiting > 0)
+            return;
+        BOOST_VERIFY(impl_->rate_timer().expires_after(isRead ?
+            rate_policy_access::read_wait_duration(impl_->policy()) :
+            rate_policy_access::write_wait_duration(impl_->policy())) == 0);
+    }
+
+    void
+    prepare_wait(std::false_type)
+    {
+    }
+
+    Buffers
+    limit(std::size_t, std::true_type)
+    {
+        return b_;
+    }
+
+    buffers_prefix_view<Buffers>
+    limit(std::size_t amount, std::false_type)
+    {
+        return beast::buffers_prefix(amount, b_);
+    }
+
     void
     async_perform(
         std::size_t amount, std::true_type)
     {
         impl_->socket.async_read_some(
-            beast::buffers_prefix(amount, b_),
+            limit(amount, is_unlimited{}),
                 std::move(*this));
     }
 
@@ -265,7 +361,7 @@ class transfer_op
         std::size_t amount, std::false_type)
     {
         impl_->socket.async_write_some(
-            beast::buffers_prefix(amount, b_),
+            limit(amount, is_unlimited{}),
                 std::move(*this));
     }
 
@@ -323,7 +419,8 @@ public:
                 }
                 // apply the timeout manually, otherwise
                 // behavior varies across platforms.
-                if(state().timer.expiry() <= clock_type::now())
+                if(state().expiry != never() &&
+                    state().expiry <= clock_type::now())
                 {
                     impl_->close();
                     ec = beast::error::timeout;
@@ -332,19 +429,14 @@ public:
             }
 
             // if a timeout is active, wait on the timer
-            if(state().timer.expiry() != never())
+            if(state().expiry != never())
             {
                 BOOST_ASIO_HANDLER_LOCATION((
                     __FILE__, __LINE__,
                     (isRead ? "basic_stream::async_read_some"
                         : "basic_stream::async_write_some")));
 
-                state().timer.async_wait(
-                    timeout_handler<decltype(this->get_executor())>{
-                        state(),
-                        impl_,
-                        state().tick,
-                        this->get_executor()});
+                impl_->arm(state(), this->get_executor());
             }
 
             // check rate limit, maybe wait
@@ -352,6 +444,8 @@ public:
             amount = available_bytes();
             if(amount == 0)
             {
+                prepare_wait(rate_policy_access::
+                    is_self_timed<RatePolicy>{});
                 ++impl_->waiting;
                 BOOST_ASIO_CORO_YIELD
                 {
@@ -360,13 +454,22 @@ public:
                         (isRead ? "basic_stream::async_read_some"
                             : "basic_stream::async_write_some")));
 
-                    impl_->timer.async_wait(std::move(*this));
+                    impl_->rate_timer().async_wait(std::move(*this));
                 }
                 if(ec)
                 {
+                    --impl_->waiting;
+
                     // socket was closed, or a timeout
                     BOOST_ASSERT(ec ==
                         net::error::operation_aborted);
+                    if(state().expiry != never())
+                    {
+                        // make a pending expiration stale,
+                        // so it can't time out the next op
+                        ++state().tick;
+                        impl_->disarm(state());
+                    }
                     // timeout handler invoked?
                     if(state().timeout)
                     {
@@ -394,13 +497,13 @@ public:
                 async_perform(amount, is_read{});
             }
 
-            if(state().timer.expiry() != never())
+            if(state().expiry != never())
             {
                 ++state().tick;
 
                 // try cancelling timer
                 auto const n =
-                    state().timer.cancel();
+                    impl_->disarm(state());
                 if(n == 0)
                 {
                     // timeout handler invoked?
@@ -452,18 +555,13 @@ public:
         , pg0_(impl_->read.pending)
         , pg1_(impl_->write.pending)
     {
-        if(state().timer.expiry() != stream_base::never())
+        if(state().expiry != stream_base::never())
         {
             BOOST_ASIO_HANDLER_LOCATION((
                 __FILE__, __LINE__,
                 "basic_stream::async_connect"));
 
-            impl_->write.timer.async_wait(
-                timeout_handler<decltype(this->get_executor())>{
-                    state(),
-                    impl_,
-                    state().tick,
-                    this->get_executor()});
+            impl_->arm(state(), this->get_executor());
         }
 
         BOOST_ASIO_HANDLER_LOCATION((
@@ -489,18 +587,13 @@ public:
         , pg0_(impl_->read.pending)
         , pg1_(impl_->write.pending)
     {
-        if(state().timer.expiry() != stream_base::never())
+        if(state().expiry != stream_base::never())
         {
             BOOST_ASIO_HANDLER_LOCATION((
                 __FILE__, __LINE__,
                 "basic_stream::async_connect"));
 
-            impl_->write.timer.async_wait(
-                timeout_handler<decltype(this->get_executor())>{
-                    state(),
-                    impl_,
-                    state().tick,
-                    this->get_executor()});
+            impl_->arm(state(), this->get_executor());
         }
 
         BOOST_ASIO_HANDLER_LOCATION((
@@ -526,18 +619,13 @@ public:
         , pg0_(impl_->read.pending)
         , pg1_(impl_->write.pending)
     {
-        if(state().timer.expiry() != stream_base::never())
+        if(state().expiry != stream_base::never())
         {
             BOOST_ASIO_HANDLER_LOCATION((
                 __FILE__, __LINE__,
                 "basic_stream::async_connect"));
 
-            impl_->write.timer.async_wait(
-                timeout_handler<decltype(this->get_executor())>{
-                    state(),
-                    impl_,
-                    state().tick,
-                    this->get_executor()});
+            impl_->arm(state(), this->get_executor());
         }
 
         BOOST_ASIO_HANDLER_LOCATION((
@@ -553,13 +641,13 @@ public:
     void
     operator()(error_code ec, Args&&... args)
     {
-        if(state().timer.expiry() != stream_base::never())
+        if(state().expiry != stream_base::never())
         {
             ++state().tick;
 
             // try cancelling timer
             auto const n =
-                impl_->write.timer.cancel();
+                impl_->disarm(state());
             if(n == 0)
             {
                 // timeout handler invoked?
@@ -583,6 +671,84 @@ public:
     }
 };
 
+template<class Handler>
+class wait_op
+    : public async_base<Handler, Executor>
+{
+    boost::shared_ptr<impl_type> impl_;
+    pending_guard pg_;
+    bool is_write_;
+
+    op_state&
+    state() noexcept
+    {
+        if(is_write_)
+            return impl_->write;
+        return impl_->read;
+    }
+
+public:
+    template<class Handler_>
+    wait_op(
+        Handler_&& h,
+        basic_stream& s,
+        net::socket_base::wait_type w)
+        : async_base<Handler, Executor>(
+            std::forward<Handler_>(h), s.get_executor())
+        , impl_(s.impl_)
+        , pg_()
+        , is_write_(w == net::socket_base::wait_write)
+    {
+        pg_.assign(state().pending);
+        if(state().expiry != stream_base::never())
+        {
+            BOOST_ASIO_HANDLER_LOCATION((
+                __FILE__, __LINE__,
+                "basic_stream::async_wait"));
+
+            impl_->arm(state(), this->get_executor());
+        }
+
+        BOOST_ASIO_HANDLER_LOCATION((
+            __FILE__, __LINE__,
+            "basic_stream::async_wait"));
+
+        impl_->socket.async_wait(w, std::move(*this));
+        // *this is now moved-from
+    }
+
+    void
+    operator()(error_code ec)
+    {
+        if(state().expiry != stream_base::never())
+        {
+            ++state().tick;
+
+            // try cancelling timer
+            auto const n =
+                impl_->disarm(state());
+            if(n == 0)
+            {
+                // timeout handler invoked?
+                if(state().timeout)
+                {
+                    // yes, socket already closed
+                    ec = beast::error::timeout;
+                    state().timeout = false;
+                }
+            }
+            else
+            {
+                BOOST_ASSERT(n == 1);
+                BOOST_ASSERT(! state().timeout);
+            }
+        }
+
+        pg_.reset();
+        this->complete_now(ec);
+    }
+};
+
 struct run_read_op
 {
     template<class ReadHandler, class Buffers>
@@ -635,6 +801,29 @@ struct run_write_op
     }
 };
 
+struct run_wait_op
+{
+    template<class WaitHandler>
+    void
+    operator()(
+        WaitHandler&& h,
+        basic_stream* s,
+        net::socket_base::wait_type w)
+    {
+        // If you get an error on the following line it means
+        // that your handler does not meet the documented type
+        // requirements for the handler.
+
+        static_assert(
+            detail::is_invocable<WaitHandler,
+                void(error_code)>::value,
+            "WaitHandler type requirements not met");
+
+        wait_op<typename std::decay<WaitHandler>::type>(
+            std::forward<WaitHandler>(h), *s, w);
+    }
+};
+
 struct run_connect_op
 {
     template<class ConnectHandler>
@@ -790,15 +979,15 @@ expires_after(net::steady_timer::duration expiry_time)
         ! impl_->read.pending ||
         ! impl_->write.pending);
 
+    // The timers themselves are only
+    // touched when an operation starts.
+    auto const expiry = after(expiry_time);
+
     if(! impl_->read.pending)
-        BOOST_VERIFY(
-            impl_->read.timer.expires_after(
-                expiry_time) == 0);
+        impl_->read.expiry = expiry;
 
     if(! impl_->write.pending)
-        BOOST_VERIFY(
-            impl_->write.timer.expires_after(
-                expiry_time) == 0);
+        impl_->write.expiry = expiry;
 }
 
 template<class Protocol, class Executor, class RatePolicy>
@@ -817,14 +1006,10 @@ expires_at(
         ! impl_->write.pending);
 
     if(! impl_->read.pending)
-        BOOST_VERIFY(
-            impl_->read.timer.expires_at(
-                expiry_time) == 0);
+        impl_->read.expiry = expiry_time;
 
     if(! impl_->write.pending)
-        BOOST_VERIFY(
-            impl_->write.timer.expires_at(
-                expiry_time) == 0);
+        impl_->write.expiry = expiry_time;
 }
 
 template<class Protocol, class Executor, class RatePolicy>
@@ -835,6 +1020,22 @@ expires_never()
     impl_->reset();
 }
 
+template<class Protocol, class Executor, class RatePolicy>
+void
+basic_stream<Protocol, Executor, RatePolicy>::
+use_timeout_service(timeout_service& svc)
+{
+    // If assert goes off, it means that there are
+    // already read or write (or connect) operations
+    // outstanding.
+    //
+    BOOST_ASSERT(
+        ! impl_->read.pending &&
+        ! impl_->write.pending);
+
+    impl_->wheel = &svc;
+}
+
 template<class Protocol, class Executor, class RatePolicy>
 void
 basic_stream<Protocol, Executor, RatePolicy>::
@@ -842,7 +1043,8 @@ cancel()
 {
     error_code ec;
     impl_->socket.cancel(ec);
-    impl_->timer.cancel();
+    if(impl_->timer)
+        impl_->timer->cancel();
 }
 
 template<class Protocol, class Executor, class RatePolicy>
@@ -1000,6 +1202,23 @@ async_write_some(
             buffers);
 }
 
+template<class Protocol, class Executor, class RatePolicy>
+template<BOOST_BEAST_ASYNC_TPARAM1 WaitHandler>
+BOOST_BEAST_ASYNC_RESULT1(WaitHandler)
+basic_stream<Protocol, Executor, RatePolicy>::
+async_wait(
+    net::socket_base::wait_type w,
+    WaitHandler&& handler)
+{
+    return net::async_initiate<
+        WaitHandler,
+        void(error_code)>(
+            typename ops::run_wait_op{},
+            handler,
+            this,
+            w);
+}
+
 //------------------------------------------------------------------------------
 //
 // Customization points
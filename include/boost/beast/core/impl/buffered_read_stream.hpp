@@ -15,6 +15,7 @@
 #include <boost/beast/core/error.hpp>
 #include <boost/beast/core/read_size.hpp>
 #include <boost/beast/core/stream_traits.hpp>
+#include <boost/beast/core/detail/buffer.hpp>
 #include <boost/beast/core/detail/is_invocable.hpp>
 #include <boost/asio/post.hpp>
 #include <boost/throw_exception.hpp>
@@ -103,6 +104,82 @@ public:
     }
 };
 
+template<class Handler>
+class fill_op
+    : public async_base<Handler,
+    beast::executor_type<buffered_read_stream>>
+{
+    buffered_read_stream& s_;
+    bool read_ = false;
+
+public:
+    fill_op(fill_op&&) = default;
+    fill_op(fill_op const&) = delete;
+
+    template<class Handler_>
+    fill_op(
+        Handler_&& h,
+        buffered_read_stream& s)
+        : async_base<
+            Handler, beast::executor_type<buffered_read_stream>>(
+                std::forward<Handler_>(h), s.get_executor())
+        , s_(s)
+    {
+        error_code ec;
+        boost::optional<typename
+            DynamicBuffer::mutable_buffers_type> mb;
+        auto const n = s_.fill_size();
+        if(n == 0)
+            ec = net::error::no_buffer_space;
+        else
+            mb = beast::detail::dynamic_buffer_prepare(
+                s_.buffer_, n, ec, net::error::no_buffer_space);
+        if(ec)
+        {
+            net::post(
+                s_.get_executor(),
+                beast::bind_front_handler(
+                    std::move(*this), ec, 0));
+            return;
+        }
+        read_ = true;
+        s_.next_layer_.async_read_some(
+            *mb, std::move(*this));
+    }
+
+    void
+    operator()(
+        error_code ec,
+        std::size_t bytes_transferred)
+    {
+        if(read_)
+            s_.buffer_.commit(bytes_transferred);
+        this->complete_now(ec, bytes_transferred);
+    }
+};
+
+struct run_fill_op
+{
+    template<class ReadHandler>
+    void
+    operator()(
+        ReadHandler&& h,
+        buffered_read_stream* s)
+    {
+        // If you get an error on the following line it means
+        // that your handler does not meet the documented type
+        // requirements for the handler.
+
+        static_assert(
+            beast::detail::is_invocable<ReadHandler,
+            void(error_code, std::size_t)>::value,
+            "ReadHandler type requirements not met");
+
+        fill_op<typename std::decay<ReadHandler>::type>(
+            std::forward<ReadHandler>(h), *s);
+    }
+};
+
 struct run_read_op
 {
     template<class ReadHandler, class Buffers>
@@ -236,6 +313,57 @@ async_read_some(
             &buffers);
 }
 
+template<class Stream, class DynamicBuffer>
+std::size_t
+buffered_read_stream<Stream, DynamicBuffer>::
+fill()
+{
+    error_code ec;
+    auto n = fill(ec);
+    if(ec)
+        BOOST_THROW_EXCEPTION(system_error{ec});
+    return n;
+}
+
+template<class Stream, class DynamicBuffer>
+std::size_t
+buffered_read_stream<Stream, DynamicBuffer>::
+fill(error_code& ec)
+{
+    static_assert(is_sync_read_stream<next_layer_type>::value,
+        "SyncReadStream type requirements not met");
+    auto const n = fill_size();
+    if(n == 0)
+    {
+        ec = net::error::no_buffer_space;
+        return 0;
+    }
+    auto const mb = beast::detail::dynamic_buffer_prepare(
+        buffer_, n, ec, net::error::no_buffer_space);
+    if(ec)
+        return 0;
+    auto const bytes_transferred =
+        next_layer_.read_some(*mb, ec);
+    buffer_.commit(bytes_transferred);
+    return bytes_transferred;
+}
+
+template<class Stream, class DynamicBuffer>
+template<BOOST_BEAST_ASYNC_TPARAM2 ReadHandler>
+BOOST_BEAST_ASYNC_RESULT2(ReadHandler)
+buffered_read_stream<Stream, DynamicBuffer>::
+async_fill(ReadHandler&& handler)
+{
+    static_assert(is_async_read_stream<next_layer_type>::value,
+        "AsyncReadStream type requirements not met");
+    return net::async_initiate<
+        ReadHandler,
+        void(error_code, std::size_t)>(
+            typename ops::run_fill_op{},
+            handler,
+            this);
+}
+
 } // beast
 } // boost
 
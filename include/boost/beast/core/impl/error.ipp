@@ -35,6 +35,8 @@ public:
         default:
         case error::timeout: return
             "The socket was closed due to a timeout";
+        case error::bad_proxy_header: return
+            "The PROXY protocol header is invalid";
         }
     }
 
@@ -45,7 +47,7 @@ public:
         switch(static_cast<error>(ev))
         {
         default:
-    //        return {ev, *this};
+            return {ev, *this};
         case error::timeout:
             return condition::timeout;
         }
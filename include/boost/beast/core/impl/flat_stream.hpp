@@ -30,7 +30,11 @@ class write_op
     : public async_base<Handler,
         beast::executor_type<flat_stream>>
 {
+    staging buf_;
+
 public:
+    write_op(write_op&&) = default;
+
     template<
         class ConstBufferSequence,
         class Handler_>
@@ -44,26 +48,22 @@ public:
                 s.get_executor())
     {
         auto const result =
-            flatten(b, max_size);
+            flatten(b, s.limit_);
         if(result.flatten)
         {
-            s.buffer_.clear();
-            s.buffer_.commit(net::buffer_copy(
-                s.buffer_.prepare(result.size),
-                b, result.size));
+            net::mutable_buffer const mb(
+                buf_.allocate(result.size), result.size);
+            net::buffer_copy(mb, b, result.size);
 
             BOOST_ASIO_HANDLER_LOCATION((
                 __FILE__, __LINE__,
                 "flat_stream::async_write_some"));
 
             s.stream_.async_write_some(
-                s.buffer_.data(), std::move(*this));
+                net::const_buffer(mb), std::move(*this));
         }
         else
         {
-            s.buffer_.clear();
-            s.buffer_.shrink_to_fit();
-
             BOOST_ASIO_HANDLER_LOCATION((
                 __FILE__, __LINE__,
                 "flat_stream::async_write_some"));
@@ -79,6 +79,7 @@ public:
         boost::system::error_code ec,
         std::size_t bytes_transferred)
     {
+        buf_.reset();
         this->complete_now(ec, bytes_transferred);
     }
 };
@@ -214,20 +215,19 @@ write_some(ConstBufferSequence const& buffers, error_code& ec)
     static_assert(net::is_const_buffer_sequence<
         ConstBufferSequence>::value,
         "ConstBufferSequence type requirements not met");
-    auto const result = flatten(buffers, max_size);
+    auto const result = flatten(buffers, limit_);
     if(result.flatten)
     {
         if(result.size <= max_stack)
             return stack_write_some(result.size, buffers, ec);
 
-        buffer_.clear();
-        buffer_.commit(net::buffer_copy(
-            buffer_.prepare(result.size),
-            buffers));
-        return stream_.write_some(buffer_.data(), ec);
+        staging buf;
+        net::mutable_buffer const mb(
+            buf.allocate(result.size), result.size);
+        net::buffer_copy(mb, buffers, result.size);
+        return stream_.write_some(
+            net::const_buffer(mb), ec);
     }
-    buffer_.clear();
-    buffer_.shrink_to_fit();
     return stream_.write_some(
         boost::beast::buffers_prefix(result.size, buffers), ec);
 }
@@ -0,0 +1,222 @@
+//
+// Copyright (c) 2016-2019 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/boostorg/beast
+//
+
+#ifndef BOOST_BEAST_CORE_IMPL_PROXY_PROTOCOL_HPP
+#define BOOST_BEAST_CORE_IMPL_PROXY_PROTOCOL_HPP
+
+#include <boost/beast/core/async_base.hpp>
+#include <boost/beast/core/bind_handler.hpp>
+#include <boost/beast/core/read_size.hpp>
+#include <boost/beast/core/stream_traits.hpp>
+#include <boost/beast/core/detail/is_invocable.hpp>
+#include <boost/beast/core/detail/proxy_protocol.hpp>
+#include <boost/asio/coroutine.hpp>
+#include <boost/asio/error.hpp>
+#include <boost/asio/post.hpp>
+
+namespace boost {
+namespace beast {
+
+namespace detail {
+
+template<
+    class Handler,
+    class AsyncReadStream,
+    class DynamicBuffer>
+class read_proxy_header_op
+    : public asio::coroutine
+    , public async_base<
+        Handler, beast::executor_type<AsyncReadStream>>
+{
+    AsyncReadStream& s_;
+    DynamicBuffer& b_;
+    proxy_header& h_;
+    std::size_t n_ = 0;
+
+public:
+    read_proxy_header_op(read_proxy_header_op&&) = default;
+
+    template<class Handler_>
+    read_proxy_header_op(
+        Handler_&& h,
+        AsyncReadStream& s,
+        DynamicBuffer& b,
+        proxy_header& header)
+        : async_base<
+            Handler, beast::executor_type<AsyncReadStream>>(
+                std::forward<Handler_>(h), s.get_executor())
+        , s_(s)
+        , b_(b)
+        , h_(header)
+    {
+        (*this)({}, 0, false);
+    }
+
+    void
+    operator()(
+        error_code ec,
+        std::size_t bytes_transferred,
+        bool cont = true)
+    {
+        BOOST_ASIO_CORO_REENTER(*this)
+        {
+            for(;;)
+            {
+                // There could already be a header in the buffer
+                n_ = detail::parse_proxy_header(b_.data(), h_, ec);
+                if(ec)
+                    break;
+                if(n_ > 0)
+                {
+                    b_.consume(n_);
+                    break;
+                }
+                if(read_size(b_, 1536) == 0)
+                {
+                    ec = net::error::no_buffer_space;
+                    break;
+                }
+                BOOST_ASIO_CORO_YIELD
+                {
+                    BOOST_ASIO_HANDLER_LOCATION((
+                        __FILE__, __LINE__,
+                        "async_read_proxy_header"));
+
+                    s_.async_read_some(b_.prepare(
+                        read_size(b_, 1536)), std::move(*this));
+                }
+                b_.commit(bytes_transferred);
+                if(ec)
+                    break;
+            }
+            if(! cont)
+            {
+                BOOST_ASIO_CORO_YIELD
+                {
+                    BOOST_ASIO_HANDLER_LOCATION((
+                        __FILE__, __LINE__,
+                        "async_read_proxy_header"));
+
+                    net::post(
+                        s_.get_executor(),
+                        beast::bind_front_handler(
+                            std::move(*this), ec, 0));
+                }
+            }
+            this->complete_now(ec, n_);
+        }
+    }
+};
+
+struct run_read_proxy_header_op
+{
+    template<
+        class ReadHandler,
+        class AsyncReadStream,
+        class DynamicBuffer>
+    void
+    operator()(
+        ReadHandler&& h,
+        AsyncReadStream* s,
+        DynamicBuffer* b,
+        proxy_header* header)
+    {
+        // If you get an error on the following line it means
+        // that your handler does not meet the documented type
+        // requirements for the handler.
+
+        static_assert(
+            beast::detail::is_invocable<ReadHandler,
+            void(error_code, std::size_t)>::value,
+            "ReadHandler type requirements not met");
+
+        read_proxy_header_op<
+            typename std::decay<ReadHandler>::type,
+            AsyncReadStream,
+            DynamicBuffer>(
+                std::forward<ReadHandler>(h), *s, *b, *header);
+    }
+};
+
+} // detail
+
+//------------------------------------------------------------------------------
+
+template<
+    class SyncReadStream,
+    class DynamicBuffer>
+std::size_t
+read_proxy_header(
+    SyncReadStream& stream,
+    DynamicBuffer& buffer,
+    proxy_header& header,
+    error_code& ec)
+{
+    static_assert(
+        is_sync_read_stream<SyncReadStream>::value,
+        "SyncReadStream type requirements not met");
+    static_assert(
+        net::is_dynamic_buffer<DynamicBuffer>::value,
+        "DynamicBuffer type requirements not met");
+
+    for(;;)
+    {
+        auto const n = detail::parse_proxy_header(
+            buffer.data(), header, ec);
+        if(ec)
+            return 0;
+        if(n > 0)
+        {
+            buffer.consume(n);
+            return n;
+        }
+        auto const size = read_size(buffer, 1536);
+        if(size == 0)
+        {
+            ec = net::error::no_buffer_space;
+            return 0;
+        }
+        buffer.commit(stream.read_some(
+            buffer.prepare(size), ec));
+        if(ec)
+            return 0;
+    }
+}
+
+template<
+    class AsyncReadStream,
+    class DynamicBuffer,
+    BOOST_BEAST_ASYNC_TPARAM2 ReadHandler>
+BOOST_BEAST_ASYNC_RESULT2(ReadHandler)
+async_read_proxy_header(
+    AsyncReadStream& stream,
+    DynamicBuffer& buffer,
+    proxy_header& header,
+    ReadHandler&& handler)
+{
+    static_assert(
+        is_async_read_stream<AsyncReadStream>::value,
+        "AsyncReadStream type requirements not met");
+    static_assert(
+        net::is_dynamic_buffer<DynamicBuffer>::value,
+        "DynamicBuffer type requirements not met");
+    return net::async_initiate<
+        ReadHandler,
+        void(error_code, std::size_t)>(
+            detail::run_read_proxy_header_op{},
+            handler,
+            &stream,
+            &buffer,
+            &header);
+}
+
+} // beast
+} // boost
+
+#endif
@@ -0,0 +1,241 @@
+//
+// Copyright (c) 2016-2019 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/boostorg/beast
+//
+
+#ifndef BOOST_BEAST_CORE_IMPL_RATE_POLICY_IPP
+#define BOOST_BEAST_CORE_IMPL_RATE_POLICY_IPP
+
+#include <boost/beast/core/rate_policy.hpp>
+#include <boost/assert.hpp>
+#include <algorithm>
+
+namespace boost {
+namespace beast {
+
+shared_rate_policy::
+bucket::
+bucket(
+    std::size_t bytes_per_second,
+    std::size_t burst,
+    std::shared_ptr<bucket> parent)
+    : parent_(std::move(parent))
+    , rate_(static_cast<double>(bytes_per_second))
+    , burst_(static_cast<double>(
+        burst ? burst : bytes_per_second))
+    , tokens_(burst_)
+    , last_(clock_type::now())
+{
+    BOOST_ASSERT(bytes_per_second > 0);
+}
+
+void
+shared_rate_policy::
+bucket::
+rate(
+    std::size_t bytes_per_second,
+    std::size_t burst)
+{
+    BOOST_ASSERT(bytes_per_second > 0);
+    std::lock_guard<std::mutex> lock(m_);
+    refill(clock_type::now());
+    rate_ = static_cast<double>(bytes_per_second);
+    burst_ = static_cast<double>(
+        burst ? burst : bytes_per_second);
+    tokens_ = (std::min)(tokens_, burst_);
+}
+
+std::size_t
+shared_rate_policy::
+bucket::
+rate() const
+{
+    std::lock_guard<std::mutex> lock(m_);
+    return static_cast<std::size_t>(rate_);
+}
+
+std::size_t
+shared_rate_policy::
+bucket::
+users() const
+{
+    std::lock_guard<std::mutex> lock(m_);
+    return users_;
+}
+
+void
+shared_rate_policy::
+bucket::
+refill(clock_type::time_point now)
+{
+    if(now <= last_)
+        return;
+    std::chrono::duration<double> const elapsed = now - last_;
+    tokens_ = (std::min)(burst_,
+        tokens_ + elapsed.count() * rate_);
+    last_ = now;
+}
+
+double
+shared_rate_policy::
+bucket::
+share() const noexcept
+{
+    return (std::max)(1.0, burst_ /
+        static_cast<double>((std::max)(
+            users_, std::size_t{1})));
+}
+
+//------------------------------------------------------------------------------
+
+shared_rate_policy::
+shared_rate_policy(
+    std::shared_ptr<bucket> read,
+    std::shared_ptr<bucket> write)
+    : rd_(std::move(read))
+    , wr_(std::move(write))
+{
+    attach(rd_.get(), 1);
+    attach(wr_.get(), 1);
+}
+
+shared_rate_policy::
+shared_rate_policy(shared_rate_policy const& other)
+    : rd_(other.rd_)
+    , wr_(other.wr_)
+{
+    attach(rd_.get(), 1);
+    attach(wr_.get(), 1);
+}
+
+shared_rate_policy::
+shared_rate_policy(shared_rate_policy&& other) noexcept
+    : rd_(std::move(other.rd_))
+    , wr_(std::move(other.wr_))
+{
+}
+
+shared_rate_policy&
+shared_rate_policy::
+operator=(shared_rate_policy const& other)
+{
+    if(this != &other)
+    {
+        attach(other.rd_.get(), 1);
+        attach(other.wr_.get(), 1);
+        attach(rd_.get(), -1);
+        attach(wr_.get(), -1);
+        rd_ = other.rd_;
+        wr_ = other.wr_;
+    }
+    return *this;
+}
+
+shared_rate_policy&
+shared_rate_policy::
+operator=(shared_rate_policy&& other) noexcept
+{
+    if(this != &other)
+    {
+        attach(rd_.get(), -1);
+        attach(wr_.get(), -1);
+        rd_ = std::move(other.rd_);
+        wr_ = std::move(other.wr_);
+    }
+    return *this;
+}
+
+shared_rate_policy::
+~shared_rate_policy()
+{
+    attach(rd_.get(), -1);
+    attach(wr_.get(), -1);
+}
+
+void
+shared_rate_policy::
+attach(bucket* b, int n) noexcept
+{
+    for(; b; b = b->parent_.get())
+    {
+        std::lock_guard<std::mutex> lock(b->m_);
+        if(n > 0)
+            ++b->users_;
+        else
+            --b->users_;
+    }
+}
+
+std::size_t
+shared_rate_policy::
+available(bucket* b)
+{
+    if(! b)
+        return all;
+    auto const now = clock_type::now();
+    double amount = static_cast<double>(all);
+    for(; b; b = b->parent_.get())
+    {
+        std::lock_guard<std::mutex> lock(b->m_);
+        b->refill(now);
+        amount = (std::min)(amount,
+            (std::min)(b->tokens_, b->share()));
+    }
+    if(amount < 1)
+        return 0;
+    return static_cast<std::size_t>(amount);
+}
+
+void
+shared_rate_policy::
+transfer(bucket* b, std::size_t n)
+{
+    if(n == 0)
+        return;
+    auto const now = clock_type::now();
+    for(; b; b = b->parent_.get())
+    {
+        std::lock_guard<std::mutex> lock(b->m_);
+        b->refill(now);
+        // Streams drawing concurrently can overdraw
+        // the budget, the debt is repaid by waiting.
+        b->tokens_ = (std::max)(-b->burst_,
+            b->tokens_ - static_cast<double>(n));
+    }
+}
+
+auto
+shared_rate_policy::
+wait_duration(bucket* b) ->
+    clock_type::duration
+{
+    auto const now = clock_type::now();
+    double seconds = 0;
+    for(; b; b = b->parent_.get())
+    {
+        std::lock_guard<std::mutex> lock(b->m_);
+        b->refill(now);
+        // Wait for a useful amount rather than a
+        // single byte: the fair share, or 10ms
+        // worth of refill, whichever is smaller.
+        auto const want = (std::min)(
+            b->share(), (std::max)(1.0, b->rate_ / 100));
+        if(b->tokens_ < want)
+            seconds = (std::max)(seconds,
+                (want - b->tokens_) / b->rate_);
+    }
+    auto const d = std::chrono::duration_cast<
+        clock_type::duration>(
+            std::chrono::duration<double>(seconds));
+    return (std::max)(d, clock_type::duration(
+        std::chrono::milliseconds(1)));
+}
+
+} // beast
+} // boost
+
+#endif
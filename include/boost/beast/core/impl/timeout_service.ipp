@@ -0,0 +1,217 @@
+//
+// Copyright (c) 2016-2019 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/boostorg/beast
+//
+
+#ifndef BOOST_BEAST_CORE_IMPL_TIMEOUT_SERVICE_IPP
+#define BOOST_BEAST_CORE_IMPL_TIMEOUT_SERVICE_IPP
+
+#include <boost/beast/core/timeout_service.hpp>
+#include <boost/asio/error.hpp>
+#include <boost/assert.hpp>
+
+namespace boost {
+namespace beast {
+
+timeout_service::
+timeout_service(net::io_context& ioc)
+    : detail::service_base<timeout_service>(ioc)
+    , timer_(ioc.get_executor())
+    , start_(clock_type::now())
+    , res_(std::chrono::milliseconds(100))
+{
+}
+
+void
+timeout_service::
+resolution(duration d)
+{
+    BOOST_ASSERT(d > duration::zero());
+    std::lock_guard<std::mutex> lock(m_);
+    BOOST_ASSERT(size_ == 0);
+    res_ = d;
+    start_ = clock_type::now();
+    now_ = 0;
+}
+
+std::size_t
+timeout_service::
+size() const
+{
+    std::lock_guard<std::mutex> lock(m_);
+    return size_;
+}
+
+void
+timeout_service::
+arm(entry& e, time_point expiry)
+{
+    std::lock_guard<std::mutex> lock(m_);
+    BOOST_ASSERT(! e.armed_);
+    if(e.armed_)
+        unlink(e);
+    if(shutdown_)
+        return;
+    e.svc_ = this;
+    if(! running_)
+        now_ = tick_floor(clock_type::now());
+    auto const t = tick_ceil(expiry);
+    e.tick_ = t > now_ ? t : now_ + 1;
+    link(e);
+    if(! running_)
+    {
+        running_ = true;
+        schedule();
+    }
+}
+
+bool
+timeout_service::
+disarm(entry& e) noexcept
+{
+    std::lock_guard<std::mutex> lock(m_);
+    if(! e.armed_)
+        return false;
+    unlink(e);
+    e.svc_ = nullptr;
+    return true;
+}
+
+void
+timeout_service::
+shutdown()
+{
+    std::lock_guard<std::mutex> lock(m_);
+    shutdown_ = true;
+    for(auto& head : wheel_)
+    {
+        while(head)
+        {
+            auto& e = *head;
+            unlink(e);
+            e.svc_ = nullptr;
+        }
+    }
+    try
+    {
+        timer_.cancel();
+    }
+    catch(...)
+    {
+    }
+}
+
+std::uint64_t
+timeout_service::
+tick_floor(time_point t) const noexcept
+{
+    if(t <= start_)
+        return 0;
+    return static_cast<std::uint64_t>((t - start_) / res_);
+}
+
+std::uint64_t
+timeout_service::
+tick_ceil(time_point t) const noexcept
+{
+    if(t <= start_)
+        return 0;
+    auto const d = t - start_;
+    return static_cast<std::uint64_t>(d / res_) +
+        (d % res_ != duration::zero() ? 1 : 0);
+}
+
+void
+timeout_service::
+link(entry& e) noexcept
+{
+    auto& head = wheel_[e.tick_ & (slots - 1)];
+    e.prev_ = nullptr;
+    e.next_ = head;
+    if(head)
+        head->prev_ = &e;
+    head = &e;
+    e.armed_ = true;
+    ++size_;
+}
+
+void
+timeout_service::
+unlink(entry& e) noexcept
+{
+    if(e.prev_)
+        e.prev_->next_ = e.next_;
+    else
+        wheel_[e.tick_ & (slots - 1)] = e.next_;
+    if(e.next_)
+        e.next_->prev_ = e.prev_;
+    e.prev_ = nullptr;
+    e.next_ = nullptr;
+    e.armed_ = false;
+    --size_;
+}
+
+void
+timeout_service::
+schedule()
+{
+    timer_.expires_at(start_ + res_ *
+        static_cast<duration::rep>(now_ + 1));
+    timer_.async_wait(
+        [this](error_code ec)
+        {
+            on_timer(ec);
+        });
+}
+
+void
+timeout_service::
+on_timer(error_code ec)
+{
+    std::lock_guard<std::mutex> lock(m_);
+    if(ec == net::error::operation_aborted || shutdown_)
+    {
+        running_ = false;
+        return;
+    }
+    auto const last = tick_floor(clock_type::now());
+    if(last > now_)
+    {
+        // Visit each slot at most once, even
+        // if many ticks have gone by.
+        auto first = now_ + 1;
+        if(last - now_ > slots)
+            first = last - slots + 1;
+        for(auto t = first; t <= last; ++t)
+        {
+            auto e = wheel_[t & (slots - 1)];
+            while(e)
+            {
+                auto const next = e->next_;
+                if(e->tick_ <= last)
+                {
+                    // Until the callback returns, the destructor
+                    // of the entry must wait on the lock
+                    unlink(*e);
+                    e->fn_(*e);
+                    e->svc_ = nullptr;
+                }
+                e = next;
+            }
+        }
+        now_ = last;
+    }
+    if(size_ > 0)
+        schedule();
+    else
+        running_ = false;
+}
+
+} // beast
+} // boost
+
+#endif
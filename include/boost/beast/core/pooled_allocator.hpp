@@ -0,0 +1,121 @@
+//
+// Copyright (c) 2016-2019 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/boostorg/beast
+//
+
+#ifndef BOOST_BEAST_POOLED_ALLOCATOR_HPP
+#define BOOST_BEAST_POOLED_ALLOCATOR_HPP
+
+#include <boost/beast/core/detail/config.hpp>
+#include <boost/beast/core/flat_buffer.hpp>
+#include <boost/beast/core/detail/block_cache.hpp>
+#include <boost/throw_exception.hpp>
+#include <cstddef>
+#include <limits>
+#include <new>
+#include <type_traits>
+
+namespace boost {
+namespace beast {
+
+/** An allocator which recycles memory through per-thread free lists.
+
+    Allocations are rounded up to a power of two between 512 bytes
+    and 1 megabyte, and blocks which are deallocated are kept on a
+    free list belonging to the calling thread, to be returned by the
+    next allocation of the same size class on that thread. Each free
+    list holds a bounded amount of memory; blocks beyond the bound,
+    and allocations larger than the largest size class, are returned
+    to the global heap.
+
+    This is intended for containers such as @ref basic_flat_buffer
+    which are created and destroyed at a high rate with similar
+    capacities, for example one per connection. With this allocator
+    a new connection reuses the storage released by a closed one on
+    the same thread instead of going through the global allocator.
+
+    Memory may be deallocated on a different thread than the one
+    which allocated it. All instances compare equal.
+
+    @tparam T The type of object to allocate.
+*/
+template<class T>
+class pooled_allocator
+{
+public:
+    /// The type of object allocated
+    using value_type = T;
+
+    /// All instances are interchangeable
+    using is_always_equal = std::true_type;
+
+    /// Constructor
+    pooled_allocator() = default;
+
+    /// Copy constructor
+    pooled_allocator(pooled_allocator const&) = default;
+
+    /// Converting constructor
+    template<class U>
+    pooled_allocator(pooled_allocator<U> const&) noexcept
+    {
+    }
+
+    /// Allocate storage for `n` objects
+    T*
+    allocate(std::size_t n)
+    {
+        // checked here, since T may be incomplete
+        // where the allocator type is named
+        static_assert(alignof(T) <= alignof(std::max_align_t),
+            "Over-aligned types are not supported");
+        if(n > (std::numeric_limits<
+                std::size_t>::max)() / sizeof(T))
+            BOOST_THROW_EXCEPTION(std::bad_alloc{});
+        return static_cast<T*>(
+            detail::block_cache::allocate(n * sizeof(T)));
+    }
+
+    /// Deallocate storage for `n` objects
+    void
+    deallocate(T* p, std::size_t n) noexcept
+    {
+        detail::block_cache::deallocate(p, n * sizeof(T));
+    }
+
+    template<class U>
+    friend
+    bool
+    operator==(
+        pooled_allocator const&,
+        pooled_allocator<U> const&) noexcept
+    {
+        return true;
+    }
+
+    template<class U>
+    friend
+    bool
+    operator!=(
+        pooled_allocator const&,
+        pooled_allocator<U> const&) noexcept
+    {
+        return false;
+    }
+};
+
+/** A flat buffer whose storage is recycled through per-thread free lists.
+
+    @see pooled_allocator
+*/
+using pooled_flat_buffer =
+    basic_flat_buffer<pooled_allocator<char>>;
+
+} // beast
+} // boost
+
+#endif
@@ -0,0 +1,192 @@
+//
+// Copyright (c) 2016-2019 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/boostorg/beast
+//
+
+#ifndef BOOST_BEAST_CORE_PROXY_PROTOCOL_HPP
+#define BOOST_BEAST_CORE_PROXY_PROTOCOL_HPP
+
+#include <boost/beast/core/detail/config.hpp>
+#include <boost/beast/core/error.hpp>
+#include <boost/beast/core/stream_traits.hpp>
+#include <boost/asio/async_result.hpp>
+#include <boost/asio/ip/tcp.hpp>
+#include <cstddef>
+
+namespace boost {
+namespace beast {
+
+/** The information carried by a PROXY protocol header.
+
+    A proxy or load balancer which forwards connections at the
+    transport layer can prepend a PROXY protocol header, which
+    conveys the endpoints of the original connection to the
+    server. Both the human readable version 1 header and the
+    binary version 2 header are supported.
+
+    @see read_proxy_header, async_read_proxy_header,
+    <a href="https://www.haproxy.org/download/2.0/doc/proxy-protocol.txt">The PROXY protocol</a>
+*/
+struct proxy_header
+{
+    /// The version of the received header, 1 or 2
+    int version = 0;
+
+    /** `true` if the header carries the endpoints of a proxied connection.
+
+        This is `false` for a version 1 `UNKNOWN` header, a version 2
+        `LOCAL` command, or a version 2 header describing a transport
+        other than TCP over IPv4 or IPv6. In these cases the endpoints
+        of the connection itself should be used instead.
+    */
+    bool proxied = false;
+
+    /// The endpoint of the client which originated the connection
+    net::ip::tcp::endpoint source;
+
+    /// The endpoint the client originally connected to
+    net::ip::tcp::endpoint destination;
+};
+
+/** Read a PROXY protocol header from a stream.
+
+    This function is used to read a version 1 or version 2 PROXY
+    protocol header from the beginning of a connection. The call
+    blocks until one of the following conditions is true:
+
+    @li A complete header is received, or
+
+    @li The received data is not a valid header, or
+
+    @li An error occurs.
+
+    This operation is implemented in terms of one or more calls to
+    the stream's `read_some` function. Bytes are read directly into
+    the dynamic buffer, and the header is parsed where it lies, so
+    no separate read or copy is needed. Upon success the header is
+    consumed from the buffer. Any bytes received after the header
+    remain in the buffer, and should be passed to the next stage,
+    for example @ref http::read or an SSL handshake which accepts
+    a buffer.
+
+    Type-length-value fields of a version 2 header are skipped.
+
+    @param stream The stream to read from. This type must meet the
+    requirements of <em>SyncReadStream</em>.
+
+    @param buffer The dynamic buffer to use. This type must meet the
+    requirements of <em>DynamicBuffer</em>. If the buffer does not
+    have room for the complete header, the error
+    `net::error::no_buffer_space` is returned.
+
+    @param header The object to store the parsed header in.
+
+    @param ec Set to the error if any occurred. If the received data
+    is not a valid header, this will be @ref error::bad_proxy_header.
+
+    @return The number of bytes consumed from the buffer.
+*/
+template<
+    class SyncReadStream,
+    class DynamicBuffer>
+std::size_t
+read_proxy_header(
+    SyncReadStream& stream,
+    DynamicBuffer& buffer,
+    proxy_header& header,
+    error_code& ec);
+
+/** Read a PROXY protocol header from a stream asynchronously.
+
+    This function is used to asynchronously read a version 1 or
+    version 2 PROXY protocol header from the beginning of a
+    connection. The function call always returns immediately. The
+    asynchronous operation will continue until one of the following
+    conditions is true:
+
+    @li A complete header is received, or
+
+    @li The received data is not a valid header, or
+
+    @li An error occurs.
+
+    This operation is implemented in terms of zero or more calls to
+    the stream's `async_read_some` function, and is known as a
+    <em>composed operation</em>. The program must ensure that the
+    stream performs no other reads until this operation completes.
+    Bytes are read directly into the dynamic buffer, and the header
+    is parsed where it lies, so no separate read or copy is needed.
+    Upon success the header is consumed from the buffer. Any bytes
+    received after the header remain in the buffer, and should be
+    passed to the next stage, for example @ref http::async_read or
+    an SSL handshake which accepts a buffer.
+
+    Type-length-value fields of a version 2 header are skipped.
+
+    @param stream The stream to read from. This type must meet the
+    requirements of <em>AsyncReadStream</em>.
+
+    @param buffer The dynamic buffer to use. This type must meet the
+    requirements of <em>DynamicBuffer</em>. The object must remain
+    valid at least until the handler is called; ownership is not
+    transferred.
+
+    @param header The object to store the parsed header in. The
+    object must remain valid at least until the handler is called;
+    ownership is not transferred.
+
+    @param handler The completion handler to invoke when the
+    operation completes. The implementation takes ownership of
+    the handler by performing a decay-copy. The equivalent function
+    signature of the handler must be:
+    @code
+    void handler(
+        error_code const& error,        // result of operation
+        std::size_t bytes_transferred   // the number of bytes consumed
+                                        // from the buffer
+    );
+    @endcode
+    Regardless of whether the asynchronous operation completes
+    immediately or not, the handler will not be invoked from within
+    this function. Invocation of the handler will be performed in a
+    manner equivalent to using `net::post`.
+
+    @par Example
+    @code
+    async_read_proxy_header(stream, buffer, header,
+        [&](error_code ec, std::size_t)
+        {
+            if(ec)
+                return fail(ec);
+
+            // header.source holds the endpoint of the client, and the
+            // buffer holds any part of the request received so far.
+            http::async_read(stream, buffer, req, ...);
+        });
+    @endcode
+*/
+template<
+    class AsyncReadStream,
+    class DynamicBuffer,
+    BOOST_BEAST_ASYNC_TPARAM2 ReadHandler =
+        net::default_completion_token_t<
+            executor_type<AsyncReadStream>>>
+BOOST_BEAST_ASYNC_RESULT2(ReadHandler)
+async_read_proxy_header(
+    AsyncReadStream& stream,
+    DynamicBuffer& buffer,
+    proxy_header& header,
+    ReadHandler&& handler =
+        net::default_completion_token_t<
+            executor_type<AsyncReadStream>>{});
+
+} // beast
+} // boost
+
+#include <boost/beast/core/impl/proxy_protocol.hpp>
+
+#endif
@@ -11,8 +11,14 @@
 #define BOOST_BEAST_CORE_RATE_POLICY_HPP
 
 #include <boost/beast/core/detail/config.hpp>
+#include <boost/type_traits/make_void.hpp>
+#include <chrono>
 #include <cstdint>
 #include <limits>
+#include <memory>
+#include <mutex>
+#include <type_traits>
+#include <utility>
 
 namespace boost {
 namespace beast {
@@ -85,6 +91,38 @@ private:
     {
         return policy.on_timer();
     }
+
+    // Policies which refill continuously tell the stream
+    // how long to wait when no bytes are available, rather
+    // than relying on a periodic timer.
+    template<class Policy, class = void>
+    struct is_self_timed : std::false_type
+    {
+    };
+
+    template<class Policy>
+    struct is_self_timed<Policy, boost::void_t<decltype(
+        std::declval<Policy&>().read_wait_duration(),
+        std::declval<Policy&>().write_wait_duration())>>
+        : std::true_type
+    {
+    };
+
+    template<class Policy>
+    static
+    std::chrono::steady_clock::duration
+    read_wait_duration(Policy& policy)
+    {
+        return policy.read_wait_duration();
+    }
+
+    template<class Policy>
+    static
+    std::chrono::steady_clock::duration
+    write_wait_duration(Policy& policy)
+    {
+        return policy.write_wait_duration();
+    }
 };
 
 //------------------------------------------------------------------------------
@@ -214,7 +252,271 @@ public:
     }
 };
 
+//------------------------------------------------------------------------------
+
+/** A rate policy drawing from token buckets shared between streams.
+
+    Each @ref shared_rate_policy::bucket holds a budget of bytes
+    which is refilled continuously at a configured rate, up to a
+    maximum burst size. Any number of streams may draw from the
+    same bucket, for example all the connections of one tenant
+    or of one listener, to enforce a limit on their aggregate
+    throughput. A bucket may have a parent bucket, in which case
+    transfers are charged to the bucket and all of its ancestors,
+    and are only allowed when every bucket in the chain has
+    budget left. This allows hierarchical limits such as a cap
+    per customer underneath a cap for the whole server.
+
+    To share the budget fairly, a single operation is never
+    allowed more than the burst size divided by the number of
+    streams attached to the bucket.
+
+    When the budget is exhausted, the stream waits for the
+    amount of time needed to refill the bucket instead of for
+    the next one second interval. The stream only waits on its
+    rate timer while an operation is throttled; no periodic
+    timer is used.
+
+    Either direction may be left unlimited by passing a null
+    bucket. The same bucket may be used for both directions
+    to limit the combined throughput.
+
+    @par Example
+    @code
+    auto const tenant = std::make_shared<
+        shared_rate_policy::bucket>(1024 * 1024);
+
+    basic_stream<net::ip::tcp, net::any_io_executor, shared_rate_policy>
+        stream(shared_rate_policy(nullptr, tenant), ioc);
+    @endcode
+
+    @par Thread Safety
+    Streams using the same buckets may run on different threads.
+
+    @par Concepts
+
+    @li <em>RatePolicy</em>
+
+    @see beast::basic_stream
+*/
+class shared_rate_policy
+{
+public:
+    /// The clock used to measure refills
+    using clock_type = std::chrono::steady_clock;
+
+    /** A shared budget of bytes.
+
+        Objects of this type are shared between all the policies
+        which draw from them, and are normally managed by
+        `std::shared_ptr`.
+    */
+    class bucket
+    {
+        friend class shared_rate_policy;
+
+        mutable std::mutex m_;
+        std::shared_ptr<bucket> parent_;
+        double rate_;
+        double burst_;
+        double tokens_;
+        clock_type::time_point last_;
+        std::size_t users_ = 0;
+
+        BOOST_BEAST_DECL
+        void
+        refill(clock_type::time_point now);
+
+        BOOST_BEAST_DECL
+        double
+        share() const noexcept;
+
+    public:
+        /** Constructor
+
+            The bucket starts full.
+
+            @param bytes_per_second The rate at which the bucket
+            is refilled. This must be greater than zero.
+
+            @param burst The maximum number of bytes which may
+            accumulate in the bucket. If zero, this is equal to
+            `bytes_per_second`.
+
+            @param parent An optional bucket which is charged for
+            every transfer charged to this bucket.
+        */
+        BOOST_BEAST_DECL
+        explicit
+        bucket(
+            std::size_t bytes_per_second,
+            std::size_t burst = 0,
+            std::shared_ptr<bucket> parent = nullptr);
+
+        bucket(bucket const&) = delete;
+        bucket& operator=(bucket const&) = delete;
+
+        /** Change the limits of the bucket
+
+            @param bytes_per_second The rate at which the bucket
+            is refilled. This must be greater than zero.
+
+            @param burst The maximum number of bytes which may
+            accumulate in the bucket. If zero, this is equal to
+            `bytes_per_second`.
+        */
+        BOOST_BEAST_DECL
+        void
+        rate(
+            std::size_t bytes_per_second,
+            std::size_t burst = 0);
+
+        /// Returns the rate at which the bucket is refilled
+        BOOST_BEAST_DECL
+        std::size_t
+        rate() const;
+
+        /// Returns the number of policies drawing from the bucket
+        BOOST_BEAST_DECL
+        std::size_t
+        users() const;
+
+        /// Returns the parent bucket, if any
+        std::shared_ptr<bucket> const&
+        parent() const noexcept
+        {
+            return parent_;
+        }
+    };
+
+    /// Constructor (unlimited)
+    shared_rate_policy() = default;
+
+    /** Constructor
+
+        @param read The bucket charged for reads, or null
+        for unlimited reads.
+
+        @param write The bucket charged for writes, or null
+        for unlimited writes.
+    */
+    BOOST_BEAST_DECL
+    shared_rate_policy(
+        std::shared_ptr<bucket> read,
+        std::shared_ptr<bucket> write);
+
+    /// Copy constructor
+    BOOST_BEAST_DECL
+    shared_rate_policy(shared_rate_policy const& other);
+
+    /// Move constructor
+    BOOST_BEAST_DECL
+    shared_rate_policy(shared_rate_policy&& other) noexcept;
+
+    /// Copy assignment
+    BOOST_BEAST_DECL
+    shared_rate_policy&
+    operator=(shared_rate_policy const& other);
+
+    /// Move assignment
+    BOOST_BEAST_DECL
+    shared_rate_policy&
+    operator=(shared_rate_policy&& other) noexcept;
+
+    /// Destructor
+    BOOST_BEAST_DECL
+    ~shared_rate_policy();
+
+    /// Returns the bucket charged for reads, if any
+    std::shared_ptr<bucket> const&
+    read_bucket() const noexcept
+    {
+        return rd_;
+    }
+
+    /// Returns the bucket charged for writes, if any
+    std::shared_ptr<bucket> const&
+    write_bucket() const noexcept
+    {
+        return wr_;
+    }
+
+private:
+    friend class rate_policy_access;
+
+    static std::size_t constexpr all =
+        (std::numeric_limits<std::size_t>::max)();
+
+    std::shared_ptr<bucket> rd_;
+    std::shared_ptr<bucket> wr_;
+
+    BOOST_BEAST_DECL
+    static
+    void
+    attach(bucket* b, int n) noexcept;
+
+    BOOST_BEAST_DECL
+    static
+    std::size_t
+    available(bucket* b);
+
+    BOOST_BEAST_DECL
+    static
+    void
+    transfer(bucket* b, std::size_t n);
+
+    BOOST_BEAST_DECL
+    static
+    clock_type::duration
+    wait_duration(bucket* b);
+
+    std::size_t
+    available_read_bytes()
+    {
+        return available(rd_.get());
+    }
+
+    std::size_t
+    available_write_bytes()
+    {
+        return available(wr_.get());
+    }
+
+    void
+    transfer_read_bytes(std::size_t n)
+    {
+        transfer(rd_.get(), n);
+    }
+
+    void
+    transfer_write_bytes(std::size_t n)
+    {
+        transfer(wr_.get(), n);
+    }
+
+    clock_type::duration
+    read_wait_duration()
+    {
+        return wait_duration(rd_.get());
+    }
+
+    clock_type::duration
+    write_wait_duration()
+    {
+        return wait_duration(wr_.get());
+    }
+
+    void
+    on_timer() noexcept
+    {
+    }
+};
+
 } // beast
 } // boost
 
+#ifdef BOOST_BEAST_HEADER_ONLY
+#include <boost/beast/core/impl/rate_policy.ipp>
+#endif
+
 #endif
@@ -0,0 +1,238 @@
+//
+// Copyright (c) 2016-2019 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/boostorg/beast
+//
+
+#ifndef BOOST_BEAST_CORE_TIMEOUT_SERVICE_HPP
+#define BOOST_BEAST_CORE_TIMEOUT_SERVICE_HPP
+
+#include <boost/beast/core/detail/config.hpp>
+#include <boost/beast/core/error.hpp>
+#include <boost/beast/core/detail/service_base.hpp>
+#include <boost/asio/basic_waitable_timer.hpp>
+#include <boost/asio/io_context.hpp>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+
+namespace boost {
+namespace beast {
+
+/** A coarse-grained timer service shared by all objects of an I/O context.
+
+    This service implements a hashed timing wheel. Each armed
+    @ref timeout_service::entry is linked into one of a fixed
+    number of slots according to its expiration tick, so that
+    arming and disarming an entry are constant-time operations
+    which do not allocate. A single timer belonging to the
+    service wakes up once per tick, while at least one entry is
+    armed, and invokes the callback of every entry whose tick
+    has been reached.
+
+    Expiration times are rounded up to the next tick, so an entry
+    never fires early but may fire up to one @ref resolution late.
+    This makes the service suitable for inactivity timeouts on
+    large numbers of connections, where the cost of maintaining
+    an individual precise timer for each operation dominates.
+
+    The service is obtained from an I/O context in the usual way:
+
+    @code
+    auto& svc = net::use_service<beast::timeout_service>(ioc);
+    @endcode
+
+    @par Thread Safety
+    @e Distinct @e objects: Safe.@n
+    @e Shared @e objects: Safe.
+
+    @see basic_stream::use_timeout_service
+*/
+class timeout_service
+#if ! BOOST_BEAST_DOXYGEN
+    : public detail::service_base<timeout_service>
+#endif
+{
+public:
+    /// The clock used for expiration times
+    using clock_type = std::chrono::steady_clock;
+
+    /// The type used to represent durations
+    using duration = clock_type::duration;
+
+    /// The type used to represent expiration times
+    using time_point = clock_type::time_point;
+
+    /** A timer which may be armed with the service.
+
+        The entry holds the intrusive links used by the wheel. When
+        the entry expires its callback is invoked with the entry,
+        from within a thread running the I/O context, while the
+        service holds its internal lock. The callback must not call
+        any member function of the service, and should only
+        schedule work, for example by posting a function object to
+        an executor.
+
+        An entry which is destroyed while armed is disarmed first.
+        When it is destroyed while its callback is running on
+        another thread, the destructor waits for the callback to
+        return.
+    */
+    class entry
+    {
+        friend class timeout_service;
+
+        entry* prev_ = nullptr;
+        entry* next_ = nullptr;
+        // Stays set until the callback of an expired
+        // entry returns, read without the lock
+        std::atomic<timeout_service*> svc_{nullptr};
+        std::uint64_t tick_ = 0;
+        void (*fn_)(entry&);
+        bool armed_ = false;
+
+    public:
+        /** Constructor
+
+            @param fn The function to invoke when the entry expires.
+        */
+        explicit
+        entry(void (*fn)(entry&)) noexcept
+            : fn_(fn)
+        {
+        }
+
+        /** Move constructor
+
+            The new entry is not armed. The moved-from entry must
+            not be armed.
+        */
+        entry(entry&& other) noexcept
+            : fn_(other.fn_)
+        {
+        }
+
+        entry& operator=(entry&&) = delete;
+
+        /// Destructor
+        ~entry()
+        {
+            if(auto const svc = svc_.load())
+                svc->disarm(*this);
+        }
+    };
+
+    /** Constructor
+
+        @param ioc The I/O context which runs the timer of the service.
+    */
+    BOOST_BEAST_DECL
+    explicit
+    timeout_service(net::io_context& ioc);
+
+    /// Returns the duration of one tick of the wheel
+    duration
+    resolution() const noexcept
+    {
+        return res_;
+    }
+
+    /** Set the duration of one tick of the wheel
+
+        The default is 100 milliseconds. No entries may be armed
+        when the resolution is changed.
+    */
+    BOOST_BEAST_DECL
+    void
+    resolution(duration d);
+
+    /// Returns the number of entries currently armed
+    BOOST_BEAST_DECL
+    std::size_t
+    size() const;
+
+    /** Arm an entry
+
+        The entry will expire at the first tick not earlier than
+        `expiry`. An expiration time which has already passed
+        expires at the next tick.
+
+        @param e The entry to arm. It must not already be armed.
+
+        @param expiry The expiration time.
+    */
+    BOOST_BEAST_DECL
+    void
+    arm(entry& e, time_point expiry);
+
+    /** Disarm an entry
+
+        @return `true` if the entry was armed and has been removed
+        before expiring, or `false` if it had already expired or
+        was never armed.
+    */
+    BOOST_BEAST_DECL
+    bool
+    disarm(entry& e) noexcept;
+
+private:
+    // Must be a power of two
+    static std::size_t constexpr slots = 512;
+
+    using timer_type = net::basic_waitable_timer<
+        clock_type,
+        net::wait_traits<clock_type>,
+        net::io_context::executor_type>;
+
+    mutable std::mutex m_;
+    timer_type timer_;
+    time_point start_;
+    duration res_;
+    std::uint64_t now_ = 0;
+    std::size_t size_ = 0;
+    bool running_ = false;
+    bool shutdown_ = false;
+    entry* wheel_[slots] = {};
+
+    BOOST_BEAST_DECL
+    void
+    shutdown() override;
+
+    BOOST_BEAST_DECL
+    std::uint64_t
+    tick_floor(time_point t) const noexcept;
+
+    BOOST_BEAST_DECL
+    std::uint64_t
+    tick_ceil(time_point t) const noexcept;
+
+    BOOST_BEAST_DECL
+    void
+    link(entry& e) noexcept;
+
+    BOOST_BEAST_DECL
+    void
+    unlink(entry& e) noexcept;
+
+    BOOST_BEAST_DECL
+    void
+    schedule();
+
+    BOOST_BEAST_DECL
+    void
+    on_timer(error_code ec);
+};
+
+} // beast
+} // boost
+
+#ifdef BOOST_BEAST_HEADER_ONLY
+#include <boost/beast/core/impl/timeout_service.ipp>
+#endif
+
+#endif
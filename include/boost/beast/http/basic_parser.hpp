@@ -111,6 +111,9 @@ class basic_parser
     static unsigned constexpr flagUpgrade               = 1<< 12;
     static unsigned constexpr flagFinalChunk            = 1<< 13;
 
+    // Stream algorithms wait for readability before preparing
+    static unsigned constexpr flagWaitReadable          = 1<< 14;
+
     static constexpr
     std::uint64_t
     default_body_limit(std::true_type)
@@ -350,6 +353,44 @@ public:
             f_ &= ~flagEager;
     }
 
+    /// Returns `true` if the wait readable option is set.
+    bool
+    wait_readable() const
+    {
+        return (f_ & flagWaitReadable) != 0;
+    }
+
+    /** Set the wait readable option.
+
+        Normally the stream algorithms call `prepare` on the dynamic
+        buffer before each read, which commits memory to the buffer for
+        as long as the read is outstanding. When this option is set and
+        the dynamic buffer holds no unparsed input, the algorithms first
+        wait for the stream to become readable, and only then prepare the
+        buffer and read. Combined with a buffer which releases its storage
+        when empty, such as a @ref beast::pooled_flat_buffer after calling
+        `shrink_to_fit`, a connection which is idle between messages holds
+        no buffer memory.
+
+        The option only has an effect on streams which read directly from
+        a socket, such as `net::ip::tcp::socket` or @ref beast::basic_stream.
+        It is ignored for other streams, for example an SSL stream, which
+        may hold received data internally while its socket is idle.
+
+        The default setting is `false`.
+
+        @param v `true` to set the wait readable option or `false` to
+        disable it.
+    */
+    void
+    wait_readable(bool v)
+    {
+        if(v)
+            f_ |= flagWaitReadable;
+        else
+            f_ &= ~flagWaitReadable;
+    }
+
     /// Returns `true` if the skip parse option is set.
     bool
     skip() const
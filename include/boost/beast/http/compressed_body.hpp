@@ -0,0 +1,777 @@
+//
+// Copyright (c) 2016-2019 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/boostorg/beast
+//
+
+#ifndef BOOST_BEAST_HTTP_COMPRESSED_BODY_HPP
+#define BOOST_BEAST_HTTP_COMPRESSED_BODY_HPP
+
+#include <boost/beast/core/detail/config.hpp>
+#include <boost/beast/core/buffer_traits.hpp>
+#include <boost/beast/core/buffers_range.hpp>
+#include <boost/beast/core/buffers_suffix.hpp>
+#include <boost/beast/http/content_coding.hpp>
+#include <boost/beast/http/error.hpp>
+#include <boost/beast/http/message.hpp>
+#include <boost/beast/http/type_traits.hpp>
+#include <boost/beast/zlib/deflate_stream.hpp>
+#include <boost/beast/zlib/inflate_stream.hpp>
+#include <boost/beast/zlib/detail/checksum.hpp>
+#include <boost/asio/buffer.hpp>
+#include <boost/optional.hpp>
+#include <cstdint>
+#include <memory>
+#include <utility>
+
+namespace boost {
+namespace beast {
+namespace http {
+
+/** A <em>Body</em> adaptor which applies a content coding to another body.
+
+    This body wraps another body type. When the message is
+    serialized, the octets produced by the wrapped body's writer
+    are compressed on the fly using @ref zlib::deflate_stream and
+    emitted in the coding selected by @ref value_type::coding,
+    with the framing required by the "gzip" or "deflate"
+    content-codings. The compressed output is produced into a
+    fixed size window owned by the writer, which is reused for
+    each buffer returned to the serializer.
+
+    The size of the compressed body is not known ahead of time,
+    so calling @ref message::prepare_payload on a message using
+    this body selects the chunked Transfer-Encoding (or, for
+    HTTP/1.0, no length at all).
+
+    The caller is responsible for setting the Content-Encoding
+    field to match the coding. The function
+    @ref negotiate_content_coding may be used to choose a coding
+    from the request's Accept-Encoding field:
+
+    @code
+    response<compressed_body<string_body>> res{status::ok, req.version()};
+    res.body().coding = negotiate_content_coding(req[field::accept_encoding]);
+    if(res.body().coding != content_coding::identity)
+        res.set(field::content_encoding, to_string(res.body().coding));
+    res.body().content = std::move(json);
+    res.prepare_payload();
+    @endcode
+
+    When a message is parsed, the coding named in the
+    Content-Encoding field is removed incrementally as body octets
+    arrive, using @ref zlib::inflate_stream, and the decoded octets
+    are passed on to the wrapped body's reader. The coding which
+    was removed is stored in @ref value_type::coding. The size of
+    the decoded body is checked against @ref value_type::body_limit,
+    so that a small compressed body cannot expand into an arbitrary
+    amount of memory:
+
+    @code
+    request_parser<compressed_body<string_body>> p;
+    p.get().body().body_limit = 64 * 1024 * 1024;
+    read(stream, buffer, p);
+    @endcode
+
+    @tparam Body The body type to wrap. It must meet the requirements
+    of <em>Body</em>. Serializing requires the body to have a writer,
+    and parsing requires the body to have a reader.
+*/
+template<class Body>
+struct compressed_body
+{
+
+    /// The type of the body member when used in a message.
+    struct value_type
+    {
+        /// The uncompressed body.
+        typename Body::value_type content;
+
+        /** The coding to apply.
+
+            If this is @ref content_coding::identity, the octets
+            of the wrapped body are passed through unchanged.
+
+            When parsing, this is set to the coding named in the
+            Content-Encoding field of the message.
+        */
+        content_coding coding = content_coding::gzip;
+
+        /** The compression level.
+
+            Zero means no compression, 1 gives the best speed,
+            and 9 gives the best compression. The default is 6.
+        */
+        int level = 6;
+
+        /** The limit on the size of the decoded body when parsing.
+
+            If the number of octets produced by removing the content
+            coding exceeds this limit, the parse fails with the error
+            @ref error::body_limit. This is checked in addition to the
+            parser's own limit, which applies to the encoded octets.
+            The default is 8MB. If this is equal to `boost::none`,
+            the limit is disabled.
+        */
+        boost::optional<std::uint64_t> body_limit =
+            std::uint64_t{8 * 1024 * 1024};
+    };
+
+    /** The algorithm for parsing the body
+
+        Meets the requirements of <em>BodyReader</em>.
+    */
+#if BOOST_BEAST_DOXYGEN
+    using reader = __implementation_defined__;
+#else
+    class reader
+    {
+        // size of the output window
+        static std::size_t constexpr window_size = 16384;
+
+        enum class state
+        {
+            header,
+            extra_len,
+            extra,
+            name,
+            comment,
+            header_crc,
+            body,
+            trailer,
+            done
+        };
+
+        typename Body::reader r_;
+        value_type& body_;
+        void const* h_;
+        string_view(*coding_)(void const*);
+        zlib::inflate_stream zi_;
+        std::unique_ptr<unsigned char[]> buf_;
+        std::size_t pos_ = 0;       // first pending octet in the window
+        std::size_t n_ = 0;         // pending octets in the window
+        std::uint64_t total_ = 0;   // decoded octets so far
+        std::uint32_t check_ = 0;
+        std::size_t need_ = 0;      // octets of header or trailer wanted
+        std::size_t have_ = 0;      // octets of header or trailer seen
+        unsigned char tmp_[10];     // header or trailer octets
+        unsigned char flags_ = 0;   // gzip FLG
+        state state_ = state::header;
+        bool raw_ = false;          // deflate without zlib framing
+        bool full_ = false;         // last inflate filled the window
+
+        // The header is not parsed yet when the reader
+        // is constructed, so remember how to look at it.
+        template<bool isRequest, class Fields>
+        static
+        string_view
+        get_coding(void const* h)
+        {
+            return (*static_cast<header<isRequest, Fields> const*>(
+                h))[field::content_encoding];
+        }
+
+    public:
+        template<bool isRequest, class Fields>
+        explicit
+        reader(header<isRequest, Fields>& h, value_type& b)
+            : r_(h, b.content)
+            , body_(b)
+            , h_(&h)
+            , coding_(&reader::get_coding<isRequest, Fields>)
+        {
+        }
+
+        void
+        init(boost::optional<
+            std::uint64_t> const& length, error_code& ec)
+        {
+            auto const s = coding_(h_);
+            body_.coding = s.empty() ? content_coding::identity :
+                string_to_content_coding(s);
+            if(body_.coding == content_coding::identity)
+                return r_.init(length, ec);
+            if(body_.coding != content_coding::gzip &&
+                body_.coding != content_coding::deflate)
+            {
+                ec = error::bad_content_encoding;
+                return;
+            }
+            // The decoded length is not known
+            r_.init(boost::none, ec);
+            if(ec)
+                return;
+            zi_.reset(15);
+            buf_.reset(new unsigned char[window_size]);
+            if(body_.coding == content_coding::gzip)
+            {
+                check_ = 0;
+                need_ = 10;
+            }
+            else
+            {
+                check_ = 1;
+                need_ = 2;
+            }
+        }
+
+        template<class ConstBufferSequence>
+        std::size_t
+        put(ConstBufferSequence const& buffers,
+            error_code& ec)
+        {
+            if(body_.coding == content_coding::identity)
+                return r_.put(buffers, ec);
+
+            ec = {};
+            if(! flush(ec))
+                return 0;
+            std::size_t used = 0;
+            for(auto const b : beast::buffers_range_ref(buffers))
+            {
+                auto p = static_cast<unsigned char const*>(b.data());
+                auto n = b.size();
+                while(n > 0)
+                {
+                    auto const total = total_;
+                    std::size_t const consumed =
+                        state_ == state::body ?
+                            inflate(p, n, ec) :
+                            frame(p, n, ec);
+                    used += consumed;
+                    p += consumed;
+                    n -= consumed;
+                    if(ec)
+                        return used;
+                    if(consumed == 0 && total == total_)
+                        return used;
+                }
+            }
+            // Drain output still held by the decompressor
+            while(state_ == state::body && full_)
+            {
+                inflate(tmp_, 0, ec);
+                if(ec)
+                    break;
+            }
+            return used;
+        }
+
+        void
+        finish(error_code& ec)
+        {
+            if(body_.coding != content_coding::identity)
+            {
+                // a raw deflate stream ends with the last block
+                if(state_ != state::done)
+                {
+                    ec = error::partial_message;
+                    return;
+                }
+                if(! flush(ec))
+                    return;
+            }
+            r_.finish(ec);
+        }
+
+    private:
+        // Deliver pending decoded octets to the wrapped reader
+        bool
+        flush(error_code& ec)
+        {
+            while(n_ > 0)
+            {
+                auto const n = r_.put(net::const_buffer(
+                    buf_.get() + pos_, n_), ec);
+                pos_ += n;
+                n_ -= n;
+                if(ec)
+                    return false;
+                if(n == 0)
+                {
+                    // the wrapped reader has no room left
+                    ec = error::need_buffer;
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        void
+        update(void const* data, std::size_t size)
+        {
+            if(body_.coding == content_coding::gzip)
+                check_ = zlib::detail::crc32(check_, data, size);
+            else
+                check_ = zlib::detail::adler32(check_, data, size);
+        }
+
+        std::size_t
+        inflate(
+            unsigned char const* p,
+            std::size_t n,
+            error_code& ec)
+        {
+            // the window still holds undelivered output
+            if(! flush(ec))
+                return 0;
+            zlib::z_params zs;
+            zs.next_in = p;
+            zs.avail_in = n;
+            zs.next_out = buf_.get();
+            zs.avail_out = window_size;
+            error_code zec;
+            zi_.write(zs, zlib::Flush::sync, zec);
+            auto const consumed = n - zs.avail_in;
+            auto const produced = window_size - zs.avail_out;
+            full_ = zs.avail_out == 0;
+            if(zec == zlib::error::end_of_stream)
+            {
+                if(raw_)
+                {
+                    state_ = state::done;
+                }
+                else
+                {
+                    state_ = state::trailer;
+                    have_ = 0;
+                    need_ = body_.coding ==
+                        content_coding::gzip ? 8 : 4;
+                }
+            }
+            else if(zec && zec != zlib::error::need_buffers)
+            {
+                ec = zec;
+                return consumed;
+            }
+            total_ += produced;
+            if(body_.body_limit && total_ > *body_.body_limit)
+            {
+                ec = error::body_limit;
+                return consumed;
+            }
+            if(! raw_)
+                update(buf_.get(), produced);
+            pos_ = 0;
+            n_ = produced;
+            flush(ec);
+            return consumed;
+        }
+
+        // Process the octets of the header and trailer
+        std::size_t
+        frame(
+            unsigned char const* p,
+            std::size_t n,
+            error_code& ec)
+        {
+            std::size_t used = 0;
+            while(used < n && state_ != state::body)
+            {
+                if(state_ == state::done)
+                {
+                    // data after the end of the coded body
+                    ec = error::bad_content_encoding;
+                    return used;
+                }
+                auto const c = p[used++];
+                if(state_ == state::name ||
+                    state_ == state::comment)
+                {
+                    if(c == 0)
+                        next_field();
+                    continue;
+                }
+                if(state_ == state::extra)
+                {
+                    if(++have_ == need_)
+                        next_field();
+                    continue;
+                }
+                tmp_[have_++] = c;
+                if(have_ < need_)
+                    continue;
+                switch(state_)
+                {
+                case state::header:
+                    if(body_.coding == content_coding::gzip)
+                    {
+                        if(tmp_[0] != 0x1f || tmp_[1] != 0x8b ||
+                            tmp_[2] != 8 || (tmp_[3] & 0xe0))
+                        {
+                            ec = error::bad_content_encoding;
+                            return used;
+                        }
+                        flags_ = tmp_[3];
+                        next_field();
+                        break;
+                    }
+                    if((tmp_[0] & 0x0f) != 8 || (tmp_[0] >> 4) > 7 ||
+                        ((tmp_[0] << 8) | tmp_[1]) % 31 != 0 ||
+                        (tmp_[1] & 0x20))
+                    {
+                        // Some senders use a raw deflate stream
+                        // for "deflate", so decode these octets.
+                        raw_ = true;
+                        state_ = state::body;
+                        auto const consumed = inflate(tmp_, 2, ec);
+                        if(! ec && consumed != 2)
+                            ec = error::bad_content_encoding;
+                        if(ec)
+                            return used;
+                        break;
+                    }
+                    state_ = state::body;
+                    break;
+
+                case state::extra_len:
+                    state_ = state::extra;
+                    need_ = tmp_[0] | (tmp_[1] << 8);
+                    have_ = 0;
+                    if(need_ == 0)
+                        next_field();
+                    break;
+
+                case state::header_crc:
+                    state_ = state::body;
+                    break;
+
+                case state::trailer:
+                {
+                    std::uint32_t check = 0;
+                    std::uint32_t size = 0;
+                    if(body_.coding == content_coding::gzip)
+                    {
+                        for(int i = 3; i >= 0; --i)
+                            check = (check << 8) | tmp_[i];
+                        for(int i = 7; i >= 4; --i)
+                            size = (size << 8) | tmp_[i];
+                    }
+                    else
+                    {
+                        for(int i = 0; i < 4; ++i)
+                            check = (check << 8) | tmp_[i];
+                        size = static_cast<std::uint32_t>(total_);
+                    }
+                    if(check != check_ ||
+                        size != static_cast<std::uint32_t>(total_))
+                    {
+                        ec = error::bad_content_encoding;
+                        return used;
+                    }
+                    state_ = state::done;
+                    break;
+                }
+
+                default:
+                    BOOST_ASSERT(false);
+                    break;
+                }
+            }
+            return used;
+        }
+
+        // Advance to the next optional gzip header field
+        void
+        next_field()
+        {
+            // FHCRC FEXTRA FNAME FCOMMENT
+            static unsigned char constexpr fhcrc = 0x02;
+            static unsigned char constexpr fextra = 0x04;
+            static unsigned char constexpr fname = 0x08;
+            static unsigned char constexpr fcomment = 0x10;
+
+            have_ = 0;
+            if(state_ == state::header && (flags_ & fextra))
+            {
+                state_ = state::extra_len;
+                need_ = 2;
+                return;
+            }
+            if(static_cast<int>(state_) < static_cast<int>(
+                state::name) && (flags_ & fname))
+            {
+                state_ = state::name;
+                return;
+            }
+            if(static_cast<int>(state_) < static_cast<int>(
+                state::comment) && (flags_ & fcomment))
+            {
+                state_ = state::comment;
+                return;
+            }
+            if(static_cast<int>(state_) < static_cast<int>(
+                state::header_crc) && (flags_ & fhcrc))
+            {
+                state_ = state::header_crc;
+                need_ = 2;
+                return;
+            }
+            state_ = state::body;
+        }
+    };
+#endif
+
+    /** The algorithm for serializing the body
+
+        Meets the requirements of <em>BodyWriter</em>.
+    */
+#if BOOST_BEAST_DOXYGEN
+    using writer = __implementation_defined__;
+#else
+    class writer
+    {
+        using inner_buffers_type =
+            typename Body::writer::const_buffers_type;
+
+        // size of the output window
+        static std::size_t constexpr window_size = 16384;
+
+        enum class state
+        {
+            header,
+            body,
+            finish,
+            trailer,
+            done
+        };
+
+        typename Body::writer w_;
+        value_type const& body_;
+        zlib::deflate_stream zo_;
+        std::unique_ptr<unsigned char[]> buf_;
+        boost::optional<buffers_suffix<inner_buffers_type>> in_;
+        std::uint32_t check_ = 0;
+        std::uint32_t isize_ = 0;
+        std::size_t n_ = 0; // pending octets in the window
+        state state_ = state::header;
+        bool more_ = true;
+
+    public:
+        using const_buffers_type =
+            net::const_buffer;
+
+        template<bool isRequest, class Fields>
+        explicit
+        writer(header<isRequest, Fields> const& h, value_type const& b)
+            : w_(h, b.content)
+            , body_(b)
+        {
+        }
+
+        void
+        init(error_code& ec)
+        {
+            w_.init(ec);
+            if(ec || body_.coding == content_coding::identity)
+                return;
+            if(body_.coding != content_coding::gzip &&
+                body_.coding != content_coding::deflate)
+            {
+                ec = error::bad_content_encoding;
+                return;
+            }
+            zo_.reset(body_.level, 15, 8, zlib::Strategy::normal);
+            buf_.reset(new unsigned char[window_size]);
+            check_ = body_.coding == content_coding::gzip ? 0 : 1;
+        }
+
+        boost::optional<std::pair<const_buffers_type, bool>>
+        get(error_code& ec)
+        {
+            if(body_.coding == content_coding::identity)
+                return pass_through(ec);
+
+            ec = {};
+            if(state_ == state::done)
+                return boost::none;
+
+            zlib::z_params zs;
+            zs.next_out = buf_.get() + n_;
+            zs.avail_out = window_size - n_;
+            if(state_ == state::header)
+            {
+                write_header(zs);
+                state_ = state::body;
+            }
+            while(state_ == state::body)
+            {
+                if(! in_ || buffer_bytes(*in_) == 0)
+                {
+                    in_.reset();
+                    if(! more_)
+                    {
+                        state_ = state::finish;
+                        break;
+                    }
+                    auto result = w_.get(ec);
+                    if(ec)
+                    {
+                        // keep the pending output for the next call,
+                        // the error may be need_buffer.
+                        n_ = window_size - zs.avail_out;
+                        return boost::none;
+                    }
+                    if(! result)
+                    {
+                        more_ = false;
+                        continue;
+                    }
+                    more_ = result->second;
+                    in_.emplace(result->first);
+                    continue;
+                }
+                for(auto const b : *in_)
+                {
+                    if(b.size() == 0)
+                        continue;
+                    zs.next_in = b.data();
+                    zs.avail_in = b.size();
+                    zo_.write(zs, zlib::Flush::none, ec);
+                    if(ec == zlib::error::need_buffers)
+                        ec = {};
+                    else if(ec)
+                        return boost::none;
+                    auto const n = b.size() - zs.avail_in;
+                    update(b.data(), n);
+                    in_->consume(n);
+                    break;
+                }
+                if(zs.avail_out == 0)
+                    return output(zs, true);
+            }
+            while(state_ == state::finish)
+            {
+                zs.next_in = nullptr;
+                zs.avail_in = 0;
+                zo_.write(zs, zlib::Flush::finish, ec);
+                if(ec == zlib::error::end_of_stream)
+                {
+                    ec = {};
+                    state_ = state::trailer;
+                    break;
+                }
+                if(ec == zlib::error::need_buffers)
+                    ec = {};
+                else if(ec)
+                    return boost::none;
+                if(zs.avail_out == 0)
+                    return output(zs, true);
+            }
+            BOOST_ASSERT(state_ == state::trailer);
+            if(zs.avail_out < 8)
+                return output(zs, true);
+            write_trailer(zs);
+            state_ = state::done;
+            return output(zs, false);
+        }
+
+    private:
+        boost::optional<std::pair<const_buffers_type, bool>>
+        output(zlib::z_params const& zs, bool more)
+        {
+            n_ = 0;
+            return {{const_buffers_type{buf_.get(),
+                window_size - zs.avail_out}, more}};
+        }
+
+        void
+        put(zlib::z_params& zs, unsigned char c)
+        {
+            BOOST_ASSERT(zs.avail_out > 0);
+            auto p = static_cast<unsigned char*>(zs.next_out);
+            *p++ = c;
+            zs.next_out = p;
+            --zs.avail_out;
+        }
+
+        void
+        update(void const* data, std::size_t size)
+        {
+            if(body_.coding == content_coding::gzip)
+                check_ = zlib::detail::crc32(check_, data, size);
+            else
+                check_ = zlib::detail::adler32(check_, data, size);
+            isize_ += static_cast<std::uint32_t>(size);
+        }
+
+        void
+        write_header(zlib::z_params& zs)
+        {
+            if(body_.coding == content_coding::gzip)
+            {
+                // ID1 ID2 CM FLG MTIME(4) XFL OS
+                static unsigned char const hdr[10] = {
+                    0x1f, 0x8b, 8, 0, 0, 0, 0, 0, 0, 0xff };
+                for(auto c : hdr)
+                    put(zs, c);
+            }
+            else
+            {
+                // CMF FLG: 32K window, default level
+                put(zs, 0x78);
+                put(zs, 0x9c);
+            }
+        }
+
+        void
+        write_trailer(zlib::z_params& zs)
+        {
+            if(body_.coding == content_coding::gzip)
+            {
+                // CRC32 ISIZE, little endian
+                for(int i = 0; i < 32; i += 8)
+                    put(zs, static_cast<unsigned char>(check_ >> i));
+                for(int i = 0; i < 32; i += 8)
+                    put(zs, static_cast<unsigned char>(isize_ >> i));
+            }
+            else
+            {
+                // ADLER32, big endian
+                for(int i = 24; i >= 0; i -= 8)
+                    put(zs, static_cast<unsigned char>(check_ >> i));
+            }
+        }
+
+        boost::optional<std::pair<const_buffers_type, bool>>
+        pass_through(error_code& ec)
+        {
+            // Flatten one buffer at a time from the inner writer
+            for(;;)
+            {
+                if(! in_ || buffer_bytes(*in_) == 0)
+                {
+                    in_.reset();
+                    if(! more_)
+                    {
+                        ec = {};
+                        return boost::none;
+                    }
+                    auto result = w_.get(ec);
+                    if(ec || ! result)
+                        return boost::none;
+                    more_ = result->second;
+                    in_.emplace(result->first);
+                    continue;
+                }
+                for(auto const b : *in_)
+                {
+                    if(b.size() == 0)
+                        continue;
+                    in_->consume(b.size());
+                    return {{b, more_ || buffer_bytes(*in_) > 0}};
+                }
+            }
+        }
+    };
+#endif
+};
+
+} // http
+} // beast
+} // boost
+
+#endif
@@ -0,0 +1,102 @@
+//
+// Copyright (c) 2016-2019 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/boostorg/beast
+//
+
+#ifndef BOOST_BEAST_HTTP_CONTENT_CODING_HPP
+#define BOOST_BEAST_HTTP_CONTENT_CODING_HPP
+
+#include <boost/beast/core/detail/config.hpp>
+#include <boost/beast/core/string.hpp>
+#include <iosfwd>
+
+namespace boost {
+namespace beast {
+namespace http {
+
+/** A content coding applied to a message body.
+
+    These are the values which may appear in the Content-Encoding
+    and Accept-Encoding fields and which Beast knows how to apply
+    and remove.
+
+    @see https://tools.ietf.org/html/rfc7231#section-3.1.2.1
+*/
+enum class content_coding
+{
+    /// No coding; the body octets are sent as-is.
+    identity,
+
+    /// The "deflate" coding: a zlib stream (RFC 1950).
+    deflate,
+
+    /// The "gzip" coding: a gzip stream (RFC 1952).
+    gzip,
+
+    /** An unrecognized coding.
+
+        This is returned by @ref string_to_content_coding for
+        codings which are not supported.
+    */
+    unknown
+};
+
+/** Converts a string to a content coding.
+
+    The comparison is case-insensitive. The obsolete alias
+    "x-gzip" is recognized as @ref content_coding::gzip.
+
+    @return The corresponding coding, or
+    @ref content_coding::unknown if the string is not recognized.
+*/
+BOOST_BEAST_DECL
+content_coding
+string_to_content_coding(string_view s);
+
+/// Returns the text representation of a content coding.
+BOOST_BEAST_DECL
+string_view
+to_string(content_coding c);
+
+/** Choose a content coding from the value of an Accept-Encoding field.
+
+    The field value is parsed as a comma separated list of
+    codings with optional quality values. The supported coding
+    with the highest non-zero quality is returned, preferring
+    @ref content_coding::gzip over @ref content_coding::deflate
+    when they are ranked equally. A compressed coding is not
+    chosen if "identity" is listed with a higher quality.
+
+    @param accept_encoding The value of the Accept-Encoding field.
+    If the field is missing or empty, no coding is chosen.
+
+    @return The chosen coding, or @ref content_coding::identity
+    if no supported compression coding is acceptable.
+
+    @see https://tools.ietf.org/html/rfc7231#section-5.3.4
+*/
+BOOST_BEAST_DECL
+content_coding
+negotiate_content_coding(string_view accept_encoding);
+
+/// Write the text for a content coding to an output stream.
+inline
+std::ostream&
+operator<<(std::ostream& os, content_coding c)
+{
+    return os << to_string(c);
+}
+
+} // http
+} // beast
+} // boost
+
+#ifdef BOOST_BEAST_HEADER_ONLY
+#include <boost/beast/http/impl/content_coding.ipp>
+#endif
+
+#endif
@@ -161,7 +161,15 @@ enum class error
         unexpected end-of-file condition is encountered while trying
         to read from the file.
     */
-    short_read
+    short_read,
+
+    /** The Content-Encoding is invalid or not supported.
+
+        This error is returned by @ref compressed_body when the
+        content coding to apply or remove is not one which the
+        body knows how to process.
+    */
+    bad_content_encoding
 };
 
 } // http
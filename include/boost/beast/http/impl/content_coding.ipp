@@ -0,0 +1,130 @@
+//
+// Copyright (c) 2016-2019 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/boostorg/beast
+//
+
+#ifndef BOOST_BEAST_HTTP_IMPL_CONTENT_CODING_IPP
+#define BOOST_BEAST_HTTP_IMPL_CONTENT_CODING_IPP
+
+#include <boost/beast/http/content_coding.hpp>
+#include <boost/beast/http/rfc7230.hpp>
+#include <ostream>
+
+namespace boost {
+namespace beast {
+namespace http {
+
+namespace detail {
+
+// Parse a qvalue into thousandths, returns -1 on error
+//
+inline
+int
+parse_qvalue(string_view s)
+{
+    if(s.empty() || s.size() > 5)
+        return -1;
+    if(s[0] != '0' && s[0] != '1')
+        return -1;
+    int v = (s[0] - '0') * 1000;
+    if(s.size() == 1)
+        return v;
+    if(s[1] != '.')
+        return -1;
+    int scale = 100;
+    for(std::size_t i = 2; i < s.size(); ++i)
+    {
+        if(s[i] < '0' || s[i] > '9')
+            return -1;
+        v += (s[i] - '0') * scale;
+        scale /= 10;
+    }
+    if(v > 1000)
+        return -1;
+    return v;
+}
+
+} // detail
+
+content_coding
+string_to_content_coding(string_view s)
+{
+    if(beast::iequals(s, "gzip") || beast::iequals(s, "x-gzip"))
+        return content_coding::gzip;
+    if(beast::iequals(s, "deflate"))
+        return content_coding::deflate;
+    if(beast::iequals(s, "identity"))
+        return content_coding::identity;
+    return content_coding::unknown;
+}
+
+string_view
+to_string(content_coding c)
+{
+    switch(c)
+    {
+    case content_coding::identity:  return "identity";
+    case content_coding::deflate:   return "deflate";
+    case content_coding::gzip:      return "gzip";
+    default:
+        break;
+    }
+    return "<unknown-content-coding>";
+}
+
+content_coding
+negotiate_content_coding(string_view accept_encoding)
+{
+    // quality in thousandths, -1 means not listed
+    int gzip = -1;
+    int deflate = -1;
+    int identity = -1;
+    int any = -1;
+    for(auto const& e : ext_list{accept_encoding})
+    {
+        int q = 1000;
+        for(auto const& p : e.second)
+        {
+            if(beast::iequals(p.first, "q"))
+            {
+                q = detail::parse_qvalue(p.second);
+                break;
+            }
+        }
+        if(q < 0)
+            continue;
+        if(e.first == "*")
+        {
+            any = q;
+            continue;
+        }
+        switch(string_to_content_coding(e.first))
+        {
+        case content_coding::gzip:      gzip = q; break;
+        case content_coding::deflate:   deflate = q; break;
+        case content_coding::identity:  identity = q; break;
+        default:
+            break;
+        }
+    }
+    if(gzip < 0)
+        gzip = any;
+    if(deflate < 0)
+        deflate = any;
+    auto const best = gzip >= deflate ? gzip : deflate;
+    if(best <= 0 || best < identity)
+        return content_coding::identity;
+    if(gzip >= deflate)
+        return content_coding::gzip;
+    return content_coding::deflate;
+}
+
+} // http
+} // beast
+} // boost
+
+#endif
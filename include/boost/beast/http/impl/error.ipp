@@ -57,6 +57,7 @@ public:
         case error::bad_obs_fold: return "bad obs-fold";
         case error::stale_parser: return "stale parser";
         case error::short_read: return "unexpected eof in body";
+        case error::bad_content_encoding: return "bad Content-Encoding";
 
         default:
             return "beast.http error";
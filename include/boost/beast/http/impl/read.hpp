@@ -19,6 +19,7 @@
 #include <boost/beast/core/stream_traits.hpp>
 #include <boost/beast/core/detail/buffer.hpp>
 #include <boost/beast/core/detail/read.hpp>
+#include <boost/beast/core/detail/wait_read.hpp>
 #include <boost/asio/error.hpp>
 #include <boost/asio/compose.hpp>
 #include <boost/asio/coroutine.hpp>
@@ -192,6 +193,24 @@ public:
                     break;
 
             do_read:
+                if( p_.wait_readable() && b_.size() == 0 &&
+                    beast::detail::is_wait_readable<
+                        AsyncReadStream>::value)
+                {
+                    BOOST_ASIO_CORO_YIELD
+                    {
+                        cont_ = true;
+
+                        BOOST_ASIO_HANDLER_LOCATION((
+                            __FILE__, __LINE__,
+                            "http::async_read_some"));
+
+                        beast::detail::async_wait_read(
+                            s_, std::move(self));
+                    }
+                    if(ec)
+                        goto upcall;
+                }
                 BOOST_ASIO_CORO_YIELD
                 {
                     cont_ = true;
@@ -333,6 +352,14 @@ read_some(SyncReadStream& s, DynamicBuffer& b, basic_parser<isRequest>& p, error
             break;
 
     do_read:
+        if( p.wait_readable() && b.size() == 0 &&
+            beast::detail::is_wait_readable<
+                SyncReadStream>::value)
+        {
+            beast::detail::wait_read(s, ec);
+            if(ec)
+                return total;
+        }
         // VFALCO This was read_size_or_throw
         auto const size = read_size(b, 65536);
         if(size == 0)
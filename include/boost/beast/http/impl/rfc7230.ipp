@@ -78,6 +78,7 @@ increment()
         };
     auto need_comma = it_ != first_;
     v_.first = {};
+    v_.second = {};
     first_ = it_;
     for(;;)
     {
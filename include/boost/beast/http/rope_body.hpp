@@ -0,0 +1,341 @@
+//
+// Copyright (c) 2016-2019 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/boostorg/beast
+//
+
+#ifndef BOOST_BEAST_HTTP_ROPE_BODY_HPP
+#define BOOST_BEAST_HTTP_ROPE_BODY_HPP
+
+#include <boost/beast/core/detail/config.hpp>
+#include <boost/beast/core/buffer_traits.hpp>
+#include <boost/beast/core/buffers_range.hpp>
+#include <boost/beast/core/detail/clamp.hpp>
+#include <boost/beast/http/error.hpp>
+#include <boost/beast/http/message.hpp>
+#include <boost/beast/http/shared_body.hpp>
+#include <boost/asio/buffer.hpp>
+#include <boost/container/small_vector.hpp>
+#include <boost/optional.hpp>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+
+namespace boost {
+namespace beast {
+namespace http {
+
+/** A <em>Body</em> made of a sequence of buffer segments
+
+    This body represents the payload as an ordered list of
+    buffers which are never concatenated. Each segment may be
+    accompanied by an owner, a reference-counted object which
+    keeps the memory for the segment alive for as long as the
+    body refers to it. Segments without an owner are references
+    to memory whose lifetime is managed by the caller.
+
+    When serializing, the segments are presented directly to
+    the stream as a single buffer sequence, allowing responses
+    assembled from cached fragments to be sent with one gather
+    write instead of first being copied into a contiguous
+    container.
+
+    Messages using this body type may be serialized and parsed.
+    When parsing, the body octets are accumulated into a single
+    owned segment.
+*/
+struct rope_body
+{
+    /// The type of the body member when used in a message.
+    class value_type
+    {
+        // Most ropes are a handful of fragments
+        static std::size_t constexpr inline_segments = 8;
+
+        boost::container::small_vector<
+            net::const_buffer, inline_segments> segs_;
+        boost::container::small_vector<
+            std::shared_ptr<void const>, inline_segments> owners_;
+        std::uint64_t size_ = 0;
+
+    public:
+        /** The buffer sequence representing the segments.
+
+            Objects of this type meet the requirements of
+            <em>ConstBufferSequence</em>. They refer to the segment
+            list of the body and are invalidated when the body is
+            modified.
+        */
+#if BOOST_BEAST_DOXYGEN
+        using const_buffers_type = __implementation_defined__;
+#else
+        class const_buffers_type
+        {
+            net::const_buffer const* begin_ = nullptr;
+            net::const_buffer const* end_ = nullptr;
+
+        public:
+            using value_type = net::const_buffer;
+
+            using const_iterator = net::const_buffer const*;
+
+            const_buffers_type() = default;
+
+            const_buffers_type(
+                net::const_buffer const* first,
+                net::const_buffer const* last) noexcept
+                : begin_(first)
+                , end_(last)
+            {
+            }
+
+            const_iterator
+            begin() const noexcept
+            {
+                return begin_;
+            }
+
+            const_iterator
+            end() const noexcept
+            {
+                return end_;
+            }
+        };
+#endif
+
+        /// Constructor (empty body)
+        value_type() = default;
+
+        /// Returns the number of octets in all segments
+        std::uint64_t
+        size() const noexcept
+        {
+            return size_;
+        }
+
+        /// Returns `true` if the body holds no octets
+        bool
+        empty() const noexcept
+        {
+            return size_ == 0;
+        }
+
+        /// Returns the number of segments
+        std::size_t
+        segments() const noexcept
+        {
+            return segs_.size();
+        }
+
+        /// Returns the segments as a buffer sequence
+        const_buffers_type
+        buffers() const noexcept
+        {
+            return {segs_.data(), segs_.data() + segs_.size()};
+        }
+
+        /** Append a segment referring to caller-owned memory
+
+            The memory must remain valid until the body is destroyed,
+            cleared, or any message using it is finished being
+            serialized. Empty buffers are ignored.
+        */
+        void
+        append(net::const_buffer buffer)
+        {
+            if(buffer.size() == 0)
+                return;
+            segs_.push_back(buffer);
+            size_ += buffer.size();
+        }
+
+        /** Append a segment kept alive by a shared owner
+
+            A copy of `owner` is held for as long as the body holds
+            the segment. Empty buffers are ignored.
+
+            @param owner A shared pointer which keeps the memory
+            referenced by `buffer` alive.
+
+            @param buffer The memory holding the segment octets.
+        */
+        template<class T>
+        void
+        append(
+            std::shared_ptr<T> owner,
+            net::const_buffer buffer)
+        {
+            if(buffer.size() == 0)
+                return;
+            append(buffer);
+            if(owner)
+                owners_.emplace_back(std::move(owner));
+        }
+
+        /** Append a segment holding a shared body
+
+            The segment refers to the same storage as `body`.
+        */
+        void
+        append(shared_body::value_type const& body)
+        {
+            append(body.owner(), body.buffer());
+        }
+
+        /** Append a segment holding a string
+
+            The string is moved into newly allocated storage owned
+            by the body.
+        */
+        void
+        append(std::string s)
+        {
+            auto sp = std::make_shared<
+                std::string const>(std::move(s));
+            net::const_buffer const b(sp->data(), sp->size());
+            append(std::move(sp), b);
+        }
+
+        /// Remove all segments and release their owners
+        void
+        clear() noexcept
+        {
+            segs_.clear();
+            owners_.clear();
+            size_ = 0;
+        }
+    };
+
+    /** Returns the payload size of the body
+
+        When this body is used with @ref message::prepare_payload,
+        the Content-Length will be set to the payload size, and
+        any chunked Transfer-Encoding will be removed.
+    */
+    static
+    std::uint64_t
+    size(value_type const& body)
+    {
+        return body.size();
+    }
+
+    /** The algorithm for parsing the body
+
+        Meets the requirements of <em>BodyReader</em>.
+    */
+#if BOOST_BEAST_DOXYGEN
+    using reader = __implementation_defined__;
+#else
+    class reader
+    {
+        value_type& body_;
+        std::string s_;
+
+    public:
+        template<bool isRequest, class Fields>
+        explicit
+        reader(header<isRequest, Fields>&, value_type& b)
+            : body_(b)
+        {
+        }
+
+        void
+        init(boost::optional<
+            std::uint64_t> const& length, error_code& ec)
+        {
+            if(length)
+            {
+                if(*length > s_.max_size())
+                {
+                    ec = error::buffer_overflow;
+                    return;
+                }
+                s_.reserve(beast::detail::clamp(*length));
+            }
+            ec = {};
+        }
+
+        template<class ConstBufferSequence>
+        std::size_t
+        put(ConstBufferSequence const& buffers,
+            error_code& ec)
+        {
+            auto const extra = buffer_bytes(buffers);
+            auto const size = s_.size();
+            if(extra > s_.max_size() - size)
+            {
+                ec = error::buffer_overflow;
+                return 0;
+            }
+            s_.resize(size + extra);
+            ec = {};
+            char* dest = &s_[size];
+            for(auto b : beast::buffers_range_ref(buffers))
+            {
+                std::char_traits<char>::copy(dest,
+                    static_cast<char const*>(b.data()), b.size());
+                dest += b.size();
+            }
+            return extra;
+        }
+
+        void
+        finish(error_code& ec)
+        {
+            body_.clear();
+            body_.append(std::move(s_));
+            ec = {};
+        }
+    };
+#endif
+
+    /** The algorithm for serializing the body
+
+        Meets the requirements of <em>BodyWriter</em>.
+
+        The writer produces all segments at once, as a single
+        buffer sequence referring to the segment list.
+    */
+#if BOOST_BEAST_DOXYGEN
+    using writer = __implementation_defined__;
+#else
+    class writer
+    {
+        value_type const& body_;
+
+    public:
+        using const_buffers_type =
+            value_type::const_buffers_type;
+
+        template<bool isRequest, class Fields>
+        explicit
+        writer(header<isRequest, Fields> const&, value_type const& b)
+            : body_(b)
+        {
+        }
+
+        void
+        init(error_code& ec)
+        {
+            ec = {};
+        }
+
+        boost::optional<std::pair<const_buffers_type, bool>>
+        get(error_code& ec)
+        {
+            ec = {};
+            return {{body_.buffers(), false}};
+        }
+    };
+#endif
+};
+
+} // http
+} // beast
+} // boost
+
+#endif
@@ -0,0 +1,295 @@
+//
+// Copyright (c) 2016-2019 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/boostorg/beast
+//
+
+#ifndef BOOST_BEAST_HTTP_SHARED_BODY_HPP
+#define BOOST_BEAST_HTTP_SHARED_BODY_HPP
+
+#include <boost/beast/core/detail/config.hpp>
+#include <boost/beast/core/buffer_traits.hpp>
+#include <boost/beast/core/buffers_range.hpp>
+#include <boost/beast/core/string.hpp>
+#include <boost/beast/core/detail/clamp.hpp>
+#include <boost/beast/http/error.hpp>
+#include <boost/beast/http/message.hpp>
+#include <boost/asio/buffer.hpp>
+#include <boost/optional.hpp>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+
+namespace boost {
+namespace beast {
+namespace http {
+
+/** A <em>Body</em> using a shared, immutable buffer
+
+    This body holds a reference-counted pointer to a read-only
+    area of memory. Copying the value is cheap: the copies refer
+    to the same storage, which is released when the last copy
+    goes away. This allows the same payload, for example a
+    cached document, to be sent in many messages concurrently
+    without duplicating it for each message.
+
+    Messages using this body type may be serialized and parsed.
+    When parsing, the body octets are accumulated into a private
+    string which becomes the shared storage once the body is
+    complete.
+*/
+struct shared_body
+{
+    /** The type of the body member when used in a message.
+
+        Objects of this type are immutable views of shared
+        storage. Assigning a new value replaces the view; it
+        never modifies the storage seen by other copies.
+    */
+    class value_type
+    {
+        std::shared_ptr<void const> owner_;
+        net::const_buffer buffer_;
+
+    public:
+        /// Constructor (empty body)
+        value_type() = default;
+
+        /// Copy constructor
+        value_type(value_type const&) = default;
+
+        /// Move constructor
+        value_type(value_type&&) = default;
+
+        /// Copy assignment
+        value_type& operator=(value_type const&) = default;
+
+        /// Move assignment
+        value_type& operator=(value_type&&) = default;
+
+        /** Constructor
+
+            The string is moved into newly allocated shared
+            storage.
+        */
+        explicit
+        value_type(std::string s)
+            : value_type(std::make_shared<
+                std::string const>(std::move(s)))
+        {
+        }
+
+        /** Constructor
+
+            The body refers to the contents of the shared string.
+        */
+        value_type(std::shared_ptr<std::string const> s)
+            : owner_(s)
+            , buffer_(s ? net::const_buffer(
+                s->data(), s->size()) : net::const_buffer())
+        {
+        }
+
+        /** Constructor
+
+            The body refers to the memory represented by `buffer`,
+            which must remain valid for as long as `owner` (or any
+            copy of it) is alive.
+
+            @param owner A shared pointer which keeps the memory
+            referenced by `buffer` alive.
+
+            @param buffer The memory holding the body octets.
+        */
+        template<class T>
+        value_type(
+            std::shared_ptr<T> owner,
+            net::const_buffer buffer)
+            : owner_(std::move(owner))
+            , buffer_(buffer)
+        {
+        }
+
+        /// Returns a buffer representing the body octets
+        net::const_buffer
+        buffer() const noexcept
+        {
+            return buffer_;
+        }
+
+        /// Returns a pointer to the beginning of the body octets
+        char const*
+        data() const noexcept
+        {
+            return static_cast<char const*>(buffer_.data());
+        }
+
+        /// Returns the number of octets in the body
+        std::size_t
+        size() const noexcept
+        {
+            return buffer_.size();
+        }
+
+        /// Returns `true` if the body is empty
+        bool
+        empty() const noexcept
+        {
+            return buffer_.size() == 0;
+        }
+
+        /// Returns the body octets as a string view
+        string_view
+        view() const noexcept
+        {
+            return {data(), size()};
+        }
+
+        /// Returns the object keeping the storage alive, if any
+        std::shared_ptr<void const> const&
+        owner() const noexcept
+        {
+            return owner_;
+        }
+
+        /// Release the reference to the shared storage
+        void
+        clear() noexcept
+        {
+            owner_.reset();
+            buffer_ = {};
+        }
+    };
+
+    /** Returns the payload size of the body
+
+        When this body is used with @ref message::prepare_payload,
+        the Content-Length will be set to the payload size, and
+        any chunked Transfer-Encoding will be removed.
+    */
+    static
+    std::uint64_t
+    size(value_type const& body)
+    {
+        return body.size();
+    }
+
+    /** The algorithm for parsing the body
+
+        Meets the requirements of <em>BodyReader</em>.
+    */
+#if BOOST_BEAST_DOXYGEN
+    using reader = __implementation_defined__;
+#else
+    class reader
+    {
+        value_type& body_;
+        std::string s_;
+
+    public:
+        template<bool isRequest, class Fields>
+        explicit
+        reader(header<isRequest, Fields>&, value_type& b)
+            : body_(b)
+        {
+        }
+
+        void
+        init(boost::optional<
+            std::uint64_t> const& length, error_code& ec)
+        {
+            if(length)
+            {
+                if(*length > s_.max_size())
+                {
+                    ec = error::buffer_overflow;
+                    return;
+                }
+                s_.reserve(beast::detail::clamp(*length));
+            }
+            ec = {};
+        }
+
+        template<class ConstBufferSequence>
+        std::size_t
+        put(ConstBufferSequence const& buffers,
+            error_code& ec)
+        {
+            auto const extra = buffer_bytes(buffers);
+            auto const size = s_.size();
+            if(extra > s_.max_size() - size)
+            {
+                ec = error::buffer_overflow;
+                return 0;
+            }
+            s_.resize(size + extra);
+            ec = {};
+            char* dest = &s_[size];
+            for(auto b : beast::buffers_range_ref(buffers))
+            {
+                std::char_traits<char>::copy(dest,
+                    static_cast<char const*>(b.data()), b.size());
+                dest += b.size();
+            }
+            return extra;
+        }
+
+        void
+        finish(error_code& ec)
+        {
+            body_ = value_type(std::move(s_));
+            ec = {};
+        }
+    };
+#endif
+
+    /** The algorithm for serializing the body
+
+        Meets the requirements of <em>BodyWriter</em>.
+
+        The buffers returned by the writer refer directly to
+        the shared storage; no copies are made.
+    */
+#if BOOST_BEAST_DOXYGEN
+    using writer = __implementation_defined__;
+#else
+    class writer
+    {
+        value_type const& body_;
+
+    public:
+        using const_buffers_type =
+            net::const_buffer;
+
+        template<bool isRequest, class Fields>
+        explicit
+        writer(header<isRequest, Fields> const&, value_type const& b)
+            : body_(b)
+        {
+        }
+
+        void
+        init(error_code& ec)
+        {
+            ec = {};
+        }
+
+        boost::optional<std::pair<const_buffers_type, bool>>
+        get(error_code& ec)
+        {
+            ec = {};
+            return {{body_.buffer(), false}};
+        }
+    };
+#endif
+};
+
+} // http
+} // beast
+} // boost
+
+#endif
@@ -31,6 +31,8 @@ the program, with the macro BOOST_BEAST_SEPARATE_COMPILATION defined.
 #include <boost/beast/_experimental/test/detail/stream_state.ipp>
 
 #include <boost/beast/core/detail/base64.ipp>
+#include <boost/beast/core/detail/impl/block_cache.ipp>
+#include <boost/beast/core/detail/impl/proxy_protocol.ipp>
 #include <boost/beast/core/detail/sha1.ipp>
 #include <boost/beast/core/detail/impl/temporary_buffer.ipp>
 #include <boost/beast/core/impl/error.ipp>
@@ -38,13 +40,16 @@ the program, with the macro BOOST_BEAST_SEPARATE_COMPILATION defined.
 #include <boost/beast/core/impl/file_stdio.ipp>
 #include <boost/beast/core/impl/file_win32.ipp>
 #include <boost/beast/core/impl/flat_static_buffer.ipp>
+#include <boost/beast/core/impl/rate_policy.ipp>
 #include <boost/beast/core/impl/saved_handler.ipp>
 #include <boost/beast/core/impl/static_buffer.ipp>
 #include <boost/beast/core/impl/string.ipp>
+#include <boost/beast/core/impl/timeout_service.ipp>
 
 #include <boost/beast/http/detail/basic_parser.ipp>
 #include <boost/beast/http/detail/rfc7230.ipp>
 #include <boost/beast/http/impl/basic_parser.ipp>
+#include <boost/beast/http/impl/content_coding.ipp>
 #include <boost/beast/http/impl/error.ipp>
 #include <boost/beast/http/impl/field.ipp>
 #include <boost/beast/http/impl/fields.ipp>
@@ -52,14 +57,18 @@ the program, with the macro BOOST_BEAST_SEPARATE_COMPILATION defined.
 #include <boost/beast/http/impl/status.ipp>
 #include <boost/beast/http/impl/verb.ipp>
 
+#include <boost/beast/websocket/detail/deflate_cache.ipp>
 #include <boost/beast/websocket/detail/hybi13.ipp>
 #include <boost/beast/websocket/detail/mask.ipp>
 #include <boost/beast/websocket/detail/pmd_extension.ipp>
 #include <boost/beast/websocket/detail/prng.ipp>
 #include <boost/beast/websocket/detail/service.ipp>
 #include <boost/beast/websocket/detail/utf8_checker.ipp>
+#include <boost/beast/websocket/detail/zlib_pool.ipp>
 #include <boost/beast/websocket/impl/error.ipp>
+#include <boost/beast/websocket/impl/prepared_message.ipp>
 
+#include <boost/beast/zlib/detail/checksum.ipp>
 #include <boost/beast/zlib/detail/deflate_stream.ipp>
 #include <boost/beast/zlib/detail/inflate_stream.ipp>
 #include <boost/beast/zlib/impl/error.ipp>
@@ -0,0 +1,533 @@
+//
+// Copyright (c) 2016-2019 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/boostorg/beast
+//
+
+#ifndef BOOST_BEAST_SSL_DETAIL_KTLS_HPP
+#define BOOST_BEAST_SSL_DETAIL_KTLS_HPP
+
+#include <boost/beast/core/detail/config.hpp>
+#include <boost/beast/core/async_base.hpp>
+#include <boost/beast/core/bind_handler.hpp>
+#include <boost/beast/core/error.hpp>
+#include <boost/beast/core/stream_traits.hpp>
+#include <boost/asio/error.hpp>
+#include <boost/asio/post.hpp>
+#include <boost/asio/socket_base.hpp>
+#include <boost/asio/ssl/detail/openssl_types.hpp>
+#include <cstddef>
+#include <cstring>
+#include <utility>
+
+/*  Linux kernel TLS
+
+    Defining BOOST_BEAST_NO_KTLS removes support
+    even where the platform provides it.
+*/
+#ifndef BOOST_BEAST_HAS_KTLS
+# if ! defined(BOOST_BEAST_NO_KTLS) && defined(__linux__) && \
+    defined(__has_include) && OPENSSL_VERSION_NUMBER >= 0x10101000L
+#  if __has_include(<linux/tls.h>)
+#   define BOOST_BEAST_HAS_KTLS 1
+#  endif
+# endif
+#endif
+#ifndef BOOST_BEAST_HAS_KTLS
+# define BOOST_BEAST_HAS_KTLS 0
+#endif
+
+#if BOOST_BEAST_HAS_KTLS
+#include <openssl/kdf.h>
+#include <linux/tls.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <cerrno>
+#ifndef SOL_TLS
+# define SOL_TLS 282
+#endif
+#ifndef TCP_ULP
+# define TCP_ULP 31
+#endif
+#endif
+
+namespace boost {
+namespace beast {
+namespace detail {
+
+// Returns the file descriptor of the socket
+// at the bottom of a stack of layers, or -1.
+
+template<class Stream>
+auto
+ktls_native_handle_impl(Stream& s, int) ->
+    decltype(static_cast<int>(s.native_handle()))
+{
+    return static_cast<int>(s.native_handle());
+}
+
+template<class Stream>
+auto
+ktls_native_handle_impl(Stream& s, long) ->
+    decltype(static_cast<int>(s.socket().native_handle()))
+{
+    return static_cast<int>(s.socket().native_handle());
+}
+
+template<class Stream>
+int
+ktls_native_handle_impl(Stream&, ...)
+{
+    return -1;
+}
+
+template<class Stream>
+int
+ktls_native_handle(Stream& s)
+{
+    return ktls_native_handle_impl(s, 0);
+}
+
+// Returns `true` if the socket at the bottom
+// of a stack of layers is in blocking mode.
+
+template<class Stream>
+auto
+ktls_blocking_impl(Stream& s, int) ->
+    decltype(! s.non_blocking())
+{
+    return ! s.non_blocking();
+}
+
+template<class Stream>
+auto
+ktls_blocking_impl(Stream& s, long) ->
+    decltype(! s.socket().non_blocking())
+{
+    return ! s.socket().non_blocking();
+}
+
+template<class Stream>
+bool
+ktls_blocking_impl(Stream&, ...)
+{
+    return false;
+}
+
+template<class Stream>
+bool
+ktls_blocking(Stream& s)
+{
+    return ktls_blocking_impl(s, 0);
+}
+
+// Wait until the socket at the bottom of
+// a stack of layers is ready for writing.
+
+template<class Stream, class Handler>
+auto
+ktls_async_wait_write_impl(Stream& s, Handler&& h, int) ->
+    decltype(s.async_wait(
+        net::socket_base::wait_write, std::forward<Handler>(h)))
+{
+    return s.async_wait(
+        net::socket_base::wait_write, std::forward<Handler>(h));
+}
+
+template<class Stream, class Handler>
+auto
+ktls_async_wait_write_impl(Stream& s, Handler&& h, long) ->
+    decltype(s.socket().async_wait(
+        net::socket_base::wait_write, std::forward<Handler>(h)))
+{
+    return s.socket().async_wait(
+        net::socket_base::wait_write, std::forward<Handler>(h));
+}
+
+template<class Stream, class Handler>
+void
+ktls_async_wait_write_impl(Stream& s, Handler&& h, ...)
+{
+    net::post(s.get_executor(), beast::bind_front_handler(
+        std::forward<Handler>(h),
+        net::error::operation_not_supported));
+}
+
+template<class Stream, class Handler>
+void
+ktls_async_wait_write(Stream& s, Handler&& h)
+{
+    ktls_async_wait_write_impl(s, std::forward<Handler>(h), 0);
+}
+
+#if BOOST_BEAST_HAS_KTLS
+
+// The kernel parameters for one direction of a connection
+struct ktls_crypto_info
+{
+    union
+    {
+        tls_crypto_info info;
+        tls12_crypto_info_aes_gcm_128 aes_gcm_128;
+        tls12_crypto_info_aes_gcm_256 aes_gcm_256;
+    };
+    std::size_t size;
+};
+
+/*  Compute the kernel parameters for one direction of an
+    established TLS 1.2 connection using AES-GCM.
+
+    The key block is expanded from the master secret as in
+    RFC 5246 section 6.3. With AEAD ciphers it holds no MAC
+    keys, only the client and server write keys followed
+    by the client and server implicit IVs. The Finished
+    message was the first record under these keys, so the
+    next record in each direction has sequence number 1.
+    Explicit GCM nonces are taken from the sequence number.
+
+    OpenSSL does not expose the TLS 1.3 traffic secrets,
+    so those connections are not supported.
+*/
+inline
+bool
+ktls_get_crypto_info(
+    SSL* ssl, bool tx, ktls_crypto_info& ci)
+{
+    std::memset(&ci, 0, sizeof(ci));
+    if( SSL_version(ssl) != TLS1_2_VERSION ||
+        ! SSL_is_init_finished(ssl))
+        return false;
+    SSL_CIPHER const* const cipher =
+        SSL_get_current_cipher(ssl);
+    if(! cipher)
+        return false;
+    std::size_t key_len;
+    std::size_t iv_len;
+    switch(SSL_CIPHER_get_cipher_nid(cipher))
+    {
+    case NID_aes_128_gcm:
+        key_len = TLS_CIPHER_AES_GCM_128_KEY_SIZE;
+        iv_len = TLS_CIPHER_AES_GCM_128_SALT_SIZE;
+        ci.info.cipher_type = TLS_CIPHER_AES_GCM_128;
+        ci.size = sizeof(ci.aes_gcm_128);
+        break;
+
+    case NID_aes_256_gcm:
+        key_len = TLS_CIPHER_AES_GCM_256_KEY_SIZE;
+        iv_len = TLS_CIPHER_AES_GCM_256_SALT_SIZE;
+        ci.info.cipher_type = TLS_CIPHER_AES_GCM_256;
+        ci.size = sizeof(ci.aes_gcm_256);
+        break;
+
+    default:
+        return false;
+    }
+    ci.info.version = TLS_1_2_VERSION;
+
+    EVP_MD const* const md =
+        SSL_CIPHER_get_handshake_digest(cipher);
+    SSL_SESSION const* const session = SSL_get_session(ssl);
+    if(! md || ! session)
+        return false;
+
+    unsigned char master[SSL_MAX_MASTER_KEY_LENGTH];
+    unsigned char randoms[2 * SSL3_RANDOM_SIZE];
+    unsigned char block[2 * 32 + 2 * 4];
+    std::size_t const block_len = 2 * key_len + 2 * iv_len;
+    auto const master_len = SSL_SESSION_get_master_key(
+        session, master, sizeof(master));
+    SSL_get_server_random(ssl, randoms, SSL3_RANDOM_SIZE);
+    SSL_get_client_random(ssl,
+        randoms + SSL3_RANDOM_SIZE, SSL3_RANDOM_SIZE);
+
+    bool ok = false;
+    EVP_PKEY_CTX* const pctx =
+        EVP_PKEY_CTX_new_id(EVP_PKEY_TLS1_PRF, nullptr);
+    if(pctx)
+    {
+        std::size_t n = block_len;
+        ok =
+            EVP_PKEY_derive_init(pctx) > 0 &&
+            EVP_PKEY_CTX_set_tls1_prf_md(pctx, md) > 0 &&
+            EVP_PKEY_CTX_set1_tls1_prf_secret(pctx,
+                master, static_cast<int>(master_len)) > 0 &&
+            EVP_PKEY_CTX_add1_tls1_prf_seed(pctx,
+                reinterpret_cast<unsigned char const*>(
+                    "key expansion"), 13) > 0 &&
+            EVP_PKEY_CTX_add1_tls1_prf_seed(pctx,
+                randoms, static_cast<int>(sizeof(randoms))) > 0 &&
+            EVP_PKEY_derive(pctx, block, &n) > 0 &&
+            n == block_len;
+        EVP_PKEY_CTX_free(pctx);
+    }
+    OPENSSL_cleanse(master, sizeof(master));
+    if(! ok)
+    {
+        OPENSSL_cleanse(block, sizeof(block));
+        return false;
+    }
+
+    // client write key, server write key,
+    // client write IV, server write IV
+    bool const server = (SSL_is_server(ssl) != 0) == tx;
+    unsigned char const* const key =
+        block + (server ? key_len : 0);
+    unsigned char const* const iv =
+        block + 2 * key_len + (server ? iv_len : 0);
+    unsigned char const seq[8] = { 0, 0, 0, 0, 0, 0, 0, 1 };
+    switch(ci.info.cipher_type)
+    {
+    case TLS_CIPHER_AES_GCM_128:
+        std::memcpy(ci.aes_gcm_128.key, key, key_len);
+        std::memcpy(ci.aes_gcm_128.salt, iv, iv_len);
+        std::memcpy(ci.aes_gcm_128.iv, seq, sizeof(seq));
+        std::memcpy(ci.aes_gcm_128.rec_seq, seq, sizeof(seq));
+        break;
+
+    case TLS_CIPHER_AES_GCM_256:
+        std::memcpy(ci.aes_gcm_256.key, key, key_len);
+        std::memcpy(ci.aes_gcm_256.salt, iv, iv_len);
+        std::memcpy(ci.aes_gcm_256.iv, seq, sizeof(seq));
+        std::memcpy(ci.aes_gcm_256.rec_seq, seq, sizeof(seq));
+        break;
+    }
+    OPENSSL_cleanse(block, sizeof(block));
+    return true;
+}
+
+// Install the keys of an established connection into the
+// kernel. On failure, the connection is unchanged unless
+// the transmit keys were installed and the receive keys
+// were rejected, which leaves it unusable.
+inline
+void
+ktls_enable(SSL* ssl, int fd, bool& tx, error_code& ec)
+{
+    tx = false;
+    // Bytes already taken from the socket, or not yet
+    // given to it, belong to the user space session.
+    if( fd == -1 ||
+        SSL_has_pending(ssl) ||
+        BIO_ctrl_pending(SSL_get_rbio(ssl)) != 0 ||
+        BIO_ctrl_wpending(SSL_get_wbio(ssl)) != 0)
+    {
+        ec = net::error::operation_not_supported;
+        return;
+    }
+    ktls_crypto_info ci[2];
+    if( ! ktls_get_crypto_info(ssl, true, ci[0]) ||
+        ! ktls_get_crypto_info(ssl, false, ci[1]))
+        ec = net::error::operation_not_supported;
+    else if(
+        ::setsockopt(fd, SOL_TCP, TCP_ULP, "tls", 4) != 0 ||
+        ::setsockopt(fd, SOL_TLS, TLS_TX, &ci[0].info,
+            static_cast<socklen_t>(ci[0].size)) != 0)
+        ec.assign(errno, system_category());
+    else if((tx = true), ::setsockopt(fd, SOL_TLS, TLS_RX,
+            &ci[1].info, static_cast<socklen_t>(ci[1].size)) != 0)
+        ec.assign(errno, system_category());
+    else
+        ec = {};
+    OPENSSL_cleanse(ci, sizeof(ci));
+}
+
+// Send a close_notify alert through the kernel. Unless
+// `block` is set, fails with would_block when there is no
+// room in the send buffer.
+inline
+void
+ktls_close_notify(int fd, bool block, error_code& ec)
+{
+    // warning, close_notify
+    unsigned char alert[2] = { 1, 0 };
+    char control[CMSG_SPACE(sizeof(unsigned char))] = {};
+    iovec iov;
+    iov.iov_base = alert;
+    iov.iov_len = sizeof(alert);
+    msghdr msg = {};
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    msg.msg_control = control;
+    msg.msg_controllen = sizeof(control);
+    cmsghdr* const cmsg = CMSG_FIRSTHDR(&msg);
+    cmsg->cmsg_level = SOL_TLS;
+    cmsg->cmsg_type = TLS_SET_RECORD_TYPE;
+    cmsg->cmsg_len = CMSG_LEN(sizeof(unsigned char));
+    // alert
+    *CMSG_DATA(cmsg) = 21;
+    for(;;)
+    {
+        if(::sendmsg(fd, &msg, block ?
+            MSG_NOSIGNAL : MSG_DONTWAIT | MSG_NOSIGNAL) >= 0)
+        {
+            ec = {};
+            return;
+        }
+        ec.assign(errno, system_category());
+        if(ec == net::error::interrupted)
+            continue;
+        if(! block || ec != net::error::would_block)
+            return;
+        // The descriptor is non-blocking for
+        // asynchronous operations, so poll
+        pollfd pfd = {};
+        pfd.fd = fd;
+        pfd.events = POLLOUT;
+        if( ::poll(&pfd, 1, -1) < 0 &&
+            errno != EINTR)
+        {
+            ec.assign(errno, system_category());
+            return;
+        }
+    }
+}
+
+// Called when a read fails with EIO, which means the next
+// record is not application data. A close_notify alert
+// becomes end of file, anything else is unsupported.
+inline
+void
+ktls_read_error(int fd, error_code& ec)
+{
+    if(ec != errc::io_error)
+        return;
+    unsigned char buf[2];
+    char control[CMSG_SPACE(sizeof(unsigned char))] = {};
+    iovec iov;
+    iov.iov_base = buf;
+    iov.iov_len = sizeof(buf);
+    msghdr msg = {};
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    msg.msg_control = control;
+    msg.msg_controllen = sizeof(control);
+    auto const n = ::recvmsg(fd, &msg, MSG_DONTWAIT);
+    if(n < 0)
+    {
+        ec.assign(errno, system_category());
+        return;
+    }
+    cmsghdr* const cmsg = CMSG_FIRSTHDR(&msg);
+    if( cmsg &&
+        cmsg->cmsg_level == SOL_TLS &&
+        cmsg->cmsg_type == TLS_GET_RECORD_TYPE &&
+        *CMSG_DATA(cmsg) == 21 &&
+        n == 2 && buf[1] == 0)
+        ec = net::error::eof;
+    else
+        ec = net::error::operation_not_supported;
+}
+
+#else
+
+inline
+void
+ktls_enable(SSL*, int, bool& tx, error_code& ec)
+{
+    tx = false;
+    ec = net::error::operation_not_supported;
+}
+
+inline
+void
+ktls_close_notify(int, bool, error_code& ec)
+{
+    ec = net::error::operation_not_supported;
+}
+
+inline
+void
+ktls_read_error(int, error_code&)
+{
+}
+
+#endif
+
+template<class Handler, class Stream>
+class ktls_read_op
+    : public async_base<Handler, beast::executor_type<Stream>>
+{
+    int fd_;
+
+public:
+    template<class Handler_, class Buffers>
+    ktls_read_op(
+        Handler_&& h,
+        Stream& s,
+        Buffers const& b)
+        : async_base<Handler, beast::executor_type<Stream>>(
+            std::forward<Handler_>(h), s.get_executor())
+        , fd_(ktls_native_handle(s))
+    {
+        BOOST_ASIO_HANDLER_LOCATION((
+            __FILE__, __LINE__,
+            "ssl_stream::async_read_some"));
+
+        s.async_read_some(b, std::move(*this));
+    }
+
+    void
+    operator()(
+        error_code ec,
+        std::size_t bytes_transferred)
+    {
+        if(ec)
+            ktls_read_error(fd_, ec);
+        this->complete_now(ec, bytes_transferred);
+    }
+};
+
+// Send a close_notify alert through the kernel,
+// waiting for room in the send buffer if needed
+template<class Handler, class Stream>
+class ktls_shutdown_op
+    : public async_base<Handler, beast::executor_type<Stream>>
+{
+    Stream& s_;
+    int fd_;
+
+public:
+    template<class Handler_>
+    ktls_shutdown_op(
+        Handler_&& h,
+        Stream& s)
+        : async_base<Handler, beast::executor_type<Stream>>(
+            std::forward<Handler_>(h), s.get_executor())
+        , s_(s)
+        , fd_(ktls_native_handle(s))
+    {
+        (*this)({}, false);
+    }
+
+    void
+    operator()(
+        error_code ec,
+        bool cont = true)
+    {
+        if(! ec)
+        {
+            ktls_close_notify(fd_, false, ec);
+            if(ec == net::error::would_block)
+            {
+                BOOST_ASIO_HANDLER_LOCATION((
+                    __FILE__, __LINE__,
+                    "ssl_stream::async_shutdown"));
+
+                return ktls_async_wait_write(
+                    s_, std::move(*this));
+            }
+        }
+        this->complete(cont, ec);
+    }
+};
+
+} // detail
+} // beast
+} // boost
+
+#endif
@@ -15,13 +15,17 @@
 // This include is necessary to work with `ssl::stream` and `boost::beast::websocket::stream`
 #include <boost/beast/websocket/ssl.hpp>
 
+#include <boost/beast/core/bind_handler.hpp>
 #include <boost/beast/core/flat_stream.hpp>
+#include <boost/beast/ssl/detail/ktls.hpp>
 
 // VFALCO We include this because anyone who uses ssl will
 //        very likely need to check for ssl::error::stream_truncated
 #include <boost/asio/ssl/error.hpp>
 
+#include <boost/asio/post.hpp>
 #include <boost/asio/ssl/stream.hpp>
+#include <boost/throw_exception.hpp>
 #include <cstddef>
 #include <memory>
 #include <type_traits>
@@ -62,6 +66,9 @@ namespace beast {
         limitation of `net::ssl::stream` when writing buffer sequences
         having length greater than one.
 
+    @li Optionally hands record encryption to the operating system
+        after the handshake. See @ref enable_ktls.
+
     @par Concepts:
         @li AsyncReadStream
         @li AsyncWriteStream
@@ -77,6 +84,70 @@ class ssl_stream
     using stream_type = boost::beast::flat_stream<ssl_stream_type>;
 
     std::unique_ptr<stream_type> p_;
+    bool ktls_ = false;
+
+    // The initiations choose between OpenSSL
+    // and the socket when the operation starts.
+
+    struct run_shutdown_op
+    {
+        ssl_stream* self;
+
+        template<class ShutdownHandler>
+        void
+        operator()(ShutdownHandler&& h)
+        {
+            if(! self->ktls_)
+                return self->p_->next_layer().async_shutdown(
+                    std::forward<ShutdownHandler>(h));
+            detail::ktls_shutdown_op<
+                typename std::decay<ShutdownHandler>::type,
+                next_layer_type>(
+                    std::forward<ShutdownHandler>(h),
+                    self->next_layer());
+        }
+    };
+
+    struct run_write_some_op
+    {
+        ssl_stream* self;
+
+        template<class WriteHandler, class ConstBufferSequence>
+        void
+        operator()(
+            WriteHandler&& h,
+            ConstBufferSequence const& buffers)
+        {
+            if(self->ktls_)
+                self->next_layer().async_write_some(
+                    buffers, std::forward<WriteHandler>(h));
+            else
+                self->p_->async_write_some(
+                    buffers, std::forward<WriteHandler>(h));
+        }
+    };
+
+    struct run_read_some_op
+    {
+        ssl_stream* self;
+
+        template<class ReadHandler, class MutableBufferSequence>
+        void
+        operator()(
+            ReadHandler&& h,
+            MutableBufferSequence const& buffers)
+        {
+            if(self->ktls_)
+                detail::ktls_read_op<
+                    typename std::decay<ReadHandler>::type,
+                    next_layer_type>(
+                        std::forward<ReadHandler>(h),
+                        self->next_layer(), buffers);
+            else
+                self->p_->async_read_some(
+                    buffers, std::forward<ReadHandler>(h));
+        }
+    };
 
 public:
     /// The native handle type of the SSL stream.
@@ -187,6 +258,80 @@ public:
         return p_->next_layer().next_layer();
     }
 
+    /** Set the largest number of bytes flattened by a write.
+
+        Writes of buffer sequences are combined into a single TLS
+        record of up to this many bytes before encryption.
+
+        @see flat_stream::coalesce_limit
+    */
+    void
+    coalesce_limit(std::size_t n) noexcept
+    {
+        p_->coalesce_limit(n);
+    }
+
+    /// Returns the largest number of bytes flattened by a write.
+    std::size_t
+    coalesce_limit() const noexcept
+    {
+        return p_->coalesce_limit();
+    }
+
+    /** Hand the encryption of records to the kernel.
+
+        This function installs the keys negotiated by the handshake into
+        the Linux kernel TLS layer of the underlying socket. Afterwards,
+        reads and writes on this stream go directly to the socket: the
+        kernel encrypts outgoing records and decrypts incoming ones, and
+        no data is copied through OpenSSL. Because the socket itself now
+        speaks TLS, plaintext written to it by other means, for example
+        with `sendfile` on the handle returned by
+        `next_layer().native_handle()`, is sent encrypted.
+
+        The call is opt-in and must be made after a successful handshake
+        and before any other operation on the stream. It requires:
+
+        @li A connection using TLS 1.2 with an AES-GCM cipher. OpenSSL
+            does not expose the secrets of a TLS 1.3 connection, so
+            these are not supported,
+
+        @li A next layer from which the socket can be obtained, such as
+            `net::ip::tcp::socket` or @ref tcp_stream, and
+
+        @li A kernel with the `tls` module loaded.
+
+        When any of these is missing, or the handshake left received bytes
+        buffered in OpenSSL, the error is returned and the stream continues
+        to operate through OpenSSL as before. Failures are reported with
+        `net::error::operation_not_supported`, or the error from the kernel.
+
+        Once enabled, renegotiation and key updates are not possible, and a
+        record other than application data or a close_notify alert fails
+        the read with `net::error::operation_not_supported`. A close_notify
+        from the peer is reported as `net::error::eof`.
+
+        @param ec Set to indicate what error occurred, if any. If the kernel
+        accepted the keys for sending but rejected them for receiving, the
+        error is returned and @ref ktls returns `true`; the connection can
+        only be closed.
+    */
+    void
+    enable_ktls(error_code& ec)
+    {
+        bool tx;
+        detail::ktls_enable(native_handle(),
+            detail::ktls_native_handle(next_layer()), tx, ec);
+        ktls_ = tx;
+    }
+
+    /// Returns `true` if records are encrypted by the kernel.
+    bool
+    ktls() const noexcept
+    {
+        return ktls_;
+    }
+
     /** Set the peer verification mode.
 
         This function may be used to configure the peer verification mode used by
@@ -449,7 +594,10 @@ public:
     void
     shutdown()
     {
-        p_->next_layer().shutdown();
+        error_code ec;
+        shutdown(ec);
+        if(ec)
+            BOOST_THROW_EXCEPTION(system_error{ec});
     }
 
     /** Shut down SSL on the stream.
@@ -462,6 +610,10 @@ public:
     void
     shutdown(boost::system::error_code& ec)
     {
+        if(ktls_)
+            return detail::ktls_close_notify(
+                detail::ktls_native_handle(next_layer()),
+                detail::ktls_blocking(next_layer()), ec);
         p_->next_layer().shutdown(ec);
     }
 
@@ -481,8 +633,11 @@ public:
     BOOST_ASIO_INITFN_RESULT_TYPE(ShutdownHandler, void(boost::system::error_code))
     async_shutdown(BOOST_ASIO_MOVE_ARG(ShutdownHandler) handler)
     {
-        return p_->next_layer().async_shutdown(
-            BOOST_ASIO_MOVE_CAST(ShutdownHandler)(handler));
+        return net::async_initiate<
+            ShutdownHandler,
+            void(boost::system::error_code)>(
+                run_shutdown_op{this},
+                handler);
     }
 
     /** Write some data to the stream.
@@ -505,6 +660,8 @@ public:
     std::size_t
     write_some(ConstBufferSequence const& buffers)
     {
+        if(ktls_)
+            return next_layer().write_some(buffers);
         return p_->write_some(buffers);
     }
 
@@ -529,6 +686,8 @@ public:
     write_some(ConstBufferSequence const& buffers,
         boost::system::error_code& ec)
     {
+        if(ktls_)
+            return next_layer().write_some(buffers, ec);
         return p_->write_some(buffers, ec);
     }
 
@@ -560,8 +719,12 @@ public:
     async_write_some(ConstBufferSequence const& buffers,
         BOOST_ASIO_MOVE_ARG(WriteHandler) handler)
     {
-        return p_->async_write_some(buffers,
-            BOOST_ASIO_MOVE_CAST(WriteHandler)(handler));
+        return net::async_initiate<
+            WriteHandler,
+            void(boost::system::error_code, std::size_t)>(
+                run_write_some_op{this},
+                handler,
+                buffers);
     }
 
     /** Read some data from the stream.
@@ -585,7 +748,11 @@ public:
     std::size_t
     read_some(MutableBufferSequence const& buffers)
     {
-        return p_->read_some(buffers);
+        error_code ec;
+        auto const n = read_some(buffers, ec);
+        if(ec)
+            BOOST_THROW_EXCEPTION(system_error{ec});
+        return n;
     }
 
     /** Read some data from the stream.
@@ -610,7 +777,13 @@ public:
     read_some(MutableBufferSequence const& buffers,
         boost::system::error_code& ec)
     {
-        return p_->read_some(buffers, ec);
+        if(! ktls_)
+            return p_->read_some(buffers, ec);
+        auto const n = next_layer().read_some(buffers, ec);
+        if(ec)
+            detail::ktls_read_error(
+                detail::ktls_native_handle(next_layer()), ec);
+        return n;
     }
 
     /** Start an asynchronous read.
@@ -641,8 +814,12 @@ public:
     async_read_some(MutableBufferSequence const& buffers,
         BOOST_ASIO_MOVE_ARG(ReadHandler) handler)
     {
-        return p_->async_read_some(buffers,
-            BOOST_ASIO_MOVE_CAST(ReadHandler)(handler));
+        return net::async_initiate<
+            ReadHandler,
+            void(boost::system::error_code, std::size_t)>(
+                run_read_some_op{this},
+                handler,
+                buffers);
     }
 
     // These hooks are used to inform boost::beast::websocket::stream on
@@ -675,11 +852,64 @@ teardown(
     ssl_stream<SyncStream>& stream,
     boost::system::error_code& ec)
 {
-    // Just forward it to the underlying ssl::stream
     using boost::beast::websocket::teardown;
-    teardown(role, *stream.p_, ec);
+    if(! stream.ktls_)
+    {
+        // Just forward it to the underlying ssl::stream
+        teardown(role, *stream.p_, ec);
+        return;
+    }
+    stream.shutdown(ec);
+    error_code ec2;
+    teardown(role, stream.next_layer(), ec ? ec2 : ec);
 }
 
+namespace detail {
+
+// Send a close_notify alert through the kernel,
+// then tear down the next layer
+template<class Handler, class Stream>
+class ktls_teardown_op
+    : public async_base<Handler, beast::executor_type<Stream>>
+{
+    Stream& s_;
+    role_type role_;
+    error_code ec_;
+    bool shutdown_ = true;
+
+public:
+    template<class Handler_>
+    ktls_teardown_op(
+        Handler_&& h,
+        Stream& s,
+        role_type role)
+        : async_base<Handler, beast::executor_type<Stream>>(
+            std::forward<Handler_>(h), s.get_executor())
+        , s_(s)
+        , role_(role)
+    {
+        ktls_shutdown_op<ktls_teardown_op, Stream>(
+            std::move(*this), s_);
+    }
+
+    void
+    operator()(error_code ec)
+    {
+        if(shutdown_)
+        {
+            shutdown_ = false;
+            ec_ = ec;
+            using boost::beast::websocket::async_teardown;
+            return async_teardown(role_, s_, std::move(*this));
+        }
+        // The connection is torn down either way, report
+        // a failure to send the close_notify first.
+        this->complete_now(ec_ ? ec_ : ec);
+    }
+};
+
+} // detail
+
 template<class AsyncStream, class TeardownHandler>
 void
 async_teardown(
@@ -687,10 +917,19 @@ async_teardown(
     ssl_stream<AsyncStream>& stream,
     TeardownHandler&& handler)
 {
-    // Just forward it to the underlying ssl::stream
     using boost::beast::websocket::async_teardown;
-    async_teardown(role, *stream.p_,
-        std::forward<TeardownHandler>(handler));
+    if(! stream.ktls_)
+    {
+        // Just forward it to the underlying ssl::stream
+        async_teardown(role, *stream.p_,
+            std::forward<TeardownHandler>(handler));
+        return;
+    }
+    detail::ktls_teardown_op<
+        typename std::decay<TeardownHandler>::type,
+        AsyncStream>(
+            std::forward<TeardownHandler>(handler),
+            stream.next_layer(), role);
 }
 #endif
 
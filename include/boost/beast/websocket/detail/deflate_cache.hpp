@@ -0,0 +1,83 @@
+//
+// Copyright (c) 2016-2019 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/boostorg/beast
+//
+
+#ifndef BOOST_BEAST_WEBSOCKET_DETAIL_DEFLATE_CACHE_HPP
+#define BOOST_BEAST_WEBSOCKET_DETAIL_DEFLATE_CACHE_HPP
+
+#include <boost/beast/core/detail/config.hpp>
+#include <boost/shared_ptr.hpp>
+#include <cstddef>
+#include <string>
+
+namespace boost {
+namespace beast {
+namespace websocket {
+namespace detail {
+
+// The most recent message compressed by a stream without
+// context takeover on the calling thread.
+//
+// Such a stream starts every message with a fresh
+// compressor, so its output depends only on the payload
+// and the compression settings. Streams sending the same
+// message to many peers find it here and send the stored
+// output instead of compressing the payload again.
+// Messages larger than max_size bytes are not kept. When
+// thread_local is unavailable, or during thread exit once
+// the entry of the thread is gone, nothing is kept.
+//
+struct deflate_cache
+{
+    static std::size_t constexpr max_size = 64 * 1024;
+
+    struct entry
+    {
+        int level;
+        int window_bits;
+        int mem_level;
+        std::string in;
+        std::string out;
+    };
+
+    // Returns the entry of the calling thread if it was
+    // compressed from size bytes with these settings.
+    BOOST_BEAST_DECL
+    static
+    boost::shared_ptr<entry const>
+    find(
+        int level,
+        int window_bits,
+        int mem_level,
+        std::size_t size);
+
+    // Returns an empty entry to record a message in,
+    // reusing the entry of the calling thread when no
+    // stream is sending it, or null if nothing is kept.
+    BOOST_BEAST_DECL
+    static
+    boost::shared_ptr<entry>
+    acquire();
+
+    // Replace the entry of the calling thread
+    BOOST_BEAST_DECL
+    static
+    void
+    insert(boost::shared_ptr<entry const> e);
+};
+
+} // detail
+} // websocket
+} // beast
+} // boost
+
+#ifdef BOOST_BEAST_HEADER_ONLY
+#include <boost/beast/websocket/detail/deflate_cache.ipp>
+#endif
+
+#endif
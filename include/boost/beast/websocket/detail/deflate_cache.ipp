@@ -0,0 +1,91 @@
+//
+// Copyright (c) 2016-2019 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/boostorg/beast
+//
+
+#ifndef BOOST_BEAST_WEBSOCKET_DETAIL_DEFLATE_CACHE_IPP
+#define BOOST_BEAST_WEBSOCKET_DETAIL_DEFLATE_CACHE_IPP
+
+#include <boost/beast/websocket/detail/deflate_cache.hpp>
+#include <boost/beast/core/detail/thread_local_instance.hpp>
+#include <boost/make_shared.hpp>
+#include <utility>
+
+namespace boost {
+namespace beast {
+namespace websocket {
+namespace detail {
+
+struct deflate_cache_storage
+{
+    boost::shared_ptr<deflate_cache::entry const> e;
+
+    static
+    deflate_cache_storage*
+    get() noexcept
+    {
+        return beast::detail::thread_local_instance<
+            deflate_cache_storage>();
+    }
+};
+
+boost::shared_ptr<deflate_cache::entry const>
+deflate_cache::
+find(
+    int level,
+    int window_bits,
+    int mem_level,
+    std::size_t size)
+{
+    auto const s = deflate_cache_storage::get();
+    if(! s)
+        return nullptr;
+    auto const& e = s->e;
+    if( e &&
+        e->level == level &&
+        e->window_bits == window_bits &&
+        e->mem_level == mem_level &&
+        e->in.size() == size)
+        return e;
+    return nullptr;
+}
+
+boost::shared_ptr<deflate_cache::entry>
+deflate_cache::
+acquire()
+{
+    auto const s = deflate_cache_storage::get();
+    if(! s)
+        return nullptr;
+    auto& e = s->e;
+    if(e && e.use_count() == 1)
+    {
+        // keep the storage of the strings
+        auto p = boost::const_pointer_cast<entry>(e);
+        e.reset();
+        p->in.clear();
+        p->out.clear();
+        return p;
+    }
+    return boost::make_shared<entry>();
+}
+
+void
+deflate_cache::
+insert(boost::shared_ptr<entry const> e)
+{
+    auto const s = deflate_cache_storage::get();
+    if(s)
+        s->e = std::move(e);
+}
+
+} // detail
+} // websocket
+} // beast
+} // boost
+
+#endif
@@ -11,8 +11,10 @@
 #define BOOST_BEAST_WEBSOCKET_DETAIL_IMPL_BASE_HPP
 
 #include <boost/beast/websocket/option.hpp>
+#include <boost/beast/websocket/detail/deflate_cache.hpp>
 #include <boost/beast/websocket/detail/frame.hpp>
 #include <boost/beast/websocket/detail/pmd_extension.hpp>
+#include <boost/beast/websocket/detail/zlib_pool.hpp>
 #include <boost/beast/core/buffer_traits.hpp>
 #include <boost/beast/core/role.hpp>
 #include <boost/beast/http/empty_body.hpp>
@@ -24,7 +26,9 @@
 #include <boost/beast/core/error.hpp>
 #include <boost/beast/core/detail/clamp.hpp>
 #include <boost/asio/buffer.hpp>
+#include <algorithm>
 #include <cstdint>
+#include <cstring>
 #include <memory>
 #include <stdexcept>
 
@@ -47,8 +51,67 @@ struct impl_base<true>
         // `true` if current read message is compressed
         bool rd_set = false;
 
-        zlib::deflate_stream zo;
-        zlib::inflate_stream zi;
+        // window size of the decompressor
+        int rd_window_bits = 0;
+
+        // `true` if the compressor keeps its window
+        // from one message to the next
+        bool wr_takeover = true;
+
+        // `true` if a message is being compressed
+        bool wr_busy = false;
+
+        // settings of the compressor
+        int wr_level = 0;
+        int wr_window_bits = 0;
+        int wr_mem_level = 0;
+
+        // the cached output being sent, and
+        // the number of bytes sent so far
+        boost::shared_ptr<deflate_cache::entry const> wr_hit;
+        std::size_t wr_pos = 0;
+
+        // Created on first use. Without context takeover
+        // these are taken from the zlib_pool for one message
+        // at a time, and are null in between.
+        std::unique_ptr<zlib::deflate_stream> zo;
+        std::unique_ptr<zlib::inflate_stream> zi;
+
+        pmd_type() = default;
+        pmd_type(pmd_type const&) = delete;
+        pmd_type& operator=(pmd_type const&) = delete;
+
+        ~pmd_type()
+        {
+            zlib_pool::release(std::move(zo));
+            zlib_pool::release(std::move(zi));
+        }
+
+        zlib::deflate_stream&
+        deflater()
+        {
+            if(! zo)
+            {
+                zo = zlib_pool::acquire_deflate();
+                zo->reset(
+                    wr_level,
+                    wr_window_bits,
+                    wr_mem_level,
+                    zlib::Strategy::normal);
+            }
+            return *zo;
+        }
+
+        zlib::inflate_stream&
+        inflater()
+        {
+            if(! zi)
+            {
+                zi = zlib_pool::acquire_inflate();
+                zi->reset(rd_window_bits);
+            }
+            return *zi;
+        }
     };
 
     std::unique_ptr<pmd_type>   pmd_;           // pmd settings or nullptr
@@ -88,7 +151,146 @@ struct impl_base<true>
         error_code& ec)
     {
         BOOST_ASSERT(out.size() >= 6);
-        auto& zo = this->pmd_->zo;
+        auto& pmd = *this->pmd_;
+        if(! pmd.wr_busy)
+        {
+            pmd.wr_busy = true;
+            // Without context takeover, a complete message
+            // compresses the same way on every stream with
+            // the same settings.
+            if(fin && ! pmd.wr_takeover)
+            {
+                deflate_cache_begin(cb, ec);
+                if(ec)
+                {
+                    pmd.wr_busy = false;
+                    return false;
+                }
+            }
+        }
+        if(pmd.wr_hit)
+            return deflate_cache_replay(out, cb, total_in);
+        auto const more = deflate_zlib(
+            out, cb, fin, total_in, ec);
+        if(! more)
+            pmd.wr_busy = false;
+        return more;
+    }
+
+    // Look up a complete message in the cache, or
+    // compress it into a new entry of the cache
+    template<class ConstBufferSequence>
+    void
+    deflate_cache_begin(
+        buffers_suffix<ConstBufferSequence> const& cb,
+        error_code& ec)
+    {
+        auto& pmd = *this->pmd_;
+        auto const size = buffer_bytes(cb);
+        if(size == 0 || size > deflate_cache::max_size)
+            return;
+        {
+            auto e = deflate_cache::find(pmd.wr_level,
+                pmd.wr_window_bits, pmd.wr_mem_level, size);
+            if(e)
+            {
+                auto p = e->in.data();
+                bool match = true;
+                for(auto in : beast::buffers_range_ref(cb))
+                {
+                    if( in.size() > 0 &&
+                        std::memcmp(p, in.data(), in.size()) != 0)
+                    {
+                        match = false;
+                        break;
+                    }
+                    p += in.size();
+                }
+                if(match)
+                {
+                    pmd.wr_hit = std::move(e);
+                    pmd.wr_pos = 0;
+                    return;
+                }
+            }
+        }
+        auto e = deflate_cache::acquire();
+        if(! e)
+            return;
+        e->level = pmd.wr_level;
+        e->window_bits = pmd.wr_window_bits;
+        e->mem_level = pmd.wr_mem_level;
+        e->in.resize(size);
+        net::buffer_copy(net::buffer(&e->in[0], size), cb);
+
+        // The whole message is compressed before its first
+        // frame is sent, so that other streams sending it in
+        // the meantime find it in the cache.
+        buffers_suffix<net::const_buffer> in(
+            net::const_buffer(e->in.data(), size));
+        auto const chunk =
+            pmd.deflater().upper_bound(size);
+        for(;;)
+        {
+            auto const pos = e->out.size();
+            e->out.resize(pos + chunk);
+            auto b = net::buffer(&e->out[pos], chunk);
+            std::size_t used;
+            auto const more = deflate_zlib(
+                b, in, true, used, ec);
+            e->out.resize(pos + b.size());
+            if(ec)
+                return;
+            if(! more)
+                break;
+        }
+        pmd.wr_hit = e;
+        pmd.wr_pos = 0;
+        deflate_cache::insert(std::move(e));
+    }
+
+    // Send the cached output of the current message
+    // in place of running the compressor
+    template<class ConstBufferSequence>
+    bool
+    deflate_cache_replay(
+        net::mutable_buffer& out,
+        buffers_suffix<ConstBufferSequence>& cb,
+        std::size_t& total_in)
+    {
+        auto& pmd = *this->pmd_;
+        auto const& s = pmd.wr_hit->out;
+        if(pmd.wr_pos == 0)
+        {
+            total_in = buffer_bytes(cb);
+            cb.consume(total_in);
+        }
+        else
+        {
+            total_in = 0;
+        }
+        auto const n = (std::min)(
+            out.size(), s.size() - pmd.wr_pos);
+        std::memcpy(out.data(), s.data() + pmd.wr_pos, n);
+        pmd.wr_pos += n;
+        out = net::buffer(out.data(), n);
+        if(pmd.wr_pos < s.size())
+            return true;
+        pmd.wr_hit.reset();
+        pmd.wr_busy = false;
+        return false;
+    }
+
+    template<class ConstBufferSequence>
+    bool
+    deflate_zlib(
+        net::mutable_buffer& out,
+        buffers_suffix<ConstBufferSequence>& cb,
+        bool fin,
+        std::size_t& total_in,
+        error_code& ec)
+    {
+        auto& zo = this->pmd_->deflater();
         zlib::z_params zs;
         zs.avail_in = 0;
         zs.next_in = nullptr;
@@ -151,6 +353,25 @@ struct impl_base<true>
         return true;
     }
 
+    // Returns `true` if a prepared message, compressed
+    // on its own with the given window size, may be
+    // sent in place of the output of the compressor.
+    bool
+    prepared_deflate(role_type role, int window_bits)
+    {
+        if( ! pmd_ ||
+            role != role_type::server ||
+            window_bits == 0 ||
+            window_bits > pmd_config_.server_max_window_bits)
+            return false;
+        // The window of the peer will hold the
+        // message, which the compressor has not
+        // seen, so the compressor starts over.
+        if(pmd_->zo)
+            pmd_->zo->reset();
+        return true;
+    }
+
     void
     do_context_takeover_write(role_type role)
     {
@@ -159,7 +380,8 @@ struct impl_base<true>
            (role == role_type::server &&
             this->pmd_config_.server_no_context_takeover))
         {
-            this->pmd_->zo.reset();
+            // the next message takes a compressor again
+            zlib_pool::release(std::move(this->pmd_->zo));
         }
     }
 
@@ -169,7 +391,7 @@ struct impl_base<true>
         zlib::Flush flush,
         error_code& ec)
     {
-        pmd_->zi.write(zs, flush, ec);
+        pmd_->inflater().write(zs, flush, ec);
     }
 
     void
@@ -180,7 +402,8 @@ struct impl_base<true>
            (role == role_type::server &&
                 pmd_config_.client_no_context_takeover))
         {
-            pmd_->zi.clear();
+            // the next message takes a decompressor again
+            zlib_pool::release(std::move(pmd_->zi));
         }
     }
 
@@ -269,25 +492,25 @@ struct impl_base<true>
         {
             detail::pmd_normalize(pmd_config_);
             pmd_.reset(::new pmd_type);
+            pmd_->wr_level = pmd_opts_.compLevel;
+            pmd_->wr_mem_level = pmd_opts_.memLevel;
             if(role == role_type::client)
             {
-                pmd_->zi.reset(
-                    pmd_config_.server_max_window_bits);
-                pmd_->zo.reset(
-                    pmd_opts_.compLevel,
-                    pmd_config_.client_max_window_bits,
-                    pmd_opts_.memLevel,
-                    zlib::Strategy::normal);
+                pmd_->wr_takeover =
+                    ! pmd_config_.client_no_context_takeover;
+                pmd_->wr_window_bits =
+                    pmd_config_.client_max_window_bits;
+                pmd_->rd_window_bits =
+                    pmd_config_.server_max_window_bits;
             }
             else
             {
-                pmd_->zi.reset(
-                    pmd_config_.client_max_window_bits);
-                pmd_->zo.reset(
-                    pmd_opts_.compLevel,
-                    pmd_config_.server_max_window_bits,
-                    pmd_opts_.memLevel,
-                    zlib::Strategy::normal);
+                pmd_->wr_takeover =
+                    ! pmd_config_.server_no_context_takeover;
+                pmd_->wr_window_bits =
+                    pmd_config_.server_max_window_bits;
+                pmd_->rd_window_bits =
+                    pmd_config_.client_max_window_bits;
             }
         }
     }
@@ -370,6 +593,12 @@ struct impl_base<false>
         return false;
     }
 
+    bool
+    prepared_deflate(role_type, int)
+    {
+        return false;
+    }
+
     void
     do_context_takeover_write(role_type)
     {
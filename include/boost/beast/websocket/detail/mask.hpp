@@ -12,6 +12,7 @@
 
 #include <boost/beast/core/detail/config.hpp>
 #include <boost/beast/core/buffers_range.hpp>
+#include <boost/beast/websocket/detail/utf8_checker.hpp>
 #include <boost/asio/buffer.hpp>
 #include <array>
 #include <climits>
@@ -49,6 +50,31 @@ mask_inplace(
         detail::mask_inplace(b, key);
 }
 
+// Apply mask in place and validate the result as utf8
+//
+BOOST_BEAST_DECL
+bool
+mask_utf8_inplace(
+    net::mutable_buffer const& b,
+    prepared_key& key,
+    utf8_checker& utf8);
+
+// Apply mask in place and validate the result as utf8
+//
+template<class MutableBufferSequence>
+bool
+mask_utf8_inplace(
+    MutableBufferSequence const& buffers,
+    prepared_key& key,
+    utf8_checker& utf8)
+{
+    for(net::mutable_buffer b :
+            beast::buffers_range_ref(buffers))
+        if(! detail::mask_utf8_inplace(b, key, utf8))
+            return false;
+    return true;
+}
+
 } // detail
 } // websocket
 } // beast
@@ -11,6 +11,7 @@
 #define BOOST_BEAST_WEBSOCKET_DETAIL_MASK_IPP
 
 #include <boost/beast/websocket/detail/mask.hpp>
+#include <algorithm>
 
 namespace boost {
 namespace beast {
@@ -58,6 +59,32 @@ mask_inplace(net::mutable_buffer const& b, prepared_key& key)
     }
 }
 
+// Apply mask in place and validate the result as utf8
+//
+bool
+mask_utf8_inplace(
+    net::mutable_buffer const& b,
+    prepared_key& key,
+    utf8_checker& utf8)
+{
+    // Each cache line is validated right after it is
+    // unmasked, while it is still in the L1 cache, so
+    // the payload is brought in from memory only once.
+    std::size_t const line = 64;
+    auto p = static_cast<unsigned char*>(b.data());
+    auto n = b.size();
+    while(n > 0)
+    {
+        auto const len = (std::min)(n, line);
+        mask_inplace(net::mutable_buffer(p, len), key);
+        if(! utf8.write(p, len))
+            return false;
+        p += len;
+        n -= len;
+    }
+    return true;
+}
+
 } // detail
 } // websocket
 } // beast
@@ -0,0 +1,84 @@
+//
+// Copyright (c) 2016-2019 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/boostorg/beast
+//
+
+#ifndef BOOST_BEAST_WEBSOCKET_DETAIL_ZLIB_POOL_HPP
+#define BOOST_BEAST_WEBSOCKET_DETAIL_ZLIB_POOL_HPP
+
+#include <boost/beast/core/detail/config.hpp>
+#include <boost/beast/zlib/deflate_stream.hpp>
+#include <boost/beast/zlib/inflate_stream.hpp>
+#include <cstddef>
+#include <memory>
+
+namespace boost {
+namespace beast {
+namespace websocket {
+namespace detail {
+
+// Per-thread pool of compressors and decompressors.
+//
+// Streams without context takeover only need zlib state
+// while a message is being compressed or decompressed.
+// They take it from the pool of the calling thread when
+// a message starts, and give it back when the message is
+// done, so that idle connections hold no zlib memory.
+// Returned objects keep their buffers, which are reused
+// when the settings of the next user are the same. Up to
+// max_size objects of each kind are kept, the rest are
+// freed. When thread_local is unavailable nothing is kept.
+//
+struct zlib_pool
+{
+    static std::size_t constexpr max_size = 8;
+
+    // The returned object must be reset before use
+    BOOST_BEAST_DECL
+    static
+    std::unique_ptr<zlib::deflate_stream>
+    acquire_deflate();
+
+    // The returned object must be reset before use
+    BOOST_BEAST_DECL
+    static
+    std::unique_ptr<zlib::inflate_stream>
+    acquire_inflate();
+
+    BOOST_BEAST_DECL
+    static
+    void
+    release(std::unique_ptr<zlib::deflate_stream> p) noexcept;
+
+    BOOST_BEAST_DECL
+    static
+    void
+    release(std::unique_ptr<zlib::inflate_stream> p) noexcept;
+
+    // Returns the number of idle objects of
+    // each kind held by the calling thread
+    BOOST_BEAST_DECL
+    static
+    std::size_t
+    idle_deflate() noexcept;
+
+    BOOST_BEAST_DECL
+    static
+    std::size_t
+    idle_inflate() noexcept;
+};
+
+} // detail
+} // websocket
+} // beast
+} // boost
+
+#ifdef BOOST_BEAST_HEADER_ONLY
+#include <boost/beast/websocket/detail/zlib_pool.ipp>
+#endif
+
+#endif
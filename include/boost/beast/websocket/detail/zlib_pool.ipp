@@ -0,0 +1,127 @@
+//
+// Copyright (c) 2016-2019 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/boostorg/beast
+//
+
+#ifndef BOOST_BEAST_WEBSOCKET_DETAIL_ZLIB_POOL_IPP
+#define BOOST_BEAST_WEBSOCKET_DETAIL_ZLIB_POOL_IPP
+
+#include <boost/beast/websocket/detail/zlib_pool.hpp>
+#include <boost/beast/core/detail/thread_local_instance.hpp>
+#include <utility>
+
+namespace boost {
+namespace beast {
+namespace websocket {
+namespace detail {
+
+struct zlib_pool_lists
+{
+    std::unique_ptr<zlib::deflate_stream> zo[zlib_pool::max_size];
+    std::unique_ptr<zlib::inflate_stream> zi[zlib_pool::max_size];
+    std::size_t nzo = 0;
+    std::size_t nzi = 0;
+
+    zlib_pool_lists() = default;
+    zlib_pool_lists(zlib_pool_lists const&) = delete;
+    zlib_pool_lists& operator=(zlib_pool_lists const&) = delete;
+
+    static
+    zlib_pool_lists*
+    get() noexcept
+    {
+        return beast::detail::thread_local_instance<
+            zlib_pool_lists>();
+    }
+
+    template<class T>
+    static
+    std::unique_ptr<T>
+    pop(std::unique_ptr<T>* v, std::size_t& n)
+    {
+        if(n == 0)
+            return std::unique_ptr<T>(new T);
+        return std::move(v[--n]);
+    }
+
+    template<class T>
+    static
+    void
+    push(
+        std::unique_ptr<T>* v,
+        std::size_t& n,
+        std::unique_ptr<T> p) noexcept
+    {
+        if(p && n < zlib_pool::max_size)
+            v[n++] = std::move(p);
+    }
+};
+
+std::unique_ptr<zlib::deflate_stream>
+zlib_pool::
+acquire_deflate()
+{
+    auto const lists = zlib_pool_lists::get();
+    if(! lists)
+        return std::unique_ptr<
+            zlib::deflate_stream>(new zlib::deflate_stream);
+    return zlib_pool_lists::pop(lists->zo, lists->nzo);
+}
+
+std::unique_ptr<zlib::inflate_stream>
+zlib_pool::
+acquire_inflate()
+{
+    auto const lists = zlib_pool_lists::get();
+    if(! lists)
+        return std::unique_ptr<
+            zlib::inflate_stream>(new zlib::inflate_stream);
+    return zlib_pool_lists::pop(lists->zi, lists->nzi);
+}
+
+void
+zlib_pool::
+release(std::unique_ptr<zlib::deflate_stream> p) noexcept
+{
+    auto const lists = zlib_pool_lists::get();
+    if(lists)
+        zlib_pool_lists::push(
+            lists->zo, lists->nzo, std::move(p));
+}
+
+void
+zlib_pool::
+release(std::unique_ptr<zlib::inflate_stream> p) noexcept
+{
+    auto const lists = zlib_pool_lists::get();
+    if(lists)
+        zlib_pool_lists::push(
+            lists->zi, lists->nzi, std::move(p));
+}
+
+std::size_t
+zlib_pool::
+idle_deflate() noexcept
+{
+    auto const lists = zlib_pool_lists::get();
+    return lists ? lists->nzo : 0;
+}
+
+std::size_t
+zlib_pool::
+idle_inflate() noexcept
+{
+    auto const lists = zlib_pool_lists::get();
+    return lists ? lists->nzi : 0;
+}
+
+} // detail
+} // websocket
+} // beast
+} // boost
+
+#endif
@@ -63,10 +63,10 @@ build_response_pmd(
 
 } // detail
 
-template<class NextLayer, bool deflateSupported>
+template<class NextLayer, bool deflateSupported, class Role>
 template<class Body, class Allocator, class Decorator>
 response_type
-stream<NextLayer, deflateSupported>::impl_type::
+stream<NextLayer, deflateSupported, Role>::impl_type::
 build_response(
     http::request<Body,
         http::basic_fields<Allocator>> const& req,
@@ -161,9 +161,9 @@ build_response(
 
 /** Respond to an HTTP request
 */
-template<class NextLayer, bool deflateSupported>
+template<class NextLayer, bool deflateSupported, class Role>
 template<class Handler>
-class stream<NextLayer, deflateSupported>::response_op
+class stream<NextLayer, deflateSupported, Role>::response_op
     : public beast::stable_async_base<
         Handler, beast::executor_type<stream>>
     , public asio::coroutine
@@ -242,9 +242,9 @@ public:
 
 // read and respond to an upgrade request
 //
-template<class NextLayer, bool deflateSupported>
+template<class NextLayer, bool deflateSupported, class Role>
 template<class Handler, class Decorator>
-class stream<NextLayer, deflateSupported>::accept_op
+class stream<NextLayer, deflateSupported, Role>::accept_op
     : public beast::stable_async_base<
         Handler, beast::executor_type<stream>>
     , public asio::coroutine
@@ -335,8 +335,8 @@ public:
     }
 };
 
-template<class NextLayer, bool deflateSupported>
-struct stream<NextLayer, deflateSupported>::
+template<class NextLayer, bool deflateSupported, class Role>
+struct stream<NextLayer, deflateSupported, Role>::
     run_response_op
 {
     template<
@@ -360,14 +360,17 @@ struct stream<NextLayer, deflateSupported>::
                 void(error_code)>::value,
             "AcceptHandler type requirements not met");
 
+        static_assert(! std::is_same<Role, client_role>::value,
+            "Accepting is not available with client_role");
+
         response_op<
             typename std::decay<AcceptHandler>::type>(
                 std::forward<AcceptHandler>(h), sp, *m, d);
     }
 };
 
-template<class NextLayer, bool deflateSupported>
-struct stream<NextLayer, deflateSupported>::
+template<class NextLayer, bool deflateSupported, class Role>
+struct stream<NextLayer, deflateSupported, Role>::
     run_accept_op
 {
     template<
@@ -390,6 +393,9 @@ struct stream<NextLayer, deflateSupported>::
                 void(error_code)>::value,
             "AcceptHandler type requirements not met");
 
+        static_assert(! std::is_same<Role, client_role>::value,
+            "Accepting is not available with client_role");
+
         accept_op<
             typename std::decay<AcceptHandler>::type,
             Decorator>(
@@ -402,17 +408,20 @@ struct stream<NextLayer, deflateSupported>::
 
 //------------------------------------------------------------------------------
 
-template<class NextLayer, bool deflateSupported>
+template<class NextLayer, bool deflateSupported, class Role>
 template<class Body, class Allocator,
     class Decorator>
 void
-stream<NextLayer, deflateSupported>::
+stream<NextLayer, deflateSupported, Role>::
 do_accept(
     http::request<Body,
         http::basic_fields<Allocator>> const& req,
     Decorator const& decorator,
     error_code& ec)
 {
+    static_assert(! std::is_same<Role, client_role>::value,
+        "Accepting is not available with client_role");
+
     impl_->change_status(status::handshake);
 
     error_code result;
@@ -431,10 +440,10 @@ do_accept(
     impl_->open(role_type::server);
 }
 
-template<class NextLayer, bool deflateSupported>
+template<class NextLayer, bool deflateSupported, class Role>
 template<class Buffers, class Decorator>
 void
-stream<NextLayer, deflateSupported>::
+stream<NextLayer, deflateSupported, Role>::
 do_accept(
     Buffers const& buffers,
     Decorator const& decorator,
@@ -460,9 +469,9 @@ do_accept(
 
 //------------------------------------------------------------------------------
 
-template<class NextLayer, bool deflateSupported>
+template<class NextLayer, bool deflateSupported, class Role>
 void
-stream<NextLayer, deflateSupported>::
+stream<NextLayer, deflateSupported, Role>::
 accept()
 {
     static_assert(is_sync_stream<next_layer_type>::value,
@@ -473,9 +482,9 @@ accept()
         BOOST_THROW_EXCEPTION(system_error{ec});
 }
 
-template<class NextLayer, bool deflateSupported>
+template<class NextLayer, bool deflateSupported, class Role>
 void
-stream<NextLayer, deflateSupported>::
+stream<NextLayer, deflateSupported, Role>::
 accept(error_code& ec)
 {
     static_assert(is_sync_stream<next_layer_type>::value,
@@ -485,11 +494,11 @@ accept(error_code& ec)
         &default_decorate_res, ec);
 }
 
-template<class NextLayer, bool deflateSupported>
+template<class NextLayer, bool deflateSupported, class Role>
 template<class ConstBufferSequence>
 typename std::enable_if<! http::detail::is_header<
     ConstBufferSequence>::value>::type
-stream<NextLayer, deflateSupported>::
+stream<NextLayer, deflateSupported, Role>::
 accept(ConstBufferSequence const& buffers)
 {
     static_assert(is_sync_stream<next_layer_type>::value,
@@ -502,11 +511,11 @@ accept(ConstBufferSequence const& buffers)
     if(ec)
         BOOST_THROW_EXCEPTION(system_error{ec});
 }
-template<class NextLayer, bool deflateSupported>
+template<class NextLayer, bool deflateSupported, class Role>
 template<class ConstBufferSequence>
 typename std::enable_if<! http::detail::is_header<
     ConstBufferSequence>::value>::type
-stream<NextLayer, deflateSupported>::
+stream<NextLayer, deflateSupported, Role>::
 accept(
     ConstBufferSequence const& buffers, error_code& ec)
 {
@@ -519,10 +528,10 @@ accept(
 }
 
 
-template<class NextLayer, bool deflateSupported>
+template<class NextLayer, bool deflateSupported, class Role>
 template<class Body, class Allocator>
 void
-stream<NextLayer, deflateSupported>::
+stream<NextLayer, deflateSupported, Role>::
 accept(
     http::request<Body,
         http::basic_fields<Allocator>> const& req)
@@ -535,10 +544,10 @@ accept(
         BOOST_THROW_EXCEPTION(system_error{ec});
 }
 
-template<class NextLayer, bool deflateSupported>
+template<class NextLayer, bool deflateSupported, class Role>
 template<class Body, class Allocator>
 void
-stream<NextLayer, deflateSupported>::
+stream<NextLayer, deflateSupported, Role>::
 accept(
     http::request<Body,
         http::basic_fields<Allocator>> const& req,
@@ -552,11 +561,11 @@ accept(
 
 //------------------------------------------------------------------------------
 
-template<class NextLayer, bool deflateSupported>
+template<class NextLayer, bool deflateSupported, class Role>
 template<
     BOOST_BEAST_ASYNC_TPARAM1 AcceptHandler>
 BOOST_BEAST_ASYNC_RESULT1(AcceptHandler)
-stream<NextLayer, deflateSupported>::
+stream<NextLayer, deflateSupported, Role>::
 async_accept(
     AcceptHandler&& handler)
 {
@@ -573,12 +582,12 @@ async_accept(
             net::const_buffer{});
 }
 
-template<class NextLayer, bool deflateSupported>
+template<class NextLayer, bool deflateSupported, class Role>
 template<
     class ConstBufferSequence,
     BOOST_BEAST_ASYNC_TPARAM1 AcceptHandler>
 BOOST_BEAST_ASYNC_RESULT1(AcceptHandler)
-stream<NextLayer, deflateSupported>::
+stream<NextLayer, deflateSupported, Role>::
 async_accept(
     ConstBufferSequence const& buffers,
     AcceptHandler&& handler,
@@ -603,12 +612,12 @@ async_accept(
             buffers);
 }
 
-template<class NextLayer, bool deflateSupported>
+template<class NextLayer, bool deflateSupported, class Role>
 template<
     class Body, class Allocator,
     BOOST_BEAST_ASYNC_TPARAM1 AcceptHandler>
 BOOST_BEAST_ASYNC_RESULT1(AcceptHandler)
-stream<NextLayer, deflateSupported>::
+stream<NextLayer, deflateSupported, Role>::
 async_accept(
     http::request<Body, http::basic_fields<Allocator>> const& req,
     AcceptHandler&& handler)
@@ -21,6 +21,7 @@
 #include <boost/asio/post.hpp>
 #include <boost/throw_exception.hpp>
 #include <memory>
+#include <utility>
 
 namespace boost {
 namespace beast {
@@ -33,9 +34,9 @@ namespace websocket {
     frame. Finally it invokes the teardown operation to shut down the
     underlying connection.
 */
-template<class NextLayer, bool deflateSupported>
+template<class NextLayer, bool deflateSupported, class Role>
 template<class Handler>
-class stream<NextLayer, deflateSupported>::close_op
+class stream<NextLayer, deflateSupported, Role>::close_op
     : public beast::stable_async_base<
         Handler, beast::executor_type<stream>>
     , public asio::coroutine
@@ -63,6 +64,7 @@ public:
         // Serialize the close frame
         sp->template write_close<
             flat_static_buffer_base>(fb_, cr);
+        sp->send_closed = true;
         (*this)({}, 0, false);
     }
 
@@ -115,6 +117,28 @@ public:
             impl.wr_close = true;
             impl.change_status(status::closing);
             impl.update_timer(this->get_executor());
+
+            // Messages queued by async_send go first,
+            // unless they would interrupt a message
+            if(impl.send_buf.size() > 0 && ! impl.wr_cont)
+            {
+                std::swap(impl.send_buf, impl.send_out);
+                BOOST_ASIO_CORO_YIELD
+                {
+                    BOOST_ASIO_HANDLER_LOCATION((
+                        __FILE__, __LINE__,
+                        "websocket::async_close"));
+
+                    net::async_write(impl.stream(),
+                        impl.send_out.data(),
+                        beast::detail::bind_continuation(std::move(*this)));
+                }
+                impl.send_out.clear();
+                if(impl.check_stop_now(ec))
+                    goto upcall;
+                impl.send_resume();
+            }
+
             BOOST_ASIO_CORO_YIELD
             {
                 BOOST_ASIO_HANDLER_LOCATION((
@@ -274,14 +298,15 @@ public:
             impl.op_rd.maybe_invoke()
                 || impl.op_idle_ping.maybe_invoke()
                 || impl.op_ping.maybe_invoke()
-                || impl.op_wr.maybe_invoke();
+                || impl.op_wr.maybe_invoke()
+                || impl.op_send.maybe_invoke();
             this->complete(cont, ec);
         }
     }
 };
 
-template<class NextLayer, bool deflateSupported>
-struct stream<NextLayer, deflateSupported>::
+template<class NextLayer, bool deflateSupported, class Role>
+struct stream<NextLayer, deflateSupported, Role>::
     run_close_op
 {
     template<class CloseHandler>
@@ -310,9 +335,9 @@ struct stream<NextLayer, deflateSupported>::
 
 //------------------------------------------------------------------------------
 
-template<class NextLayer, bool deflateSupported>
+template<class NextLayer, bool deflateSupported, class Role>
 void
-stream<NextLayer, deflateSupported>::
+stream<NextLayer, deflateSupported, Role>::
 close(close_reason const& cr)
 {
     static_assert(is_sync_stream<next_layer_type>::value,
@@ -323,9 +348,9 @@ close(close_reason const& cr)
         BOOST_THROW_EXCEPTION(system_error{ec});
 }
 
-template<class NextLayer, bool deflateSupported>
+template<class NextLayer, bool deflateSupported, class Role>
 void
-stream<NextLayer, deflateSupported>::
+stream<NextLayer, deflateSupported, Role>::
 close(close_reason const& cr, error_code& ec)
 {
     static_assert(is_sync_stream<next_layer_type>::value,
@@ -344,7 +369,21 @@ close(close_reason const& cr, error_code& ec)
     // Send close frame
     {
         impl.wr_close = true;
+        impl.send_closed = true;
         impl.change_status(status::closing);
+
+        // Messages queued by async_send go first,
+        // unless they would interrupt a message
+        if(impl.send_buf.size() > 0 && ! impl.wr_cont)
+        {
+            std::swap(impl.send_buf, impl.send_out);
+            net::write(impl.stream(), impl.send_out.data(), ec);
+            impl.send_out.clear();
+            if(impl.check_stop_now(ec))
+                return;
+            impl.send_resume();
+        }
+
         detail::frame_buffer fb;
         impl.template write_close<flat_static_buffer_base>(fb, cr);
         net::write(impl.stream(), fb.data(), ec);
@@ -429,10 +468,10 @@ close(close_reason const& cr, error_code& ec)
         ec = {};
 }
 
-template<class NextLayer, bool deflateSupported>
+template<class NextLayer, bool deflateSupported, class Role>
 template<BOOST_BEAST_ASYNC_TPARAM1 CloseHandler>
 BOOST_BEAST_ASYNC_RESULT1(CloseHandler)
-stream<NextLayer, deflateSupported>::
+stream<NextLayer, deflateSupported, Role>::
 async_close(close_reason const& cr, CloseHandler&& handler)
 {
     static_assert(is_async_stream<next_layer_type>::value,
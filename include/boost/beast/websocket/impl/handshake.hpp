@@ -23,6 +23,7 @@
 #include <boost/assert.hpp>
 #include <boost/throw_exception.hpp>
 #include <memory>
+#include <type_traits>
 
 namespace boost {
 namespace beast {
@@ -32,9 +33,9 @@ namespace websocket {
 
 // send the upgrade request and process the response
 //
-template<class NextLayer, bool deflateSupported>
+template<class NextLayer, bool deflateSupported, class Role>
 template<class Handler>
-class stream<NextLayer, deflateSupported>::handshake_op
+class stream<NextLayer, deflateSupported, Role>::handshake_op
     : public beast::stable_async_base<Handler,
         beast::executor_type<stream>>
     , public asio::coroutine
@@ -184,8 +185,8 @@ public:
     }
 };
 
-template<class NextLayer, bool deflateSupported>
-struct stream<NextLayer, deflateSupported>::
+template<class NextLayer, bool deflateSupported, class Role>
+struct stream<NextLayer, deflateSupported, Role>::
     run_handshake_op
 {
     template<class HandshakeHandler>
@@ -205,6 +206,9 @@ struct stream<NextLayer, deflateSupported>::
                 void(error_code)>::value,
             "HandshakeHandler type requirements not met");
 
+        static_assert(! std::is_same<Role, server_role>::value,
+            "The client handshake is not available with server_role");
+
         handshake_op<
             typename std::decay<HandshakeHandler>::type>(
                 std::forward<HandshakeHandler>(h),
@@ -214,10 +218,10 @@ struct stream<NextLayer, deflateSupported>::
 
 //------------------------------------------------------------------------------
 
-template<class NextLayer, bool deflateSupported>
+template<class NextLayer, bool deflateSupported, class Role>
 template<class RequestDecorator>
 void
-stream<NextLayer, deflateSupported>::
+stream<NextLayer, deflateSupported, Role>::
 do_handshake(
     response_type* res_p,
     string_view host,
@@ -225,6 +229,9 @@ do_handshake(
     RequestDecorator const& decorator,
     error_code& ec)
 {
+    static_assert(! std::is_same<Role, server_role>::value,
+        "The client handshake is not available with server_role");
+
     if(res_p)
         res_p->result(http::status::internal_server_error);
 
@@ -294,10 +301,10 @@ do_handshake(
 
 //------------------------------------------------------------------------------
 
-template<class NextLayer, bool deflateSupported>
+template<class NextLayer, bool deflateSupported, class Role>
 template<BOOST_BEAST_ASYNC_TPARAM1 HandshakeHandler>
 BOOST_BEAST_ASYNC_RESULT1(HandshakeHandler)
-stream<NextLayer, deflateSupported>::
+stream<NextLayer, deflateSupported, Role>::
 async_handshake(
     string_view host,
     string_view target,
@@ -319,10 +326,10 @@ async_handshake(
             nullptr);
 }
 
-template<class NextLayer, bool deflateSupported>
+template<class NextLayer, bool deflateSupported, class Role>
 template<BOOST_BEAST_ASYNC_TPARAM1 HandshakeHandler>
 BOOST_BEAST_ASYNC_RESULT1(HandshakeHandler)
-stream<NextLayer, deflateSupported>::
+stream<NextLayer, deflateSupported, Role>::
 async_handshake(
     response_type& res,
     string_view host,
@@ -346,9 +353,9 @@ async_handshake(
             &res);
 }
 
-template<class NextLayer, bool deflateSupported>
+template<class NextLayer, bool deflateSupported, class Role>
 void
-stream<NextLayer, deflateSupported>::
+stream<NextLayer, deflateSupported, Role>::
 handshake(string_view host,
     string_view target)
 {
@@ -361,9 +368,9 @@ handshake(string_view host,
         BOOST_THROW_EXCEPTION(system_error{ec});
 }
 
-template<class NextLayer, bool deflateSupported>
+template<class NextLayer, bool deflateSupported, class Role>
 void
-stream<NextLayer, deflateSupported>::
+stream<NextLayer, deflateSupported, Role>::
 handshake(response_type& res,
     string_view host,
         string_view target)
@@ -376,9 +383,9 @@ handshake(response_type& res,
         BOOST_THROW_EXCEPTION(system_error{ec});
 }
 
-template<class NextLayer, bool deflateSupported>
+template<class NextLayer, bool deflateSupported, class Role>
 void
-stream<NextLayer, deflateSupported>::
+stream<NextLayer, deflateSupported, Role>::
 handshake(string_view host,
     string_view target, error_code& ec)
 {
@@ -388,9 +395,9 @@ handshake(string_view host,
         host, target, &default_decorate_req, ec);
 }
 
-template<class NextLayer, bool deflateSupported>
+template<class NextLayer, bool deflateSupported, class Role>
 void
-stream<NextLayer, deflateSupported>::
+stream<NextLayer, deflateSupported, Role>::
 handshake(response_type& res,
     string_view host,
         string_view target,
@@ -12,6 +12,7 @@
 
 #include <boost/beast/core/async_base.hpp>
 #include <boost/beast/core/bind_handler.hpp>
+#include <boost/beast/core/pooled_allocator.hpp>
 #include <boost/beast/core/stream_traits.hpp>
 #include <boost/beast/core/detail/bind_continuation.hpp>
 #include <boost/beast/websocket/detail/frame.hpp>
@@ -30,9 +31,9 @@ namespace websocket {
     It only sends the frames it does not make attempts to read
     any frame data.
 */
-template<class NextLayer, bool deflateSupported>
+template<class NextLayer, bool deflateSupported, class Role>
 template<class Handler>
-class stream<NextLayer, deflateSupported>::ping_op
+class stream<NextLayer, deflateSupported, Role>::ping_op
     : public beast::stable_async_base<
         Handler, beast::executor_type<stream>>
     , public asio::coroutine
@@ -121,7 +122,8 @@ public:
             impl.op_close.maybe_invoke()
                 || impl.op_idle_ping.maybe_invoke()
                 || impl.op_rd.maybe_invoke()
-                || impl.op_wr.maybe_invoke();
+                || impl.op_wr.maybe_invoke()
+                || impl.op_send.maybe_invoke();
             this->complete(cont, ec);
         }
     }
@@ -130,14 +132,13 @@ public:
 //------------------------------------------------------------------------------
 
 // sends the idle ping
-template<class NextLayer, bool deflateSupported>
+template<class NextLayer, bool deflateSupported, class Role>
 template<class Executor>
-class stream<NextLayer, deflateSupported>::idle_ping_op
+class stream<NextLayer, deflateSupported, Role>::idle_ping_op
     : public asio::coroutine
     , public boost::empty_value<Executor>
 {
     boost::weak_ptr<impl_type> wp_;
-    std::unique_ptr<detail::frame_buffer> fb_;
 
 public:
     static constexpr int id = 4; // for soft_mutex
@@ -150,20 +151,31 @@ public:
         return this->get();
     }
 
+    // Memory for the intermediate operations of each
+    // idle ping is recycled instead of allocated anew.
+    using allocator_type = pooled_allocator<char>;
+
+    allocator_type
+    get_allocator() const noexcept
+    {
+        return {};
+    }
+
     idle_ping_op(
         boost::shared_ptr<impl_type> const& sp,
         Executor const& ex)
         : boost::empty_value<Executor>(
             boost::empty_init_t{}, ex)
         , wp_(sp)
-        , fb_(new detail::frame_buffer)
     {
         if(! sp->idle_pinging)
         {
-            // Create the ping frame
+            // Create the ping frame in the
+            // stream's preallocated buffer
             ping_data payload; // empty for now
+            sp->idle_ping_fb.clear();
             sp->template write_ping<
-                flat_static_buffer_base>(*fb_,
+                flat_static_buffer_base>(sp->idle_ping_fb,
                     detail::opcode::ping, payload);
 
             sp->idle_pinging = true;
@@ -220,8 +232,8 @@ public:
                     __FILE__, __LINE__,
                     "websocket::async_ping"));
 
-                net::async_write(impl.stream(), fb_->data(),
-                    std::move(*this));
+                net::async_write(impl.stream(),
+                    impl.idle_ping_fb.data(), std::move(*this));
             }
             if(impl.check_stop_now(ec))
                 goto upcall;
@@ -233,13 +245,14 @@ public:
             impl.op_close.maybe_invoke()
                 || impl.op_ping.maybe_invoke()
                 || impl.op_rd.maybe_invoke()
-                || impl.op_wr.maybe_invoke();
+                || impl.op_wr.maybe_invoke()
+                || impl.op_send.maybe_invoke();
         }
     }
 };
 
-template<class NextLayer, bool deflateSupported>
-struct stream<NextLayer, deflateSupported>::
+template<class NextLayer, bool deflateSupported, class Role>
+struct stream<NextLayer, deflateSupported, Role>::
     run_ping_op
 {
     template<class WriteHandler>
@@ -270,9 +283,9 @@ struct stream<NextLayer, deflateSupported>::
 
 //------------------------------------------------------------------------------
 
-template<class NextLayer, bool deflateSupported>
+template<class NextLayer, bool deflateSupported, class Role>
 void
-stream<NextLayer, deflateSupported>::
+stream<NextLayer, deflateSupported, Role>::
 ping(ping_data const& payload)
 {
     error_code ec;
@@ -281,9 +294,9 @@ ping(ping_data const& payload)
         BOOST_THROW_EXCEPTION(system_error{ec});
 }
 
-template<class NextLayer, bool deflateSupported>
+template<class NextLayer, bool deflateSupported, class Role>
 void
-stream<NextLayer, deflateSupported>::
+stream<NextLayer, deflateSupported, Role>::
 ping(ping_data const& payload, error_code& ec)
 {
     if(impl_->check_stop_now(ec))
@@ -296,9 +309,9 @@ ping(ping_data const& payload, error_code& ec)
         return;
 }
 
-template<class NextLayer, bool deflateSupported>
+template<class NextLayer, bool deflateSupported, class Role>
 void
-stream<NextLayer, deflateSupported>::
+stream<NextLayer, deflateSupported, Role>::
 pong(ping_data const& payload)
 {
     error_code ec;
@@ -307,9 +320,9 @@ pong(ping_data const& payload)
         BOOST_THROW_EXCEPTION(system_error{ec});
 }
 
-template<class NextLayer, bool deflateSupported>
+template<class NextLayer, bool deflateSupported, class Role>
 void
-stream<NextLayer, deflateSupported>::
+stream<NextLayer, deflateSupported, Role>::
 pong(ping_data const& payload, error_code& ec)
 {
     if(impl_->check_stop_now(ec))
@@ -322,10 +335,10 @@ pong(ping_data const& payload, error_code& ec)
         return;
 }
 
-template<class NextLayer, bool deflateSupported>
+template<class NextLayer, bool deflateSupported, class Role>
 template<BOOST_BEAST_ASYNC_TPARAM1 WriteHandler>
 BOOST_BEAST_ASYNC_RESULT1(WriteHandler)
-stream<NextLayer, deflateSupported>::
+stream<NextLayer, deflateSupported, Role>::
 async_ping(ping_data const& payload, WriteHandler&& handler)
 {
     static_assert(is_async_stream<next_layer_type>::value,
@@ -340,10 +353,10 @@ async_ping(ping_data const& payload, WriteHandler&& handler)
             payload);
 }
 
-template<class NextLayer, bool deflateSupported>
+template<class NextLayer, bool deflateSupported, class Role>
 template<BOOST_BEAST_ASYNC_TPARAM1 WriteHandler>
 BOOST_BEAST_ASYNC_RESULT1(WriteHandler)
-stream<NextLayer, deflateSupported>::
+stream<NextLayer, deflateSupported, Role>::
 async_pong(ping_data const& payload, WriteHandler&& handler)
 {
     static_assert(is_async_stream<next_layer_type>::value,
@@ -0,0 +1,188 @@
+//
+// Copyright (c) 2016-2019 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/boostorg/beast
+//
+
+#ifndef BOOST_BEAST_WEBSOCKET_IMPL_PREPARED_MESSAGE_IPP
+#define BOOST_BEAST_WEBSOCKET_IMPL_PREPARED_MESSAGE_IPP
+
+#include <boost/beast/websocket/prepared_message.hpp>
+#include <boost/beast/websocket/detail/frame.hpp>
+#include <boost/beast/zlib/deflate_stream.hpp>
+#include <boost/make_shared.hpp>
+#include <boost/throw_exception.hpp>
+#include <cstring>
+#include <stdexcept>
+
+namespace boost {
+namespace beast {
+namespace websocket {
+
+struct prepared_message::impl_type
+{
+    // frame header followed by the payload
+    std::string plain;
+
+    // frame header followed by the compressed
+    // payload, or empty if there is none
+    std::string deflated;
+
+    std::size_t header = 0;
+    int window_bits = 0;
+    bool binary = false;
+};
+
+void*
+prepared_message::
+prepare(std::size_t size, bool binary)
+{
+    impl_ = boost::make_shared<impl_type>();
+    detail::frame_header fh;
+    fh.op = binary ?
+        detail::opcode::binary : detail::opcode::text;
+    fh.fin = true;
+    fh.mask = false;
+    fh.rsv1 = false;
+    fh.rsv2 = false;
+    fh.rsv3 = false;
+    fh.len = size;
+    fh.key = 0;
+    detail::fh_buffer fb;
+    detail::write<flat_static_buffer_base>(fb, fh);
+    impl_->header = fb.size();
+    impl_->binary = binary;
+    impl_->plain.resize(fb.size() + size);
+    std::memcpy(&impl_->plain[0], fb.data().data(), fb.size());
+    return &impl_->plain[fb.size()];
+}
+
+void
+prepared_message::
+commit(permessage_deflate const& opts)
+{
+    if(! opts.server_enable)
+        return;
+    if( opts.server_max_window_bits > 15 ||
+        opts.server_max_window_bits < 9)
+        BOOST_THROW_EXCEPTION(std::invalid_argument{
+            "invalid server_max_window_bits"});
+    if( opts.compLevel < 0 ||
+        opts.compLevel > 9)
+        BOOST_THROW_EXCEPTION(std::invalid_argument{
+            "invalid compLevel"});
+    if( opts.memLevel < 1 ||
+        opts.memLevel > 9)
+        BOOST_THROW_EXCEPTION(std::invalid_argument{
+            "invalid memLevel"});
+    auto const in = payload();
+    if(in.size() == 0)
+        return;
+
+    // Compress the whole payload with a fresh compressor,
+    // so the output refers to nothing outside the message.
+    // Room for the largest header is left at the front.
+    zlib::deflate_stream zo;
+    zo.reset(
+        opts.compLevel,
+        opts.server_max_window_bits,
+        opts.memLevel,
+        zlib::Strategy::normal);
+    std::size_t const room = 10;
+    std::string out;
+    out.resize(room + zo.upper_bound(in.size()) + 6);
+    zlib::z_params zs;
+    zs.next_in = in.data();
+    zs.avail_in = in.size();
+    zs.next_out = &out[room];
+    zs.avail_out = out.size() - room;
+    error_code ec;
+    zo.write(zs, zlib::Flush::sync, ec);
+    if(ec || zs.avail_in != 0 || zs.avail_out == 0)
+        return;
+    // remove flush marker
+    auto const n = zs.total_out - 4;
+    if(n >= in.size())
+        return;
+
+    detail::frame_header fh;
+    fh.op = impl_->binary ?
+        detail::opcode::binary : detail::opcode::text;
+    fh.fin = true;
+    fh.mask = false;
+    fh.rsv1 = true;
+    fh.rsv2 = false;
+    fh.rsv3 = false;
+    fh.len = n;
+    fh.key = 0;
+    detail::fh_buffer fb;
+    detail::write<flat_static_buffer_base>(fb, fh);
+    std::memcpy(&out[room - fb.size()],
+        fb.data().data(), fb.size());
+    out.resize(room + n);
+    out.erase(0, room - fb.size());
+    impl_->deflated = std::move(out);
+    impl_->window_bits = opts.server_max_window_bits;
+}
+
+net::const_buffer
+prepared_message::
+frame(bool deflated) const noexcept
+{
+    if(! impl_)
+        // empty text message
+        return {"\x81\x00", 2};
+    auto const& s = deflated ?
+        impl_->deflated : impl_->plain;
+    return {s.data(), s.size()};
+}
+
+int
+prepared_message::
+window_bits() const noexcept
+{
+    return impl_ ? impl_->window_bits : 0;
+}
+
+bool
+prepared_message::
+binary() const noexcept
+{
+    return impl_ && impl_->binary;
+}
+
+bool
+prepared_message::
+deflated() const noexcept
+{
+    return impl_ && ! impl_->deflated.empty();
+}
+
+std::size_t
+prepared_message::
+size() const noexcept
+{
+    if(! impl_)
+        return 0;
+    return impl_->plain.size() - impl_->header;
+}
+
+net::const_buffer
+prepared_message::
+payload() const noexcept
+{
+    if(! impl_)
+        return {};
+    return {
+        impl_->plain.data() + impl_->header,
+        impl_->plain.size() - impl_->header};
+}
+
+} // websocket
+} // beast
+} // boost
+
+#endif
@@ -43,9 +43,9 @@ namespace websocket {
 
     Also reads and handles control frames.
 */
-template<class NextLayer, bool deflateSupported>
+template<class NextLayer, bool deflateSupported, class Role>
 template<class Handler, class MutableBufferSequence>
-class stream<NextLayer, deflateSupported>::read_some_op
+class stream<NextLayer, deflateSupported, Role>::read_some_op
     : public beast::async_base<
         Handler, beast::executor_type<stream>>
     , public asio::coroutine
@@ -159,6 +159,18 @@ public:
             if(impl.rd_remain == 0 &&
                 (! impl.rd_fh.fin || impl.rd_done))
             {
+                if(bytes_written_ > 0)
+                {
+                    // Deliver the payload already copied rather
+                    // than wait for the rest of the next frame,
+                    // or handle a control frame behind it, which
+                    // could have to wait for a pending write.
+                    detail::opcode op;
+                    if( ! impl.rd_peek(op) ||
+                        op != detail::opcode::cont)
+                        goto upcall;
+                }
+
                 // Read frame header
                 while(! impl.parse_fh(
                     impl.rd_fh, impl.rd_buf, result_))
@@ -173,6 +185,22 @@ public:
                         goto close;
                     }
                     BOOST_ASSERT(impl.rd_block.is_locked(this));
+                    if(impl.release_rd_buf())
+                    {
+                        // Hold no buffer while idle
+                        BOOST_ASIO_CORO_YIELD
+                        {
+                            BOOST_ASIO_HANDLER_LOCATION((
+                                __FILE__, __LINE__,
+                                "websocket::async_read_some"));
+
+                            beast::detail::async_wait_read(
+                                impl.stream(), std::move(*this));
+                        }
+                        BOOST_ASSERT(impl.rd_block.is_locked(this));
+                        if(impl.check_stop_now(ec))
+                            goto upcall;
+                    }
                     BOOST_ASIO_CORO_YIELD
                     {
                         BOOST_ASIO_HANDLER_LOCATION((
@@ -204,11 +232,15 @@ public:
                 }
                 // Immediately apply the mask to the portion
                 // of the buffer holding payload data.
-                if(impl.rd_fh.len > 0 && impl.rd_fh.mask)
-                    detail::mask_inplace(buffers_prefix(
-                        clamp(impl.rd_fh.len),
-                            impl.rd_buf.data()),
-                                impl.rd_key);
+                if(impl.rd_fh.len > 0 && ! impl.rd_unmask(
+                    buffers_prefix(clamp(impl.rd_fh.len),
+                        impl.rd_buf.data())))
+                {
+                    // _Fail the WebSocket Connection_
+                    code_ = close_code::bad_payload;
+                    result_ = error::bad_frame_payload;
+                    goto close;
+                }
                 if(detail::is_control(impl.rd_fh.op))
                 {
                     // Clear this otherwise the next
@@ -249,6 +281,15 @@ public:
                             if(impl.ctrl_cb)
                                 impl.ctrl_cb(
                                     frame_type::ping, to_string_view(payload));
+                            // Answer only the last of several pings
+                            // in the read buffer, rfc6455 5.5.3 allows
+                            // leaving the earlier ones unanswered.
+                            {
+                                detail::opcode op;
+                                if( impl.rd_peek(op) &&
+                                    op == detail::opcode::ping)
+                                    goto loop;
+                            }
                             impl.rd_fb.clear();
                             impl.template write_ping<
                                 flat_static_buffer_base>(impl.rd_fb,
@@ -304,7 +345,8 @@ public:
                         impl.op_close.maybe_invoke()
                             || impl.op_idle_ping.maybe_invoke()
                             || impl.op_ping.maybe_invoke()
-                            || impl.op_wr.maybe_invoke();
+                            || impl.op_wr.maybe_invoke()
+                            || impl.op_send.maybe_invoke();
                         goto acquire_read_lock;
                     }
 
@@ -426,10 +468,14 @@ public:
                         if(impl.check_stop_now(ec))
                             goto upcall;
                         impl.reset_idle();
-                        if(impl.rd_fh.mask)
-                            detail::mask_inplace(buffers_prefix(clamp(
-                                impl.rd_remain), impl.rd_buf.data()),
-                                    impl.rd_key);
+                        if(! impl.rd_unmask(buffers_prefix(clamp(
+                            impl.rd_remain), impl.rd_buf.data())))
+                        {
+                            // _Fail the WebSocket Connection_
+                            code_ = close_code::bad_payload;
+                            result_ = error::bad_frame_payload;
+                            goto close;
+                        }
                     }
                     if(impl.rd_buf.size() > 0)
                     {
@@ -440,21 +486,17 @@ public:
                         auto const mb = buffers_prefix(
                             bytes_transferred, cb_);
                         impl.rd_remain -= bytes_transferred;
-                        if(impl.rd_op == detail::opcode::text)
+                        if(! impl.rd_check_utf8(mb))
                         {
-                            if(! impl.rd_utf8.write(mb) ||
-                                (impl.rd_remain == 0 && impl.rd_fh.fin &&
-                                    ! impl.rd_utf8.finish()))
-                            {
-                                // _Fail the WebSocket Connection_
-                                code_ = close_code::bad_payload;
-                                result_ = error::bad_frame_payload;
-                                goto close;
-                            }
+                            // _Fail the WebSocket Connection_
+                            code_ = close_code::bad_payload;
+                            result_ = error::bad_frame_payload;
+                            goto close;
                         }
                         bytes_written_ += bytes_transferred;
                         impl.rd_size += bytes_transferred;
                         impl.rd_buf.consume(bytes_transferred);
+                        cb_.consume(bytes_transferred);
                     }
                     else
                     {
@@ -479,27 +521,28 @@ public:
                         auto const mb = buffers_prefix(
                             bytes_transferred, cb_);
                         impl.rd_remain -= bytes_transferred;
-                        if(impl.rd_fh.mask)
-                            detail::mask_inplace(mb, impl.rd_key);
-                        if(impl.rd_op == detail::opcode::text)
+                        if( ! impl.rd_unmask(mb) ||
+                            ! impl.rd_check_utf8(mb))
                         {
-                            if(! impl.rd_utf8.write(mb) ||
-                                (impl.rd_remain == 0 && impl.rd_fh.fin &&
-                                    ! impl.rd_utf8.finish()))
-                            {
-                                // _Fail the WebSocket Connection_
-                                code_ = close_code::bad_payload;
-                                result_ = error::bad_frame_payload;
-                                goto close;
-                            }
+                            // _Fail the WebSocket Connection_
+                            code_ = close_code::bad_payload;
+                            result_ = error::bad_frame_payload;
+                            goto close;
                         }
                         bytes_written_ += bytes_transferred;
                         impl.rd_size += bytes_transferred;
+                        cb_.consume(bytes_transferred);
                     }
                 }
                 BOOST_ASSERT( ! impl.rd_done );
                 if( impl.rd_remain == 0 && impl.rd_fh.fin )
                     impl.rd_done = true;
+                // Go on with the next frames of the message which
+                // are already in the read buffer, so that a burst
+                // of small frames is delivered by one operation.
+                if( ! impl.rd_done && impl.rd_remain == 0 &&
+                    buffer_bytes(cb_) > 0)
+                    goto loop;
             }
             else
             {
@@ -701,7 +744,8 @@ public:
                 impl.op_close.maybe_invoke()
                     || impl.op_idle_ping.maybe_invoke()
                     || impl.op_ping.maybe_invoke()
-                    || impl.op_wr.maybe_invoke();
+                    || impl.op_wr.maybe_invoke()
+                    || impl.op_send.maybe_invoke();
             this->complete(cont, ec, bytes_written_);
         }
     }
@@ -709,9 +753,9 @@ public:
 
 //------------------------------------------------------------------------------
 
-template<class NextLayer, bool deflateSupported>
+template<class NextLayer, bool deflateSupported, class Role>
 template<class Handler,  class DynamicBuffer>
-class stream<NextLayer, deflateSupported>::read_op
+class stream<NextLayer, deflateSupported, Role>::read_op
     : public beast::async_base<
         Handler, beast::executor_type<stream>>
     , public asio::coroutine
@@ -793,8 +837,86 @@ public:
     }
 };
 
-template<class NextLayer, bool deflateSupported>
-struct stream<NextLayer, deflateSupported>::
+template<class NextLayer, bool deflateSupported, class Role>
+template<class Handler,  class DynamicBuffer>
+class stream<NextLayer, deflateSupported, Role>::read_many_op
+    : public beast::async_base<
+        Handler, beast::executor_type<stream>>
+    , public asio::coroutine
+{
+    boost::weak_ptr<impl_type> wp_;
+    DynamicBuffer& b_;
+    std::vector<message_info>& v_;
+    std::size_t max_;
+    std::size_t offset_ = 0;
+    std::size_t bytes_written_ = 0;
+
+public:
+    template<class Handler_>
+    read_many_op(
+        Handler_&& h,
+        boost::shared_ptr<impl_type> const& sp,
+        DynamicBuffer& b,
+        std::vector<message_info>& v,
+        std::size_t max_messages)
+        : async_base<Handler,
+            beast::executor_type<stream>>(
+                std::forward<Handler_>(h),
+                    sp->stream().get_executor())
+        , wp_(sp)
+        , b_(b)
+        , v_(v)
+        , max_(max_messages)
+    {
+        BOOST_ASSERT(max_ > 0);
+        v_.clear();
+        (*this)({}, 0, false);
+    }
+
+    void operator()(
+        error_code ec = {},
+        std::size_t bytes_transferred = 0,
+        bool cont = true)
+    {
+        auto sp = wp_.lock();
+        if(! sp)
+        {
+            ec = net::error::operation_aborted;
+            return this->complete(cont, ec, bytes_written_);
+        }
+        auto& impl = *sp;
+        BOOST_ASIO_CORO_REENTER(*this)
+        {
+            for(;;)
+            {
+                offset_ = b_.size();
+                BOOST_ASIO_CORO_YIELD
+                {
+                    BOOST_ASIO_HANDLER_LOCATION((
+                        __FILE__, __LINE__,
+                        "websocket::async_read_many"));
+
+                    read_op<read_many_op, DynamicBuffer>(
+                        std::move(*this), sp, b_, 0, false);
+                }
+                bytes_written_ += bytes_transferred;
+                if(ec)
+                    break;
+                v_.push_back({offset_, bytes_transferred,
+                    impl.rd_op == detail::opcode::binary});
+
+                // Only take messages already received
+                if( v_.size() >= max_ ||
+                    ! impl.rd_peek_message())
+                    break;
+            }
+            this->complete(cont, ec, bytes_written_);
+        }
+    }
+};
+
+template<class NextLayer, bool deflateSupported, class Role>
+struct stream<NextLayer, deflateSupported, Role>::
     run_read_some_op
 {
     template<
@@ -824,8 +946,8 @@ struct stream<NextLayer, deflateSupported>::
     }
 };
 
-template<class NextLayer, bool deflateSupported>
-struct stream<NextLayer, deflateSupported>::
+template<class NextLayer, bool deflateSupported, class Role>
+struct stream<NextLayer, deflateSupported, Role>::
     run_read_op
 {
     template<
@@ -859,12 +981,47 @@ struct stream<NextLayer, deflateSupported>::
     }
 };
 
+template<class NextLayer, bool deflateSupported, class Role>
+struct stream<NextLayer, deflateSupported, Role>::
+    run_read_many_op
+{
+    template<
+        class ReadHandler,
+        class DynamicBuffer>
+    void
+    operator()(
+        ReadHandler&& h,
+        boost::shared_ptr<impl_type> const& sp,
+        DynamicBuffer* b,
+        std::vector<message_info>* v,
+        std::size_t max_messages)
+    {
+        // If you get an error on the following line it means
+        // that your handler does not meet the documented type
+        // requirements for the handler.
+
+        static_assert(
+            beast::detail::is_invocable<ReadHandler,
+                void(error_code, std::size_t)>::value,
+            "ReadHandler type requirements not met");
+
+        read_many_op<
+            typename std::decay<ReadHandler>::type,
+            DynamicBuffer>(
+                std::forward<ReadHandler>(h),
+                sp,
+                *b,
+                *v,
+                max_messages);
+    }
+};
+
 //------------------------------------------------------------------------------
 
-template<class NextLayer, bool deflateSupported>
+template<class NextLayer, bool deflateSupported, class Role>
 template<class DynamicBuffer>
 std::size_t
-stream<NextLayer, deflateSupported>::
+stream<NextLayer, deflateSupported, Role>::
 read(DynamicBuffer& buffer)
 {
     static_assert(is_sync_stream<next_layer_type>::value,
@@ -879,10 +1036,10 @@ read(DynamicBuffer& buffer)
     return bytes_written;
 }
 
-template<class NextLayer, bool deflateSupported>
+template<class NextLayer, bool deflateSupported, class Role>
 template<class DynamicBuffer>
 std::size_t
-stream<NextLayer, deflateSupported>::
+stream<NextLayer, deflateSupported, Role>::
 read(DynamicBuffer& buffer, error_code& ec)
 {
     static_assert(is_sync_stream<next_layer_type>::value,
@@ -901,10 +1058,10 @@ read(DynamicBuffer& buffer, error_code& ec)
     return bytes_written;
 }
 
-template<class NextLayer, bool deflateSupported>
+template<class NextLayer, bool deflateSupported, class Role>
 template<class DynamicBuffer, BOOST_BEAST_ASYNC_TPARAM2 ReadHandler>
 BOOST_BEAST_ASYNC_RESULT2(ReadHandler)
-stream<NextLayer, deflateSupported>::
+stream<NextLayer, deflateSupported, Role>::
 async_read(DynamicBuffer& buffer, ReadHandler&& handler)
 {
     static_assert(is_async_stream<next_layer_type>::value,
@@ -925,10 +1082,96 @@ async_read(DynamicBuffer& buffer, ReadHandler&& handler)
 
 //------------------------------------------------------------------------------
 
-template<class NextLayer, bool deflateSupported>
+template<class NextLayer, bool deflateSupported, class Role>
+template<class DynamicBuffer>
+std::size_t
+stream<NextLayer, deflateSupported, Role>::
+read_many(
+    DynamicBuffer& buffer,
+    std::vector<message_info>& messages,
+    std::size_t max_messages)
+{
+    static_assert(is_sync_stream<next_layer_type>::value,
+        "SyncStream type requirements not met");
+    static_assert(
+        net::is_dynamic_buffer<DynamicBuffer>::value,
+        "DynamicBuffer type requirements not met");
+    error_code ec;
+    auto const bytes_written =
+        read_many(buffer, messages, max_messages, ec);
+    if(ec)
+        BOOST_THROW_EXCEPTION(system_error{ec});
+    return bytes_written;
+}
+
+template<class NextLayer, bool deflateSupported, class Role>
+template<class DynamicBuffer>
+std::size_t
+stream<NextLayer, deflateSupported, Role>::
+read_many(
+    DynamicBuffer& buffer,
+    std::vector<message_info>& messages,
+    std::size_t max_messages,
+    error_code& ec)
+{
+    static_assert(is_sync_stream<next_layer_type>::value,
+        "SyncStream type requirements not met");
+    static_assert(
+        net::is_dynamic_buffer<DynamicBuffer>::value,
+        "DynamicBuffer type requirements not met");
+    BOOST_ASSERT(max_messages > 0);
+    messages.clear();
+    std::size_t bytes_written = 0;
+    for(;;)
+    {
+        auto const offset = buffer.size();
+        auto const n = read(buffer, ec);
+        bytes_written += n;
+        if(ec)
+            break;
+        messages.push_back({offset, n,
+            impl_->rd_op == detail::opcode::binary});
+
+        // Only take messages already received
+        if( messages.size() >= max_messages ||
+            ! impl_->rd_peek_message())
+            break;
+    }
+    return bytes_written;
+}
+
+template<class NextLayer, bool deflateSupported, class Role>
+template<class DynamicBuffer, BOOST_BEAST_ASYNC_TPARAM2 ReadHandler>
+BOOST_BEAST_ASYNC_RESULT2(ReadHandler)
+stream<NextLayer, deflateSupported, Role>::
+async_read_many(
+    DynamicBuffer& buffer,
+    std::vector<message_info>& messages,
+    std::size_t max_messages,
+    ReadHandler&& handler)
+{
+    static_assert(is_async_stream<next_layer_type>::value,
+        "AsyncStream type requirements not met");
+    static_assert(
+        net::is_dynamic_buffer<DynamicBuffer>::value,
+        "DynamicBuffer type requirements not met");
+    return net::async_initiate<
+        ReadHandler,
+        void(error_code, std::size_t)>(
+            run_read_many_op{},
+            handler,
+            impl_,
+            &buffer,
+            &messages,
+            max_messages);
+}
+
+//------------------------------------------------------------------------------
+
+template<class NextLayer, bool deflateSupported, class Role>
 template<class DynamicBuffer>
 std::size_t
-stream<NextLayer, deflateSupported>::
+stream<NextLayer, deflateSupported, Role>::
 read_some(
     DynamicBuffer& buffer,
     std::size_t limit)
@@ -946,10 +1189,10 @@ read_some(
     return bytes_written;
 }
 
-template<class NextLayer, bool deflateSupported>
+template<class NextLayer, bool deflateSupported, class Role>
 template<class DynamicBuffer>
 std::size_t
-stream<NextLayer, deflateSupported>::
+stream<NextLayer, deflateSupported, Role>::
 read_some(
     DynamicBuffer& buffer,
     std::size_t limit,
@@ -975,10 +1218,10 @@ read_some(
     return bytes_written;
 }
 
-template<class NextLayer, bool deflateSupported>
+template<class NextLayer, bool deflateSupported, class Role>
 template<class DynamicBuffer, BOOST_BEAST_ASYNC_TPARAM2 ReadHandler>
 BOOST_BEAST_ASYNC_RESULT2(ReadHandler)
-stream<NextLayer, deflateSupported>::
+stream<NextLayer, deflateSupported, Role>::
 async_read_some(
     DynamicBuffer& buffer,
     std::size_t limit,
@@ -1002,10 +1245,10 @@ async_read_some(
 
 //------------------------------------------------------------------------------
 
-template<class NextLayer, bool deflateSupported>
+template<class NextLayer, bool deflateSupported, class Role>
 template<class MutableBufferSequence>
 std::size_t
-stream<NextLayer, deflateSupported>::
+stream<NextLayer, deflateSupported, Role>::
 read_some(
     MutableBufferSequence const& buffers)
 {
@@ -1021,10 +1264,10 @@ read_some(
     return bytes_written;
 }
 
-template<class NextLayer, bool deflateSupported>
+template<class NextLayer, bool deflateSupported, class Role>
 template<class MutableBufferSequence>
 std::size_t
-stream<NextLayer, deflateSupported>::
+stream<NextLayer, deflateSupported, Role>::
 read_some(
     MutableBufferSequence const& buffers,
     error_code& ec)
@@ -1038,6 +1281,7 @@ read_some(
     auto& impl = *impl_;
     close_code code{};
     std::size_t bytes_written = 0;
+    buffers_suffix<MutableBufferSequence> cb(buffers);
     ec = {};
     // Make sure the stream is open
     if(impl.check_stop_now(ec))
@@ -1050,6 +1294,17 @@ loop:
     if(impl.rd_remain == 0 && (
         ! impl.rd_fh.fin || impl.rd_done))
     {
+        if(bytes_written > 0)
+        {
+            // Deliver the payload already copied rather
+            // than wait for the rest of the next frame,
+            // or handle a control frame behind it.
+            detail::opcode op;
+            if( ! impl.rd_peek(op) ||
+                op != detail::opcode::cont)
+                return bytes_written;
+        }
+
         // Read frame header
         error_code result;
         while(! impl.parse_fh(impl.rd_fh, impl.rd_buf, result))
@@ -1064,6 +1319,12 @@ loop:
                 do_fail(code, result, ec);
                 return bytes_written;
             }
+            if(impl.release_rd_buf())
+            {
+                beast::detail::wait_read(impl.stream(), ec);
+                if(impl.check_stop_now(ec))
+                    return bytes_written;
+            }
             auto const bytes_transferred =
                 impl.stream().read_some(
                     impl.rd_buf.prepare(read_size(
@@ -1075,10 +1336,15 @@ loop:
         }
         // Immediately apply the mask to the portion
         // of the buffer holding payload data.
-        if(impl.rd_fh.len > 0 && impl.rd_fh.mask)
-            detail::mask_inplace(buffers_prefix(
-                clamp(impl.rd_fh.len), impl.rd_buf.data()),
-                    impl.rd_key);
+        if(impl.rd_fh.len > 0 && ! impl.rd_unmask(
+            buffers_prefix(clamp(impl.rd_fh.len),
+                impl.rd_buf.data())))
+        {
+            // _Fail the WebSocket Connection_
+            do_fail(close_code::bad_payload,
+                error::bad_frame_payload, ec);
+            return bytes_written;
+        }
         if(detail::is_control(impl.rd_fh.op))
         {
             // Get control frame payload
@@ -1104,6 +1370,15 @@ loop:
                 }
                 if(impl.ctrl_cb)
                     impl.ctrl_cb(frame_type::ping, to_string_view(payload));
+                // Answer only the last of several pings
+                // in the read buffer, rfc6455 5.5.3 allows
+                // leaving the earlier ones unanswered.
+                {
+                    detail::opcode op;
+                    if( impl.rd_peek(op) &&
+                        op == detail::opcode::ping)
+                        goto loop;
+                }
                 detail::frame_buffer fb;
                 impl.template write_ping<flat_static_buffer_base>(fb,
                     detail::opcode::pong, payload);
@@ -1167,7 +1442,7 @@ loop:
         {
             if(impl.rd_buf.size() == 0 && impl.rd_buf.max_size() >
                 (std::min)(clamp(impl.rd_remain),
-                    buffer_bytes(buffers)))
+                    buffer_bytes(cb)))
             {
                 // Fill the read buffer first, otherwise we
                 // get fewer bytes at the cost of one I/O.
@@ -1176,75 +1451,76 @@ loop:
                         impl.rd_buf.max_size())), ec));
                 if(impl.check_stop_now(ec))
                     return bytes_written;
-                if(impl.rd_fh.mask)
-                    detail::mask_inplace(
-                        buffers_prefix(clamp(impl.rd_remain),
-                            impl.rd_buf.data()), impl.rd_key);
+                if(! impl.rd_unmask(buffers_prefix(
+                    clamp(impl.rd_remain), impl.rd_buf.data())))
+                {
+                    // _Fail the WebSocket Connection_
+                    do_fail(close_code::bad_payload,
+                        error::bad_frame_payload, ec);
+                    return bytes_written;
+                }
             }
             if(impl.rd_buf.size() > 0)
             {
                 // Copy from the read buffer.
                 // The mask was already applied.
                 auto const bytes_transferred = net::buffer_copy(
-                    buffers, impl.rd_buf.data(),
+                    cb, impl.rd_buf.data(),
                         clamp(impl.rd_remain));
                 auto const mb = buffers_prefix(
-                    bytes_transferred, buffers);
+                    bytes_transferred, cb);
                 impl.rd_remain -= bytes_transferred;
-                if(impl.rd_op == detail::opcode::text)
+                if(! impl.rd_check_utf8(mb))
                 {
-                    if(! impl.rd_utf8.write(mb) ||
-                        (impl.rd_remain == 0 && impl.rd_fh.fin &&
-                            ! impl.rd_utf8.finish()))
-                    {
-                        // _Fail the WebSocket Connection_
-                        do_fail(close_code::bad_payload,
-                            error::bad_frame_payload, ec);
-                        return bytes_written;
-                    }
+                    // _Fail the WebSocket Connection_
+                    do_fail(close_code::bad_payload,
+                        error::bad_frame_payload, ec);
+                    return bytes_written;
                 }
                 bytes_written += bytes_transferred;
                 impl.rd_size += bytes_transferred;
                 impl.rd_buf.consume(bytes_transferred);
+                cb.consume(bytes_transferred);
             }
             else
             {
                 // Read into caller's buffer
                 BOOST_ASSERT(impl.rd_remain > 0);
-                BOOST_ASSERT(buffer_bytes(buffers) > 0);
+                BOOST_ASSERT(buffer_bytes(cb) > 0);
                 BOOST_ASSERT(buffer_bytes(buffers_prefix(
-                    clamp(impl.rd_remain), buffers)) > 0);
+                    clamp(impl.rd_remain), cb)) > 0);
                 auto const bytes_transferred =
                     impl.stream().read_some(buffers_prefix(
-                        clamp(impl.rd_remain), buffers), ec);
+                        clamp(impl.rd_remain), cb), ec);
                 // VFALCO What if some bytes were written?
                 if(impl.check_stop_now(ec))
                     return bytes_written;
                 BOOST_ASSERT(bytes_transferred > 0);
                 auto const mb = buffers_prefix(
-                    bytes_transferred, buffers);
+                    bytes_transferred, cb);
                 impl.rd_remain -= bytes_transferred;
-                if(impl.rd_fh.mask)
-                    detail::mask_inplace(mb, impl.rd_key);
-                if(impl.rd_op == detail::opcode::text)
+                if( ! impl.rd_unmask(mb) ||
+                    ! impl.rd_check_utf8(mb))
                 {
-                    if(! impl.rd_utf8.write(mb) ||
-                        (impl.rd_remain == 0 && impl.rd_fh.fin &&
-                            ! impl.rd_utf8.finish()))
-                    {
-                        // _Fail the WebSocket Connection_
-                        do_fail(close_code::bad_payload,
-                            error::bad_frame_payload, ec);
-                        return bytes_written;
-                    }
+                    // _Fail the WebSocket Connection_
+                    do_fail(close_code::bad_payload,
+                        error::bad_frame_payload, ec);
+                    return bytes_written;
                 }
                 bytes_written += bytes_transferred;
                 impl.rd_size += bytes_transferred;
+                cb.consume(bytes_transferred);
             }
         }
         BOOST_ASSERT( ! impl.rd_done );
         if( impl.rd_remain == 0 && impl.rd_fh.fin )
             impl.rd_done = true;
+        // Go on with the next frames of the message which
+        // are already in the read buffer, so that a burst
+        // of small frames is delivered by one call.
+        if( ! impl.rd_done && impl.rd_remain == 0 &&
+            buffer_bytes(cb) > 0)
+            goto loop;
     }
     else
     {
@@ -1253,7 +1529,6 @@ loop:
         // never emit the end-of-stream deflate block.
         //
         bool did_read = false;
-        buffers_suffix<MutableBufferSequence> cb(buffers);
         while(buffer_bytes(cb) > 0)
         {
             zlib::z_params zs;
@@ -1357,10 +1632,10 @@ loop:
     return bytes_written;
 }
 
-template<class NextLayer, bool deflateSupported>
+template<class NextLayer, bool deflateSupported, class Role>
 template<class MutableBufferSequence, BOOST_BEAST_ASYNC_TPARAM2 ReadHandler>
 BOOST_BEAST_ASYNC_RESULT2(ReadHandler)
-stream<NextLayer, deflateSupported>::
+stream<NextLayer, deflateSupported, Role>::
 async_read_some(
     MutableBufferSequence const& buffers,
     ReadHandler&& handler)
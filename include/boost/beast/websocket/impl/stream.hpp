@@ -39,17 +39,17 @@ namespace boost {
 namespace beast {
 namespace websocket {
 
-template<class NextLayer, bool deflateSupported>
-stream<NextLayer, deflateSupported>::
+template<class NextLayer, bool deflateSupported, class Role>
+stream<NextLayer, deflateSupported, Role>::
 ~stream()
 {
     if(impl_)
         impl_->remove();
 }
 
-template<class NextLayer, bool deflateSupported>
+template<class NextLayer, bool deflateSupported, class Role>
 template<class... Args>
-stream<NextLayer, deflateSupported>::
+stream<NextLayer, deflateSupported, Role>::
 stream(Args&&... args)
     : impl_(boost::make_shared<impl_type>(
         std::forward<Args>(args)...))
@@ -58,68 +58,68 @@ stream(Args&&... args)
         max_control_frame_size);
 }
 
-template<class NextLayer, bool deflateSupported>
+template<class NextLayer, bool deflateSupported, class Role>
 auto
-stream<NextLayer, deflateSupported>::
+stream<NextLayer, deflateSupported, Role>::
 get_executor() noexcept ->
     executor_type
 {
     return impl_->stream().get_executor();
 }
 
-template<class NextLayer, bool deflateSupported>
+template<class NextLayer, bool deflateSupported, class Role>
 auto
-stream<NextLayer, deflateSupported>::
+stream<NextLayer, deflateSupported, Role>::
 next_layer() noexcept ->
     next_layer_type&
 {
     return impl_->stream();
 }
 
-template<class NextLayer, bool deflateSupported>
+template<class NextLayer, bool deflateSupported, class Role>
 auto
-stream<NextLayer, deflateSupported>::
+stream<NextLayer, deflateSupported, Role>::
 next_layer() const noexcept ->
     next_layer_type const&
 {
     return impl_->stream();
 }
 
-template<class NextLayer, bool deflateSupported>
+template<class NextLayer, bool deflateSupported, class Role>
 bool
-stream<NextLayer, deflateSupported>::
+stream<NextLayer, deflateSupported, Role>::
 is_open() const noexcept
 {
     return impl_->status_ == status::open;
 }
 
-template<class NextLayer, bool deflateSupported>
+template<class NextLayer, bool deflateSupported, class Role>
 bool
-stream<NextLayer, deflateSupported>::
+stream<NextLayer, deflateSupported, Role>::
 got_binary() const noexcept
 {
     return impl_->rd_op == detail::opcode::binary;
 }
 
-template<class NextLayer, bool deflateSupported>
+template<class NextLayer, bool deflateSupported, class Role>
 bool
-stream<NextLayer, deflateSupported>::
+stream<NextLayer, deflateSupported, Role>::
 is_message_done() const noexcept
 {
     return impl_->rd_done;
 }
 
-template<class NextLayer, bool deflateSupported>
+template<class NextLayer, bool deflateSupported, class Role>
 close_reason const&
-stream<NextLayer, deflateSupported>::
+stream<NextLayer, deflateSupported, Role>::
 reason() const noexcept
 {
     return impl_->cr;
 }
 
-template<class NextLayer, bool deflateSupported>
+template<class NextLayer, bool deflateSupported, class Role>
 std::size_t
-stream<NextLayer, deflateSupported>::
+stream<NextLayer, deflateSupported, Role>::
 read_size_hint(
     std::size_t initial_size) const
 {
@@ -128,10 +128,10 @@ read_size_hint(
         impl_->rd_remain, impl_->rd_fh);
 }
 
-template<class NextLayer, bool deflateSupported>
+template<class NextLayer, bool deflateSupported, class Role>
 template<class DynamicBuffer, class>
 std::size_t
-stream<NextLayer, deflateSupported>::
+stream<NextLayer, deflateSupported, Role>::
 read_size_hint(DynamicBuffer& buffer) const
 {
     static_assert(
@@ -148,9 +148,9 @@ read_size_hint(DynamicBuffer& buffer) const
 
 // decorator
 
-template<class NextLayer, bool deflateSupported>
+template<class NextLayer, bool deflateSupported, class Role>
 void
-stream<NextLayer, deflateSupported>::
+stream<NextLayer, deflateSupported, Role>::
 set_option(decorator opt)
 {
     impl_->decorator_opt = std::move(opt.d_);
@@ -158,59 +158,74 @@ set_option(decorator opt)
 
 // timeout
 
-template<class NextLayer, bool deflateSupported>
+template<class NextLayer, bool deflateSupported, class Role>
 void
-stream<NextLayer, deflateSupported>::
+stream<NextLayer, deflateSupported, Role>::
 get_option(timeout& opt)
 {
     opt = impl_->timeout_opt;
 }
 
-template<class NextLayer, bool deflateSupported>
+template<class NextLayer, bool deflateSupported, class Role>
 void
-stream<NextLayer, deflateSupported>::
+stream<NextLayer, deflateSupported, Role>::
 set_option(timeout const& opt)
 {
     impl_->set_option(opt);
 }
 
+template<class NextLayer, bool deflateSupported, class Role>
+void
+stream<NextLayer, deflateSupported, Role>::
+use_timeout_service(timeout_service& svc)
+{
+    // If assert goes off, it means that there
+    // are asynchronous operations outstanding.
+    BOOST_ASSERT(
+        ! impl_->wr_block.is_locked() &&
+        ! impl_->rd_block.is_locked());
+
+    impl_->timer_stop();
+    impl_->wheel = &svc;
+}
+
 //
 
-template<class NextLayer, bool deflateSupported>
+template<class NextLayer, bool deflateSupported, class Role>
 void
-stream<NextLayer, deflateSupported>::
+stream<NextLayer, deflateSupported, Role>::
 set_option(permessage_deflate const& o)
 {
     impl_->set_option_pmd(o);
 }
 
-template<class NextLayer, bool deflateSupported>
+template<class NextLayer, bool deflateSupported, class Role>
 void
-stream<NextLayer, deflateSupported>::
+stream<NextLayer, deflateSupported, Role>::
 get_option(permessage_deflate& o)
 {
     impl_->get_option_pmd(o);
 }
 
-template<class NextLayer, bool deflateSupported>
+template<class NextLayer, bool deflateSupported, class Role>
 void
-stream<NextLayer, deflateSupported>::
+stream<NextLayer, deflateSupported, Role>::
 auto_fragment(bool value)
 {
     impl_->wr_frag_opt = value;
 }
 
-template<class NextLayer, bool deflateSupported>
+template<class NextLayer, bool deflateSupported, class Role>
 bool
-stream<NextLayer, deflateSupported>::
+stream<NextLayer, deflateSupported, Role>::
 auto_fragment() const
 {
     return impl_->wr_frag_opt;
 }
 
-template<class NextLayer, bool deflateSupported>
+template<class NextLayer, bool deflateSupported, class Role>
 void
-stream<NextLayer, deflateSupported>::
+stream<NextLayer, deflateSupported, Role>::
 binary(bool value)
 {
     impl_->wr_opcode = value ?
@@ -218,58 +233,76 @@ binary(bool value)
         detail::opcode::text;
 }
 
-template<class NextLayer, bool deflateSupported>
+template<class NextLayer, bool deflateSupported, class Role>
 bool
-stream<NextLayer, deflateSupported>::
+stream<NextLayer, deflateSupported, Role>::
 binary() const
 {
     return impl_->wr_opcode == detail::opcode::binary;
 }
 
-template<class NextLayer, bool deflateSupported>
+template<class NextLayer, bool deflateSupported, class Role>
 void
-stream<NextLayer, deflateSupported>::
+stream<NextLayer, deflateSupported, Role>::
 control_callback(std::function<
     void(frame_type, string_view)> cb)
 {
     impl_->ctrl_cb = std::move(cb);
 }
 
-template<class NextLayer, bool deflateSupported>
+template<class NextLayer, bool deflateSupported, class Role>
 void
-stream<NextLayer, deflateSupported>::
+stream<NextLayer, deflateSupported, Role>::
 control_callback()
 {
     impl_->ctrl_cb = {};
 }
 
-template<class NextLayer, bool deflateSupported>
+template<class NextLayer, bool deflateSupported, class Role>
 void
-stream<NextLayer, deflateSupported>::
+stream<NextLayer, deflateSupported, Role>::
 read_message_max(std::size_t amount)
 {
     impl_->rd_msg_max = amount;
 }
 
-template<class NextLayer, bool deflateSupported>
+template<class NextLayer, bool deflateSupported, class Role>
 std::size_t
-stream<NextLayer, deflateSupported>::
+stream<NextLayer, deflateSupported, Role>::
 read_message_max() const
 {
     return impl_->rd_msg_max;
 }
 
-template<class NextLayer, bool deflateSupported>
+template<class NextLayer, bool deflateSupported, class Role>
 void
-stream<NextLayer, deflateSupported>::
+stream<NextLayer, deflateSupported, Role>::
 secure_prng(bool value)
 {
     this->impl_->secure_prng_ = value;
 }
 
-template<class NextLayer, bool deflateSupported>
+template<class NextLayer, bool deflateSupported, class Role>
+void
+stream<NextLayer, deflateSupported, Role>::
+pooled_read_buffer(bool value)
+{
+    impl_->rd_pool = value;
+    if(value)
+        impl_->rd_buf.release();
+}
+
+template<class NextLayer, bool deflateSupported, class Role>
+bool
+stream<NextLayer, deflateSupported, Role>::
+pooled_read_buffer() const
+{
+    return impl_->rd_pool;
+}
+
+template<class NextLayer, bool deflateSupported, class Role>
 void
-stream<NextLayer, deflateSupported>::
+stream<NextLayer, deflateSupported, Role>::
 write_buffer_bytes(std::size_t amount)
 {
     if(amount < 8)
@@ -278,17 +311,17 @@ write_buffer_bytes(std::size_t amount)
     impl_->wr_buf_opt = amount;
 }
 
-template<class NextLayer, bool deflateSupported>
+template<class NextLayer, bool deflateSupported, class Role>
 std::size_t
-stream<NextLayer, deflateSupported>::
+stream<NextLayer, deflateSupported, Role>::
 write_buffer_bytes() const
 {
     return impl_->wr_buf_opt;
 }
 
-template<class NextLayer, bool deflateSupported>
+template<class NextLayer, bool deflateSupported, class Role>
 void
-stream<NextLayer, deflateSupported>::
+stream<NextLayer, deflateSupported, Role>::
 text(bool value)
 {
     impl_->wr_opcode = value ?
@@ -296,20 +329,44 @@ text(bool value)
         detail::opcode::binary;
 }
 
-template<class NextLayer, bool deflateSupported>
+template<class NextLayer, bool deflateSupported, class Role>
 bool
-stream<NextLayer, deflateSupported>::
+stream<NextLayer, deflateSupported, Role>::
 text() const
 {
     return impl_->wr_opcode == detail::opcode::text;
 }
 
+template<class NextLayer, bool deflateSupported, class Role>
+void
+stream<NextLayer, deflateSupported, Role>::
+send_queue_limit(std::size_t amount)
+{
+    impl_->send_limit = amount;
+}
+
+template<class NextLayer, bool deflateSupported, class Role>
+std::size_t
+stream<NextLayer, deflateSupported, Role>::
+send_queue_limit() const
+{
+    return impl_->send_limit;
+}
+
+template<class NextLayer, bool deflateSupported, class Role>
+std::size_t
+stream<NextLayer, deflateSupported, Role>::
+send_queue_size() const
+{
+    return impl_->send_size();
+}
+
 //------------------------------------------------------------------------------
 
 // _Fail the WebSocket Connection_
-template<class NextLayer, bool deflateSupported>
+template<class NextLayer, bool deflateSupported, class Role>
 void
-stream<NextLayer, deflateSupported>::
+stream<NextLayer, deflateSupported, Role>::
 do_fail(
     std::uint16_t code,         // if set, send a close frame first
     error_code ev,              // error code to use upon success
@@ -22,27 +22,35 @@
 #include <boost/beast/http/read.hpp>
 #include <boost/beast/http/write.hpp>
 #include <boost/beast/http/rfc7230.hpp>
+#include <boost/beast/core/bind_handler.hpp>
 #include <boost/beast/core/buffers_cat.hpp>
 #include <boost/beast/core/buffers_prefix.hpp>
 #include <boost/beast/core/buffers_suffix.hpp>
+#include <boost/beast/core/flat_buffer.hpp>
 #include <boost/beast/core/flat_static_buffer.hpp>
 #include <boost/beast/core/saved_handler.hpp>
 #include <boost/beast/core/static_buffer.hpp>
 #include <boost/beast/core/stream_traits.hpp>
+#include <boost/beast/core/timeout_service.hpp>
 #include <boost/beast/core/detail/clamp.hpp>
+#include <boost/beast/core/detail/post_expiry.hpp>
+#include <boost/beast/core/detail/pooled_static_buffer.hpp>
+#include <boost/beast/core/detail/wait_read.hpp>
+#include <boost/asio/post.hpp>
 #include <boost/asio/steady_timer.hpp>
 #include <boost/core/empty_value.hpp>
 #include <boost/enable_shared_from_this.hpp>
 #include <boost/shared_ptr.hpp>
 #include <boost/optional.hpp>
+#include <deque>
 
 namespace boost {
 namespace beast {
 namespace websocket {
 
 template<
-    class NextLayer, bool deflateSupported>
-struct stream<NextLayer, deflateSupported>::impl_type
+    class NextLayer, bool deflateSupported, class Role>
+struct stream<NextLayer, deflateSupported, Role>::impl_type
     : boost::empty_value<NextLayer>
     , detail::service::impl_type
     , detail::impl_base<deflateSupported>
@@ -69,7 +77,24 @@ struct stream<NextLayer, deflateSupported>::impl_type
                 impl_type::shared_from_this());
     }
 
+    // The timeout, when tracked by a timeout_service
+    struct wheel_entry_type : timeout_service::entry
+    {
+        impl_type* impl = nullptr;
+        std::uint64_t gen = 0;
+        time_point expiry = never();
+
+        wheel_entry_type() noexcept
+            : timeout_service::entry(&on_expire)
+        {
+        }
+
+        static void on_expire(timeout_service::entry& e);
+    };
+
     net::steady_timer       timer;          // used for timeouts
+    timeout_service*        wheel = nullptr; // used for timeouts instead of timer
+    wheel_entry_type        wheel_entry;    // armed with the wheel
     close_reason            cr;             // set from received close frame
     control_cb_type         ctrl_cb;        // control callback
 
@@ -80,12 +105,13 @@ struct stream<NextLayer, deflateSupported>::impl_type
     detail::prepared_key    rd_key;         // current stateful mask key
     detail::frame_buffer    rd_fb;          // to write control frames (during reads)
     detail::utf8_checker    rd_utf8;        // to validate utf8
-    static_buffer<
+    beast::detail::pooled_static_buffer<
         +tcp_frame_size>    rd_buf;         // buffer for reads
     detail::opcode          rd_op           /* current message binary or text */ = detail::opcode::text;
     bool                    rd_cont         /* `true` if the next frame is a continuation */ = false;
     bool                    rd_done         /* set when a message is done */ = true;
     bool                    rd_close        /* did we read a close frame? */ = false;
+    bool                    rd_pool         /* release rd_buf while idle */ = false;
     detail::soft_mutex      rd_block;       // op currently reading
 
     role_type               role            /* server or client */ = role_type::client;
@@ -104,6 +130,15 @@ struct stream<NextLayer, deflateSupported>::impl_type
     std::size_t             wr_buf_size     /* write buffer size (current message) */ = 0;
     std::size_t             wr_buf_opt      /* write buffer size option setting */ = 4096;
     detail::fh_buffer       wr_fb;          // header buffer used for writes
+    detail::frame_buffer    idle_ping_fb;   // idle ping frame
+
+    flat_buffer             send_buf;       // frames queued by async_send
+    flat_buffer             send_out;       // queued frames being written
+    std::size_t             send_limit      /* send queue high-water mark */ = 65536;
+    bool                    send_flushing   /* is a send_flush_op running? */ = false;
+    bool                    send_closed     /* was a close started? */ = false;
+    std::deque<
+        saved_handler>      send_wait;      // async_send ops over the limit
 
     saved_handler           op_rd;          // paused read op
     saved_handler           op_wr;          // paused write op
@@ -112,6 +147,7 @@ struct stream<NextLayer, deflateSupported>::impl_type
     saved_handler           op_close;       // paused close op
     saved_handler           op_r_rd;        // paused read op (async read)
     saved_handler           op_r_close;     // paused close op (async read)
+    saved_handler           op_send;        // paused send_flush op
 
     bool    idle_pinging = false;
     bool    secure_prng_ = true;
@@ -147,13 +183,23 @@ struct stream<NextLayer, deflateSupported>::impl_type
         op_close.reset();
         op_r_rd.reset();
         op_r_close.reset();
+        op_send.reset();
+        send_wait.clear();
+    }
+
+    // `true` in the client role, a constant
+    // when the stream is restricted to one role
+    bool
+    is_client() const noexcept
+    {
+        return detail::is_client(Role{}, role);
     }
 
     void
     open(role_type role_)
     {
         // VFALCO TODO analyze and remove dupe code in reset()
-        timer.expires_at(never());
+        timer_stop();
         timed_out = false;
         cr.code = close_code::none;
         role = role_;
@@ -166,6 +212,7 @@ struct stream<NextLayer, deflateSupported>::impl_type
         rd_fh.fin = false;
         rd_close = false;
         wr_close = false;
+        send_closed = false;
         // These should not be necessary, because all completion
         // handlers must be allowed to execute otherwise the
         // stream exhibits undefined behavior.
@@ -174,6 +221,8 @@ struct stream<NextLayer, deflateSupported>::impl_type
 
         wr_cont = false;
         wr_buf_size = 0;
+        send_buf.clear();
+        send_out.clear();
 
         this->open_pmd(role);
     }
@@ -181,7 +230,7 @@ struct stream<NextLayer, deflateSupported>::impl_type
     void
     close()
     {
-        timer.cancel();
+        timer_cancel();
         wr_buf.reset();
         this->close_pmd();
     }
@@ -190,15 +239,18 @@ struct stream<NextLayer, deflateSupported>::impl_type
     reset()
     {
         BOOST_ASSERT(status_ != status::open);
-        timer.expires_at(never());
+        timer_stop();
         cr.code = close_code::none;
         rd_remain = 0;
         rd_cont = false;
         rd_done = true;
         rd_buf.consume(rd_buf.size());
+        if(rd_pool)
+            rd_buf.release();
         rd_fh.fin = false;
         rd_close = false;
         wr_close = false;
+        send_closed = false;
         wr_cont = false;
         // These should not be necessary, because all completion
         // handlers must be allowed to execute otherwise the
@@ -207,7 +259,7 @@ struct stream<NextLayer, deflateSupported>::impl_type
         rd_block.reset();
 
         // VFALCO Is this needed?
-        timer.cancel();
+        timer_cancel();
     }
 
     void
@@ -229,7 +281,7 @@ struct stream<NextLayer, deflateSupported>::impl_type
 
         // Maintain the write buffer
         if( this->pmd_enabled() ||
-            role == role_type::client)
+            is_client())
         {
             if(! wr_buf ||
                 wr_buf_size != wr_buf_opt)
@@ -278,6 +330,95 @@ struct stream<NextLayer, deflateSupported>::impl_type
     parse_fh(detail::frame_header& fh,
         DynamicBuffer& b, error_code& ec);
 
+    // Returns `true` if the read buffer holds the whole
+    // next frame, and sets `op` to its opcode. Nothing
+    // is validated, that is left to parse_fh.
+    bool
+    rd_peek(detail::opcode& op) const
+    {
+        std::uint8_t h[14];
+        auto const n = net::buffer_copy(
+            net::buffer(h), rd_buf.data());
+        if(n < 2)
+            return false;
+        std::uint64_t len = h[1] & 0x7f;
+        std::size_t need = 2;
+        if(len == 126)
+        {
+            need += 2;
+            if(n < need)
+                return false;
+            len = (std::uint64_t{h[2]} << 8) | h[3];
+        }
+        else if(len == 127)
+        {
+            need += 8;
+            if(n < need)
+                return false;
+            len = 0;
+            for(int i = 2; i < 10; ++i)
+                len = (len << 8) | h[i];
+        }
+        if(h[1] & 0x80)
+            need += 4;
+        if(rd_buf.size() < need)
+            return false;
+        op = static_cast<detail::opcode>(h[0] & 0x0f);
+        return len <= rd_buf.size() - need;
+    }
+
+    // Returns `true` if the read buffer holds the whole
+    // next frame, and it is a data frame with the FIN bit
+    // set, which is a complete message by itself.
+    bool
+    rd_peek_message() const
+    {
+        detail::opcode op;
+        if(! rd_peek(op))
+            return false;
+        if( op != detail::opcode::text &&
+            op != detail::opcode::binary)
+            return false;
+        std::uint8_t h;
+        net::buffer_copy(
+            net::buffer(&h, 1), rd_buf.data());
+        return (h & 0x80) != 0;
+    }
+
+    // Remove the mask from payload of the current frame.
+    // Uncompressed text is validated in the same pass.
+    // Returns `false` if the text is not valid utf8.
+    template<class MutableBufferSequence>
+    bool
+    rd_unmask(MutableBufferSequence const& buffers)
+    {
+        // parse_fh rejects masked frames in the client role
+        if(is_client() || ! rd_fh.mask)
+            return true;
+        if( rd_op == detail::opcode::text &&
+            ! detail::is_control(rd_fh.op) &&
+            ! this->rd_deflated())
+            return detail::mask_utf8_inplace(
+                buffers, rd_key, rd_utf8);
+        detail::mask_inplace(buffers, rd_key);
+        return true;
+    }
+
+    // Validate uncompressed payload of the current frame
+    // handed to the caller. Masked text was already checked
+    // by rd_unmask. Returns `false` if the text is not valid.
+    template<class ConstBufferSequence>
+    bool
+    rd_check_utf8(ConstBufferSequence const& buffers)
+    {
+        if(rd_op != detail::opcode::text)
+            return true;
+        if(! rd_fh.mask && ! rd_utf8.write(buffers))
+            return false;
+        return rd_remain > 0 || ! rd_fh.fin ||
+            rd_utf8.finish();
+    }
+
     std::uint32_t
     create_mask()
     {
@@ -309,6 +450,41 @@ struct stream<NextLayer, deflateSupported>::impl_type
     void
     write_close(DynamicBuffer& db, close_reason const& cr);
 
+    // Write the header of a single frame message holding
+    // the buffers, masking them in place if needed
+    template<class DynamicBuffer, class MutableBufferSequence>
+    void
+    write_inplace_header(DynamicBuffer& db,
+        MutableBufferSequence const& buffers);
+
+    // Append a single frame message holding
+    // the buffers to the send queue
+    template<class ConstBufferSequence>
+    void
+    send_frame(ConstBufferSequence const& buffers);
+
+    std::size_t
+    send_size() const noexcept
+    {
+        return send_buf.size() + send_out.size();
+    }
+
+    // Resume the async_send ops waiting for the
+    // send queue to go down to the limit
+    void
+    send_resume()
+    {
+        while(! send_wait.empty() && (
+            send_buf.size() <= send_limit ||
+            status_ == status::closed ||
+            status_ == status::failed))
+        {
+            auto h = std::move(send_wait.front());
+            send_wait.pop_front();
+            h.invoke();
+        }
+    }
+
     //--------------------------------------------------------------------------
 
     void
@@ -318,8 +494,7 @@ struct stream<NextLayer, deflateSupported>::impl_type
             opt.idle_timeout == none())
         {
             // turn timer off
-            timer.cancel();
-            timer.expires_at(never());
+            timer_stop();
         }
 
         timeout_opt = opt;
@@ -399,6 +574,19 @@ struct stream<NextLayer, deflateSupported>::impl_type
         status_ = new_status;
     }
 
+    // Called before reading a frame header. Returns `true` if
+    // the read buffer was handed back to the pool and the
+    // caller should wait for the next layer to become
+    // readable before reading into it.
+    bool
+    release_rd_buf() noexcept
+    {
+        return
+            beast::detail::is_wait_readable<typename
+                std::decay<NextLayer>::type>::value &&
+            rd_pool && rd_buf.release();
+    }
+
     // Called to disarm the idle timeout counter
     void
     reset_idle()
@@ -418,17 +606,12 @@ struct stream<NextLayer, deflateSupported>::impl_type
             if(! is_timer_set() &&
                 timeout_opt.handshake_timeout != none())
             {
-                timer.expires_after(
-                    timeout_opt.handshake_timeout);
-
                 BOOST_ASIO_HANDLER_LOCATION((
                     __FILE__, __LINE__,
                     "websocket::check_stop_now"
                     ));
 
-                timer.async_wait(
-                    timeout_handler<Executor>(
-                        ex, this->weak_from_this()));
+                timer_start(timeout_opt.handshake_timeout, ex);
             }
             break;
 
@@ -436,26 +619,20 @@ struct stream<NextLayer, deflateSupported>::impl_type
             if(timeout_opt.idle_timeout != none())
             {
                 idle_counter = 0;
-                if(timeout_opt.keep_alive_pings)
-                    timer.expires_after(
-                        timeout_opt.idle_timeout / 2);
-                else
-                    timer.expires_after(
-                        timeout_opt.idle_timeout);
 
                 BOOST_ASIO_HANDLER_LOCATION((
                     __FILE__, __LINE__,
                     "websocket::check_stop_now"
                     ));
 
-                timer.async_wait(
-                    timeout_handler<Executor>(
-                        ex, this->weak_from_this()));
+                if(timeout_opt.keep_alive_pings)
+                    timer_start(timeout_opt.idle_timeout / 2, ex);
+                else
+                    timer_start(timeout_opt.idle_timeout, ex);
             }
             else
             {
-                timer.cancel();
-                timer.expires_at(never());
+                timer_stop();
             }
             break;
 
@@ -463,17 +640,13 @@ struct stream<NextLayer, deflateSupported>::impl_type
             if(timeout_opt.handshake_timeout != none())
             {
                 idle_counter = 0;
-                timer.expires_after(
-                    timeout_opt.handshake_timeout);
 
                 BOOST_ASIO_HANDLER_LOCATION((
                     __FILE__, __LINE__,
                     "websocket::check_stop_now"
                     ));
 
-                timer.async_wait(
-                    timeout_handler<Executor>(
-                        ex, this->weak_from_this()));
+                timer_start(timeout_opt.handshake_timeout, ex);
             }
             else
             {
@@ -488,12 +661,60 @@ struct stream<NextLayer, deflateSupported>::impl_type
         case status::failed:
         case status::closed:
             // this->close(); // Is this right?
-            timer.cancel();
-            timer.expires_at(never());
+            timer_stop();
             break;
         }
     }
 
+    // Start the timer, replacing any pending wait
+    template<class Executor>
+    void
+    timer_start(duration d, Executor const& ex)
+    {
+        if(wheel)
+        {
+            // Ignore an expiration already on its way
+            wheel->disarm(wheel_entry);
+            ++wheel_entry.gen;
+            wheel_entry.impl = this;
+            wheel_entry.expiry =
+                std::chrono::steady_clock::now() + d;
+            wheel->arm(wheel_entry, wheel_entry.expiry);
+            return;
+        }
+        timer.expires_after(d);
+        timer.async_wait(
+            timeout_handler<Executor>(
+                ex, this->weak_from_this()));
+    }
+
+    // Cancel a pending wait
+    void
+    timer_cancel()
+    {
+        if(wheel)
+        {
+            wheel->disarm(wheel_entry);
+            ++wheel_entry.gen;
+            return;
+        }
+        timer.cancel();
+    }
+
+    // Cancel a pending wait and clear the expiration
+    void
+    timer_stop()
+    {
+        if(wheel)
+        {
+            timer_cancel();
+            wheel_entry.expiry = never();
+            return;
+        }
+        timer.cancel();
+        timer.expires_at(never());
+    }
+
 private:
     template<class Executor>
     static net::execution_context&
@@ -514,6 +735,8 @@ private:
     bool
     is_timer_set() const
     {
+        if(wheel)
+            return wheel_entry.expiry != never();
         return timer.expiry() != never();
     }
 
@@ -522,14 +745,17 @@ private:
         : boost::empty_value<Executor>
     {
         boost::weak_ptr<impl_type> wp_;
+        std::uint64_t gen_;
 
     public:
         timeout_handler(
             Executor const& ex,
-            boost::weak_ptr<impl_type>&& wp)
+            boost::weak_ptr<impl_type>&& wp,
+            std::uint64_t gen = 0)
             : boost::empty_value<Executor>(
                 boost::empty_init_t{}, ex)
             , wp_(std::move(wp))
+            , gen_(gen)
         {
         }
 
@@ -555,6 +781,10 @@ private:
                 return;
             auto& impl = *sp;
 
+            // timer restarted after expiring?
+            if(impl.wheel && gen_ != impl.wheel_entry.gen)
+                return;
+
             switch(impl.status_)
             {
             case status::handshake:
@@ -578,8 +808,6 @@ private:
                         idle_ping_op<Executor>(sp, get_executor());
                     }
                     ++impl.idle_counter;
-                    impl.timer.expires_after(
-                        impl.timeout_opt.idle_timeout / 2);
 
                     {
                         BOOST_ASIO_HANDLER_LOCATION((
@@ -587,7 +815,9 @@ private:
                             "websocket::timeout_handler"
                             ));
 
-                        impl.timer.async_wait(std::move(*this));
+                        impl.timer_start(
+                            impl.timeout_opt.idle_timeout / 2,
+                            get_executor());
                     }
                     return;
                 }
@@ -614,10 +844,10 @@ private:
 //
 //--------------------------------------------------------------------------
 
-template<class NextLayer, bool deflateSupported>
+template<class NextLayer, bool deflateSupported, class Role>
 template<class Decorator>
 request_type
-stream<NextLayer, deflateSupported>::impl_type::
+stream<NextLayer, deflateSupported, Role>::impl_type::
 build_request(
     detail::sec_ws_key_type& key,
     string_view host, string_view target,
@@ -640,9 +870,9 @@ build_request(
 }
 
 // Called when the WebSocket Upgrade response is received
-template<class NextLayer, bool deflateSupported>
+template<class NextLayer, bool deflateSupported, class Role>
 void
-stream<NextLayer, deflateSupported>::impl_type::
+stream<NextLayer, deflateSupported, Role>::impl_type::
 on_response(
     response_type const& res,
     detail::sec_ws_key_type const& key,
@@ -691,10 +921,10 @@ on_response(
 
 // Attempt to read a complete frame header.
 // Returns `false` if more bytes are needed
-template<class NextLayer, bool deflateSupported>
+template<class NextLayer, bool deflateSupported, class Role>
 template<class DynamicBuffer>
 bool
-stream<NextLayer, deflateSupported>::impl_type::
+stream<NextLayer, deflateSupported, Role>::impl_type::
 parse_fh(
     detail::frame_header& fh,
     DynamicBuffer& b,
@@ -799,13 +1029,13 @@ parse_fh(
         }
         break;
     }
-    if(role == role_type::server && ! fh.mask)
+    if(! is_client() && ! fh.mask)
     {
         // unmasked frame from client
         ec = error::bad_unmasked_frame;
         return false;
     }
-    if(role == role_type::client && fh.mask)
+    if(is_client() && fh.mask)
     {
         // masked frame from server
         ec = error::bad_masked_frame;
@@ -901,10 +1131,10 @@ parse_fh(
     return true;
 }
 
-template<class NextLayer, bool deflateSupported>
+template<class NextLayer, bool deflateSupported, class Role>
 template<class DynamicBuffer>
 void
-stream<NextLayer, deflateSupported>::impl_type::
+stream<NextLayer, deflateSupported, Role>::impl_type::
 write_ping(DynamicBuffer& db,
     detail::opcode code, ping_data const& data)
 {
@@ -915,7 +1145,7 @@ write_ping(DynamicBuffer& db,
     fh.rsv2 = false;
     fh.rsv3 = false;
     fh.len = data.size();
-    fh.mask = role == role_type::client;
+    fh.mask = is_client();
     if(fh.mask)
         fh.key = create_mask();
     detail::write(db, fh);
@@ -933,10 +1163,10 @@ write_ping(DynamicBuffer& db,
     db.commit(data.size());
 }
 
-template<class NextLayer, bool deflateSupported>
+template<class NextLayer, bool deflateSupported, class Role>
 template<class DynamicBuffer>
 void
-stream<NextLayer, deflateSupported>::impl_type::
+stream<NextLayer, deflateSupported, Role>::impl_type::
 write_close(DynamicBuffer& db, close_reason const& cr)
 {
     using namespace boost::endian;
@@ -948,7 +1178,7 @@ write_close(DynamicBuffer& db, close_reason const& cr)
     fh.rsv3 = false;
     fh.len = cr.code == close_code::none ?
         0 : 2 + cr.reason.size();
-    if(role == role_type::client)
+    if(is_client())
     {
         fh.mask = true;
         fh.key = create_mask();
@@ -985,6 +1215,87 @@ write_close(DynamicBuffer& db, close_reason const& cr)
     }
 }
 
+template<class NextLayer, bool deflateSupported, class Role>
+template<class DynamicBuffer, class MutableBufferSequence>
+void
+stream<NextLayer, deflateSupported, Role>::impl_type::
+write_inplace_header(DynamicBuffer& db,
+    MutableBufferSequence const& buffers)
+{
+    detail::frame_header fh;
+    fh.op = wr_opcode;
+    fh.fin = true;
+    fh.rsv1 = false;
+    fh.rsv2 = false;
+    fh.rsv3 = false;
+    fh.len = buffer_bytes(buffers);
+    fh.mask = is_client();
+    if(fh.mask)
+    {
+        fh.key = create_mask();
+        detail::prepared_key key;
+        detail::prepare_key(key, fh.key);
+        detail::mask_inplace(buffers, key);
+    }
+    detail::write(db, fh);
+}
+
+template<class NextLayer, bool deflateSupported, class Role>
+void
+stream<NextLayer, deflateSupported, Role>::impl_type::
+wheel_entry_type::
+on_expire(timeout_service::entry& e)
+{
+    // Called by the timeout service with its lock held,
+    // possibly while the implementation is being destroyed.
+    auto& we = static_cast<wheel_entry_type&>(e);
+    using executor_type =
+        beast::executor_type<NextLayer>;
+    beast::detail::post_expiry(
+        we.impl->detail::service::impl_type::weak_from_this(),
+        [&we](boost::shared_ptr<
+            detail::service::impl_type> const& sp)
+        {
+            auto const p =
+                boost::static_pointer_cast<impl_type>(sp);
+            return timeout_handler<executor_type>(
+                p->stream().get_executor(),
+                boost::weak_ptr<impl_type>(p), we.gen);
+        });
+}
+
+template<class NextLayer, bool deflateSupported, class Role>
+template<class ConstBufferSequence>
+void
+stream<NextLayer, deflateSupported, Role>::impl_type::
+send_frame(ConstBufferSequence const& buffers)
+{
+    auto const n = buffer_bytes(buffers);
+    detail::frame_header fh;
+    fh.op = wr_opcode;
+    fh.fin = true;
+    fh.rsv1 = false;
+    fh.rsv2 = false;
+    fh.rsv3 = false;
+    fh.len = n;
+    fh.mask = is_client();
+    if(fh.mask)
+        fh.key = create_mask();
+    detail::fh_buffer fb;
+    detail::write<flat_static_buffer_base>(fb, fh);
+    auto const mb = send_buf.prepare(fb.size() + n);
+    net::buffer_copy(mb, fb.data());
+    auto const payload = mb + fb.size();
+    net::buffer_copy(payload, buffers);
+    if(fh.mask)
+    {
+        detail::prepared_key key;
+        detail::prepare_key(key, fh.key);
+        detail::mask_inplace(payload, key);
+    }
+    send_buf.commit(mb.size());
+}
+
 } // websocket
 } // beast
 } // boost
@@ -28,6 +28,7 @@
 #include <boost/asio/coroutine.hpp>
 #include <boost/assert.hpp>
 #include <boost/config.hpp>
+#include <boost/core/ignore_unused.hpp>
 #include <boost/throw_exception.hpp>
 #include <algorithm>
 #include <memory>
@@ -36,9 +37,9 @@ namespace boost {
 namespace beast {
 namespace websocket {
 
-template<class NextLayer, bool deflateSupported>
+template<class NextLayer, bool deflateSupported, class Role>
 template<class Handler, class Buffers>
-class stream<NextLayer, deflateSupported>::write_some_op
+class stream<NextLayer, deflateSupported, Role>::write_some_op
     : public beast::async_base<
         Handler, beast::executor_type<stream>>
     , public asio::coroutine
@@ -98,7 +99,7 @@ public:
         fh_.op = impl.wr_cont ?
             detail::opcode::cont : impl.wr_opcode;
         fh_.mask =
-            impl.role == role_type::client;
+            impl.is_client();
 
         // Choose a write algorithm
         if(impl.wr_compress)
@@ -146,10 +147,10 @@ public:
         bool cont = true);
 };
 
-template<class NextLayer, bool deflateSupported>
+template<class NextLayer, bool deflateSupported, class Role>
 template<class Handler, class Buffers>
 void
-stream<NextLayer, deflateSupported>::
+stream<NextLayer, deflateSupported, Role>::
 write_some_op<Handler, Buffers>::
 operator()(
     error_code ec,
@@ -542,13 +543,14 @@ operator()(
         impl.op_close.maybe_invoke()
             || impl.op_idle_ping.maybe_invoke()
             || impl.op_rd.maybe_invoke()
-            || impl.op_ping.maybe_invoke();
+            || impl.op_ping.maybe_invoke()
+            || impl.op_send.maybe_invoke();
         this->complete(cont, ec, bytes_transferred_);
     }
 }
 
-template<class NextLayer, bool deflateSupported>
-struct stream<NextLayer, deflateSupported>::
+template<class NextLayer, bool deflateSupported, class Role>
+struct stream<NextLayer, deflateSupported, Role>::
     run_write_some_op
 {
     template<
@@ -582,10 +584,10 @@ struct stream<NextLayer, deflateSupported>::
 
 //------------------------------------------------------------------------------
 
-template<class NextLayer, bool deflateSupported>
+template<class NextLayer, bool deflateSupported, class Role>
 template<class ConstBufferSequence>
 std::size_t
-stream<NextLayer, deflateSupported>::
+stream<NextLayer, deflateSupported, Role>::
 write_some(bool fin, ConstBufferSequence const& buffers)
 {
     static_assert(is_sync_stream<next_layer_type>::value,
@@ -601,10 +603,10 @@ write_some(bool fin, ConstBufferSequence const& buffers)
     return bytes_transferred;
 }
 
-template<class NextLayer, bool deflateSupported>
+template<class NextLayer, bool deflateSupported, class Role>
 template<class ConstBufferSequence>
 std::size_t
-stream<NextLayer, deflateSupported>::
+stream<NextLayer, deflateSupported, Role>::
 write_some(bool fin,
     ConstBufferSequence const& buffers, error_code& ec)
 {
@@ -633,7 +635,7 @@ write_some(bool fin,
     fh.rsv3 = false;
     fh.op = impl.wr_cont ?
         detail::opcode::cont : impl.wr_opcode;
-    fh.mask = impl.role == role_type::client;
+    fh.mask = impl.is_client();
     auto remain = buffer_bytes(buffers);
     if(impl.wr_compress)
     {
@@ -813,10 +815,10 @@ write_some(bool fin,
     return bytes_transferred;
 }
 
-template<class NextLayer, bool deflateSupported>
+template<class NextLayer, bool deflateSupported, class Role>
 template<class ConstBufferSequence, BOOST_BEAST_ASYNC_TPARAM2 WriteHandler>
 BOOST_BEAST_ASYNC_RESULT2(WriteHandler)
-stream<NextLayer, deflateSupported>::
+stream<NextLayer, deflateSupported, Role>::
 async_write_some(bool fin,
     ConstBufferSequence const& bs, WriteHandler&& handler)
 {
@@ -837,10 +839,795 @@ async_write_some(bool fin,
 
 //------------------------------------------------------------------------------
 
-template<class NextLayer, bool deflateSupported>
+template<class NextLayer, bool deflateSupported, class Role>
+template<class Handler>
+class stream<NextLayer, deflateSupported, Role>::write_prepared_op
+    : public beast::async_base<
+        Handler, beast::executor_type<stream>>
+    , public asio::coroutine
+{
+    boost::weak_ptr<impl_type> wp_;
+    prepared_message msg_;
+    net::const_buffer cb_;
+    detail::prepared_key key_;
+    std::size_t bytes_transferred_ = 0;
+
+public:
+    static constexpr int id = 2; // for soft_mutex
+
+    template<class Handler_>
+    write_prepared_op(
+        Handler_&& h,
+        boost::shared_ptr<impl_type> const& sp,
+        prepared_message const& msg)
+        : beast::async_base<Handler,
+            beast::executor_type<stream>>(
+                std::forward<Handler_>(h),
+                    sp->stream().get_executor())
+        , wp_(sp)
+        , msg_(msg)
+        , cb_(msg.payload())
+    {
+        (*this)({}, 0, false);
+    }
+
+    void operator()(
+        error_code ec = {},
+        std::size_t bytes_transferred = 0,
+        bool cont = true);
+};
+
+template<class NextLayer, bool deflateSupported, class Role>
+template<class Handler>
+void
+stream<NextLayer, deflateSupported, Role>::
+write_prepared_op<Handler>::
+operator()(
+    error_code ec,
+    std::size_t bytes_transferred,
+    bool cont)
+{
+    using beast::detail::clamp;
+    std::size_t n;
+    auto sp = wp_.lock();
+    if(! sp)
+    {
+        ec = net::error::operation_aborted;
+        bytes_transferred_ = 0;
+        return this->complete(cont, ec, bytes_transferred_);
+    }
+    auto& impl = *sp;
+    BOOST_ASIO_CORO_REENTER(*this)
+    {
+        // Acquire the write lock
+        if(! impl.wr_block.try_lock(this))
+        {
+            BOOST_ASIO_CORO_YIELD
+            {
+                BOOST_ASIO_HANDLER_LOCATION((
+                    __FILE__, __LINE__,
+                    "websocket::async_write_prepared"));
+
+                impl.op_wr.emplace(std::move(*this));
+            }
+            impl.wr_block.lock(this);
+            BOOST_ASIO_CORO_YIELD
+            {
+                BOOST_ASIO_HANDLER_LOCATION((
+                    __FILE__, __LINE__,
+                    "websocket::async_write_prepared"));
+
+                net::post(std::move(*this));
+            }
+            BOOST_ASSERT(impl.wr_block.is_locked(this));
+        }
+        if(impl.check_stop_now(ec))
+            goto upcall;
+
+        // A message may not be sent while
+        // another is partially written.
+        BOOST_ASSERT(! impl.wr_cont);
+
+        if(! impl.is_client())
+        {
+            // send the prepared frame
+            BOOST_ASIO_CORO_YIELD
+            {
+                BOOST_ASIO_HANDLER_LOCATION((
+                    __FILE__, __LINE__,
+                    "websocket::async_write_prepared"));
+
+                net::async_write(impl.stream(),
+                    msg_.frame(
+                        msg_.deflated() &&
+                        impl.wr_compress_opt &&
+                        impl.prepared_deflate(
+                            impl.role, msg_.window_bits())),
+                    beast::detail::bind_continuation(std::move(*this)));
+            }
+            bytes_transferred_ = msg_.size();
+            impl.check_stop_now(ec);
+            goto upcall;
+        }
+
+        // send a single masked frame using multiple writes
+        impl.begin_msg();
+        {
+            detail::frame_header fh;
+            fh.op = msg_.binary() ?
+                detail::opcode::binary : detail::opcode::text;
+            fh.fin = true;
+            fh.mask = true;
+            fh.rsv1 = false;
+            fh.rsv2 = false;
+            fh.rsv3 = false;
+            fh.len = cb_.size();
+            fh.key = impl.create_mask();
+            detail::prepare_key(key_, fh.key);
+            impl.wr_fb.clear();
+            detail::write<flat_static_buffer_base>(
+                impl.wr_fb, fh);
+        }
+        for(;;)
+        {
+            n = clamp(cb_.size(), impl.wr_buf_size);
+            net::buffer_copy(net::buffer(
+                impl.wr_buf.get(), n), cb_);
+            detail::mask_inplace(net::buffer(
+                impl.wr_buf.get(), n), key_);
+            cb_ += n;
+            // write the frame header and some payload
+            BOOST_ASIO_CORO_YIELD
+            {
+                BOOST_ASIO_HANDLER_LOCATION((
+                    __FILE__, __LINE__,
+                    "websocket::async_write_prepared"));
+
+                net::async_write(impl.stream(),
+                    buffers_cat(
+                        net::const_buffer(impl.wr_fb.data()),
+                        net::const_buffer(impl.wr_buf.get(), n)),
+                    beast::detail::bind_continuation(std::move(*this)));
+            }
+            if(impl.check_stop_now(ec))
+                goto upcall;
+            bytes_transferred_ +=
+                bytes_transferred - impl.wr_fb.size();
+            impl.wr_fb.clear();
+            if(cb_.size() == 0)
+                break;
+        }
+
+    //--------------------------------------------------------------------------
+
+    upcall:
+        if(ec)
+            bytes_transferred_ = 0;
+        impl.wr_block.unlock(this);
+        impl.op_close.maybe_invoke()
+            || impl.op_idle_ping.maybe_invoke()
+            || impl.op_rd.maybe_invoke()
+            || impl.op_ping.maybe_invoke()
+            || impl.op_send.maybe_invoke();
+        this->complete(cont, ec, bytes_transferred_);
+    }
+}
+
+template<class NextLayer, bool deflateSupported, class Role>
+struct stream<NextLayer, deflateSupported, Role>::
+    run_write_prepared_op
+{
+    template<class WriteHandler>
+    void
+    operator()(
+        WriteHandler&& h,
+        boost::shared_ptr<impl_type> const& sp,
+        prepared_message const& msg)
+    {
+        // If you get an error on the following line it means
+        // that your handler does not meet the documented type
+        // requirements for the handler.
+
+        static_assert(
+            beast::detail::is_invocable<WriteHandler,
+                void(error_code, std::size_t)>::value,
+            "WriteHandler type requirements not met");
+
+        write_prepared_op<
+            typename std::decay<WriteHandler>::type>(
+                std::forward<WriteHandler>(h),
+                sp,
+                msg);
+    }
+};
+
+//------------------------------------------------------------------------------
+
+template<class NextLayer, bool deflateSupported, class Role>
+std::size_t
+stream<NextLayer, deflateSupported, Role>::
+write_prepared(prepared_message const& msg)
+{
+    static_assert(is_sync_stream<next_layer_type>::value,
+        "SyncStream type requirements not met");
+    error_code ec;
+    auto const bytes_transferred =
+        write_prepared(msg, ec);
+    if(ec)
+        BOOST_THROW_EXCEPTION(system_error{ec});
+    return bytes_transferred;
+}
+
+template<class NextLayer, bool deflateSupported, class Role>
+std::size_t
+stream<NextLayer, deflateSupported, Role>::
+write_prepared(prepared_message const& msg, error_code& ec)
+{
+    static_assert(is_sync_stream<next_layer_type>::value,
+        "SyncStream type requirements not met");
+    using beast::detail::clamp;
+    auto& impl = *impl_;
+    ec = {};
+    if(impl.check_stop_now(ec))
+        return 0;
+    BOOST_ASSERT(! impl.wr_cont);
+    if(! impl.is_client())
+    {
+        net::write(impl.stream(), msg.frame(
+            msg.deflated() &&
+            impl.wr_compress_opt &&
+            impl.prepared_deflate(
+                impl.role, msg.window_bits())), ec);
+        if(impl.check_stop_now(ec))
+            return 0;
+        return msg.size();
+    }
+
+    // mask, no autofrag
+    impl.begin_msg();
+    detail::frame_header fh;
+    fh.op = msg.binary() ?
+        detail::opcode::binary : detail::opcode::text;
+    fh.fin = true;
+    fh.mask = true;
+    fh.rsv1 = false;
+    fh.rsv2 = false;
+    fh.rsv3 = false;
+    fh.len = msg.size();
+    fh.key = impl.create_mask();
+    detail::prepared_key key;
+    detail::prepare_key(key, fh.key);
+    detail::fh_buffer fh_buf;
+    detail::write<
+        flat_static_buffer_base>(fh_buf, fh);
+    std::size_t bytes_transferred = 0;
+    auto cb = msg.payload();
+    for(;;)
+    {
+        auto const n =
+            clamp(cb.size(), impl.wr_buf_size);
+        auto const b =
+            net::buffer(impl.wr_buf.get(), n);
+        net::buffer_copy(b, cb);
+        cb += n;
+        detail::mask_inplace(b, key);
+        net::write(impl.stream(),
+            buffers_cat(fh_buf.data(), b), ec);
+        fh_buf.clear();
+        if(impl.check_stop_now(ec))
+            return 0;
+        bytes_transferred += n;
+        if(cb.size() == 0)
+            break;
+    }
+    return bytes_transferred;
+}
+
+template<class NextLayer, bool deflateSupported, class Role>
+template<BOOST_BEAST_ASYNC_TPARAM2 WriteHandler>
+BOOST_BEAST_ASYNC_RESULT2(WriteHandler)
+stream<NextLayer, deflateSupported, Role>::
+async_write_prepared(
+    prepared_message const& msg, WriteHandler&& handler)
+{
+    static_assert(is_async_stream<next_layer_type>::value,
+        "AsyncStream type requirements not met");
+    return net::async_initiate<
+        WriteHandler,
+        void(error_code, std::size_t)>(
+            run_write_prepared_op{},
+            handler,
+            impl_,
+            msg);
+}
+
+//------------------------------------------------------------------------------
+
+template<class NextLayer, bool deflateSupported, class Role>
+template<class Handler, class Buffers>
+class stream<NextLayer, deflateSupported, Role>::write_inplace_op
+    : public beast::async_base<
+        Handler, beast::executor_type<stream>>
+    , public asio::coroutine
+{
+    boost::weak_ptr<impl_type> wp_;
+    Buffers bs_;
+    std::size_t bytes_transferred_ = 0;
+
+public:
+    static constexpr int id = 2; // for soft_mutex
+
+    template<class Handler_>
+    write_inplace_op(
+        Handler_&& h,
+        boost::shared_ptr<impl_type> const& sp,
+        Buffers const& bs)
+        : beast::async_base<Handler,
+            beast::executor_type<stream>>(
+                std::forward<Handler_>(h),
+                    sp->stream().get_executor())
+        , wp_(sp)
+        , bs_(bs)
+    {
+        (*this)({}, 0, false);
+    }
+
+    void operator()(
+        error_code ec = {},
+        std::size_t bytes_transferred = 0,
+        bool cont = true)
+    {
+        boost::ignore_unused(bytes_transferred);
+        auto sp = wp_.lock();
+        if(! sp)
+        {
+            ec = net::error::operation_aborted;
+            bytes_transferred_ = 0;
+            return this->complete(cont, ec, bytes_transferred_);
+        }
+        auto& impl = *sp;
+        BOOST_ASIO_CORO_REENTER(*this)
+        {
+            // Acquire the write lock
+            if(! impl.wr_block.try_lock(this))
+            {
+                BOOST_ASIO_CORO_YIELD
+                {
+                    BOOST_ASIO_HANDLER_LOCATION((
+                        __FILE__, __LINE__,
+                        "websocket::async_write_inplace"));
+
+                    impl.op_wr.emplace(std::move(*this));
+                }
+                impl.wr_block.lock(this);
+                BOOST_ASIO_CORO_YIELD
+                {
+                    BOOST_ASIO_HANDLER_LOCATION((
+                        __FILE__, __LINE__,
+                        "websocket::async_write_inplace"));
+
+                    net::post(std::move(*this));
+                }
+                BOOST_ASSERT(impl.wr_block.is_locked(this));
+            }
+            if(impl.check_stop_now(ec))
+                goto upcall;
+
+            // A message may not be sent while
+            // another is partially written.
+            BOOST_ASSERT(! impl.wr_cont);
+
+            impl.wr_fb.clear();
+            impl.write_inplace_header(impl.wr_fb, bs_);
+
+            // Send the frame header and the
+            // payload in a single write
+            BOOST_ASIO_CORO_YIELD
+            {
+                BOOST_ASIO_HANDLER_LOCATION((
+                    __FILE__, __LINE__,
+                    "websocket::async_write_inplace"));
+
+                net::async_write(impl.stream(),
+                    buffers_cat(
+                        net::const_buffer(impl.wr_fb.data()),
+                        bs_),
+                    beast::detail::bind_continuation(std::move(*this)));
+            }
+            if(impl.check_stop_now(ec))
+                goto upcall;
+            bytes_transferred_ = buffer_bytes(bs_);
+
+        upcall:
+            impl.wr_block.unlock(this);
+            impl.op_close.maybe_invoke()
+                || impl.op_idle_ping.maybe_invoke()
+                || impl.op_rd.maybe_invoke()
+                || impl.op_ping.maybe_invoke()
+                || impl.op_send.maybe_invoke();
+            this->complete(cont, ec, bytes_transferred_);
+        }
+    }
+};
+
+template<class NextLayer, bool deflateSupported, class Role>
+struct stream<NextLayer, deflateSupported, Role>::
+    run_write_inplace_op
+{
+    template<class WriteHandler, class Buffers>
+    void
+    operator()(
+        WriteHandler&& h,
+        boost::shared_ptr<impl_type> const& sp,
+        Buffers const& b)
+    {
+        // If you get an error on the following line it means
+        // that your handler does not meet the documented type
+        // requirements for the handler.
+
+        static_assert(
+            beast::detail::is_invocable<WriteHandler,
+                void(error_code, std::size_t)>::value,
+            "WriteHandler type requirements not met");
+
+        write_inplace_op<
+            typename std::decay<WriteHandler>::type,
+            Buffers>(
+                std::forward<WriteHandler>(h),
+                sp,
+                b);
+    }
+};
+
+//------------------------------------------------------------------------------
+
+template<class NextLayer, bool deflateSupported, class Role>
+template<class MutableBufferSequence>
+std::size_t
+stream<NextLayer, deflateSupported, Role>::
+write_inplace(MutableBufferSequence const& buffers)
+{
+    static_assert(is_sync_stream<next_layer_type>::value,
+        "SyncStream type requirements not met");
+    static_assert(net::is_mutable_buffer_sequence<
+        MutableBufferSequence>::value,
+            "MutableBufferSequence type requirements not met");
+    error_code ec;
+    auto const bytes_transferred =
+        write_inplace(buffers, ec);
+    if(ec)
+        BOOST_THROW_EXCEPTION(system_error{ec});
+    return bytes_transferred;
+}
+
+template<class NextLayer, bool deflateSupported, class Role>
+template<class MutableBufferSequence>
+std::size_t
+stream<NextLayer, deflateSupported, Role>::
+write_inplace(
+    MutableBufferSequence const& buffers, error_code& ec)
+{
+    static_assert(is_sync_stream<next_layer_type>::value,
+        "SyncStream type requirements not met");
+    static_assert(net::is_mutable_buffer_sequence<
+        MutableBufferSequence>::value,
+            "MutableBufferSequence type requirements not met");
+    auto& impl = *impl_;
+    ec = {};
+    if(impl.check_stop_now(ec))
+        return 0;
+    BOOST_ASSERT(! impl.wr_cont);
+    detail::fh_buffer fh_buf;
+    impl.write_inplace_header(fh_buf, buffers);
+    net::write(impl.stream(),
+        buffers_cat(fh_buf.data(), buffers), ec);
+    if(impl.check_stop_now(ec))
+        return 0;
+    return buffer_bytes(buffers);
+}
+
+template<class NextLayer, bool deflateSupported, class Role>
+template<class MutableBufferSequence, BOOST_BEAST_ASYNC_TPARAM2 WriteHandler>
+BOOST_BEAST_ASYNC_RESULT2(WriteHandler)
+stream<NextLayer, deflateSupported, Role>::
+async_write_inplace(
+    MutableBufferSequence const& buffers, WriteHandler&& handler)
+{
+    static_assert(is_async_stream<next_layer_type>::value,
+        "AsyncStream type requirements not met");
+    static_assert(net::is_mutable_buffer_sequence<
+        MutableBufferSequence>::value,
+            "MutableBufferSequence type requirements not met");
+    return net::async_initiate<
+        WriteHandler,
+        void(error_code, std::size_t)>(
+            run_write_inplace_op{},
+            handler,
+            impl_,
+            buffers);
+}
+
+//------------------------------------------------------------------------------
+
+template<class NextLayer, bool deflateSupported, class Role>
+template<class Handler, class Buffers>
+class stream<NextLayer, deflateSupported, Role>::send_op
+    : public beast::async_base<
+        Handler, beast::executor_type<stream>>
+    , public asio::coroutine
+{
+    boost::weak_ptr<impl_type> wp_;
+    Buffers bs_;
+    std::size_t bytes_transferred_ = 0;
+
+public:
+    template<class Handler_>
+    send_op(
+        Handler_&& h,
+        boost::shared_ptr<impl_type> const& sp,
+        Buffers const& bs)
+        : beast::async_base<Handler,
+            beast::executor_type<stream>>(
+                std::forward<Handler_>(h),
+                    sp->stream().get_executor())
+        , wp_(sp)
+        , bs_(bs)
+    {
+        (*this)({}, false);
+    }
+
+    void operator()(
+        error_code ec = {},
+        bool cont = true)
+    {
+        auto sp = wp_.lock();
+        if(! sp)
+        {
+            ec = net::error::operation_aborted;
+            bytes_transferred_ = 0;
+            return this->complete(cont, ec, bytes_transferred_);
+        }
+        auto& impl = *sp;
+        BOOST_ASIO_CORO_REENTER(*this)
+        {
+            if(impl.check_stop_now(ec))
+                goto upcall;
+            if(impl.send_closed)
+            {
+                // Can't send data after a close frame
+                ec = net::error::operation_aborted;
+                goto upcall;
+            }
+
+            impl.send_frame(bs_);
+            bytes_transferred_ = buffer_bytes(bs_);
+            if(! impl.send_flushing)
+            {
+                BOOST_ASIO_HANDLER_LOCATION((
+                    __FILE__, __LINE__,
+                    "websocket::async_send"));
+
+                send_flush_op<beast::executor_type<stream>>(
+                    sp, impl.stream().get_executor());
+            }
+
+            // Wait for the queue to go down to the limit
+            if(impl.send_size() > impl.send_limit)
+            {
+                BOOST_ASIO_CORO_YIELD
+                {
+                    BOOST_ASIO_HANDLER_LOCATION((
+                        __FILE__, __LINE__,
+                        "websocket::async_send"));
+
+                    impl.send_wait.emplace_back();
+                    impl.send_wait.back().emplace(std::move(*this));
+                }
+                if(impl.check_stop_now(ec))
+                    goto upcall;
+            }
+
+        upcall:
+            if(ec)
+                bytes_transferred_ = 0;
+            this->complete(cont, ec, bytes_transferred_);
+        }
+    }
+};
+
+// writes the frames queued by async_send
+template<class NextLayer, bool deflateSupported, class Role>
+template<class Executor>
+class stream<NextLayer, deflateSupported, Role>::send_flush_op
+    : public asio::coroutine
+    , public boost::empty_value<Executor>
+{
+    boost::weak_ptr<impl_type> wp_;
+
+public:
+    static constexpr int id = 6; // for soft_mutex
+
+    using executor_type = Executor;
+
+    executor_type
+    get_executor() const noexcept
+    {
+        return this->get();
+    }
+
+    send_flush_op(
+        boost::shared_ptr<impl_type> const& sp,
+        Executor const& ex)
+        : boost::empty_value<Executor>(
+            boost::empty_init_t{}, ex)
+        , wp_(sp)
+    {
+        BOOST_ASSERT(! sp->send_flushing);
+        sp->send_flushing = true;
+        (*this)({}, 0);
+    }
+
+    void operator()(
+        error_code ec = {},
+        std::size_t bytes_transferred = 0)
+    {
+        boost::ignore_unused(bytes_transferred);
+        auto sp = wp_.lock();
+        if(! sp)
+            return;
+        auto& impl = *sp;
+        BOOST_ASIO_CORO_REENTER(*this)
+        {
+            for(;;)
+            {
+                // Acquire the write lock
+                if(! impl.wr_block.try_lock(this))
+                {
+                do_suspend:
+                    BOOST_ASIO_CORO_YIELD
+                    {
+                        BOOST_ASIO_HANDLER_LOCATION((
+                            __FILE__, __LINE__,
+                            "websocket::async_send"));
+
+                        impl.op_send.emplace(std::move(*this));
+                    }
+                    impl.wr_block.lock(this);
+                    BOOST_ASIO_CORO_YIELD
+                    {
+                        BOOST_ASIO_HANDLER_LOCATION((
+                            __FILE__, __LINE__,
+                            "websocket::async_send"));
+
+                        net::post(
+                            this->get_executor(), std::move(*this));
+                    }
+                    BOOST_ASSERT(impl.wr_block.is_locked(this));
+                }
+                if(impl.check_stop_now(ec))
+                    goto upcall;
+
+                // No data frames may follow a close frame
+                if(impl.wr_close)
+                    goto upcall;
+
+                // Wait for a partially written message to be finished
+                if(impl.wr_cont)
+                {
+                    impl.wr_block.unlock(this);
+                    impl.op_close.maybe_invoke()
+                        || impl.op_idle_ping.maybe_invoke()
+                        || impl.op_ping.maybe_invoke()
+                        || impl.op_rd.maybe_invoke()
+                        || impl.op_wr.maybe_invoke();
+                    goto do_suspend;
+                }
+
+                // Send everything queued so far in one write
+                std::swap(impl.send_buf, impl.send_out);
+                BOOST_ASIO_CORO_YIELD
+                {
+                    BOOST_ASIO_HANDLER_LOCATION((
+                        __FILE__, __LINE__,
+                        "websocket::async_send"));
+
+                    net::async_write(impl.stream(),
+                        impl.send_out.data(), std::move(*this));
+                }
+                impl.send_out.clear();
+                if(impl.check_stop_now(ec))
+                    goto upcall;
+
+                // Let the other writers go first
+                impl.wr_block.unlock(this);
+                impl.send_resume();
+                if(impl.send_buf.size() == 0)
+                    break;
+                impl.op_close.maybe_invoke()
+                    || impl.op_idle_ping.maybe_invoke()
+                    || impl.op_ping.maybe_invoke()
+                    || impl.op_rd.maybe_invoke()
+                    || impl.op_wr.maybe_invoke();
+            }
+            impl.send_flushing = false;
+            impl.op_close.maybe_invoke()
+                || impl.op_idle_ping.maybe_invoke()
+                || impl.op_ping.maybe_invoke()
+                || impl.op_rd.maybe_invoke()
+                || impl.op_wr.maybe_invoke();
+            return;
+
+        upcall:
+            impl.send_flushing = false;
+            impl.send_buf.clear();
+            impl.send_out.clear();
+            impl.wr_block.unlock(this);
+            impl.send_resume();
+            impl.op_close.maybe_invoke()
+                || impl.op_idle_ping.maybe_invoke()
+                || impl.op_ping.maybe_invoke()
+                || impl.op_rd.maybe_invoke()
+                || impl.op_wr.maybe_invoke();
+        }
+    }
+};
+
+template<class NextLayer, bool deflateSupported, class Role>
+struct stream<NextLayer, deflateSupported, Role>::
+    run_send_op
+{
+    template<class WriteHandler, class Buffers>
+    void
+    operator()(
+        WriteHandler&& h,
+        boost::shared_ptr<impl_type> const& sp,
+        Buffers const& b)
+    {
+        // If you get an error on the following line it means
+        // that your handler does not meet the documented type
+        // requirements for the handler.
+
+        static_assert(
+            beast::detail::is_invocable<WriteHandler,
+                void(error_code, std::size_t)>::value,
+            "WriteHandler type requirements not met");
+
+        send_op<
+            typename std::decay<WriteHandler>::type,
+            Buffers>(
+                std::forward<WriteHandler>(h),
+                sp,
+                b);
+    }
+};
+
+template<class NextLayer, bool deflateSupported, class Role>
+template<class ConstBufferSequence, BOOST_BEAST_ASYNC_TPARAM2 WriteHandler>
+BOOST_BEAST_ASYNC_RESULT2(WriteHandler)
+stream<NextLayer, deflateSupported, Role>::
+async_send(
+    ConstBufferSequence const& buffers, WriteHandler&& handler)
+{
+    static_assert(is_async_stream<next_layer_type>::value,
+        "AsyncStream type requirements not met");
+    static_assert(net::is_const_buffer_sequence<
+        ConstBufferSequence>::value,
+            "ConstBufferSequence type requirements not met");
+    return net::async_initiate<
+        WriteHandler,
+        void(error_code, std::size_t)>(
+            run_send_op{},
+            handler,
+            impl_,
+            buffers);
+}
+
+//------------------------------------------------------------------------------
+
+template<class NextLayer, bool deflateSupported, class Role>
 template<class ConstBufferSequence>
 std::size_t
-stream<NextLayer, deflateSupported>::
+stream<NextLayer, deflateSupported, Role>::
 write(ConstBufferSequence const& buffers)
 {
     static_assert(is_sync_stream<next_layer_type>::value,
@@ -855,10 +1642,10 @@ write(ConstBufferSequence const& buffers)
     return bytes_transferred;
 }
 
-template<class NextLayer, bool deflateSupported>
+template<class NextLayer, bool deflateSupported, class Role>
 template<class ConstBufferSequence>
 std::size_t
-stream<NextLayer, deflateSupported>::
+stream<NextLayer, deflateSupported, Role>::
 write(ConstBufferSequence const& buffers, error_code& ec)
 {
     static_assert(is_sync_stream<next_layer_type>::value,
@@ -869,10 +1656,10 @@ write(ConstBufferSequence const& buffers, error_code& ec)
     return write_some(true, buffers, ec);
 }
 
-template<class NextLayer, bool deflateSupported>
+template<class NextLayer, bool deflateSupported, class Role>
 template<class ConstBufferSequence, BOOST_BEAST_ASYNC_TPARAM2 WriteHandler>
 BOOST_BEAST_ASYNC_RESULT2(WriteHandler)
-stream<NextLayer, deflateSupported>::
+stream<NextLayer, deflateSupported, Role>::
 async_write(
     ConstBufferSequence const& bs, WriteHandler&& handler)
 {
@@ -21,6 +21,12 @@ namespace websocket {
     These settings control the permessage-deflate extension,
     which allows messages to be compressed.
 
+    When context takeover is off in a direction, the stream only
+    holds a compressor or decompressor for that direction while a
+    message is being written or read. It is taken from a pool kept
+    by the calling thread and given back when the message is done,
+    so idle connections hold no compression memory.
+
     @note Objects of this type are used with
           @ref beast::websocket::stream::set_option.
 */
@@ -44,7 +50,16 @@ struct permessage_deflate
     */
     int client_max_window_bits = 15;
 
-    /// `true` if server_no_context_takeover desired
+    /** `true` if server_no_context_takeover desired
+
+        Without context takeover each message is compressed on
+        its own. A complete message of up to 64KiB written by a
+        stream is remembered on the calling thread, and other
+        streams with the same settings writing the same message
+        next send the remembered output instead of compressing
+        it again. This makes broadcasting a message to many
+        connections on one thread cost a single compression.
+    */
     bool server_no_context_takeover = false;
 
     /// `true` if client_no_context_takeover desired
@@ -0,0 +1,140 @@
+//
+// Copyright (c) 2016-2019 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/boostorg/beast
+//
+
+#ifndef BOOST_BEAST_WEBSOCKET_PREPARED_MESSAGE_HPP
+#define BOOST_BEAST_WEBSOCKET_PREPARED_MESSAGE_HPP
+
+#include <boost/beast/core/detail/config.hpp>
+#include <boost/beast/websocket/option.hpp>
+#include <boost/beast/websocket/stream_fwd.hpp>
+#include <boost/asio/buffer.hpp>
+#include <boost/shared_ptr.hpp>
+#include <cstddef>
+#include <string>
+
+namespace boost {
+namespace beast {
+namespace websocket {
+
+/** A message serialized once for sending on many streams.
+
+    Objects of this type hold the complete frame of a message as
+    it appears on the wire when sent by a server, so that it can
+    be broadcast to any number of streams with
+    @ref stream::async_write_prepared without building a frame
+    header or compressing the payload again for each of them.
+
+    When permessage-deflate is enabled in the options used to
+    prepare the message, a compressed frame is also built, using
+    a fresh compressor with the level, memory level and server
+    window size from the options. Each stream sends the compressed
+    frame if the extension was negotiated on it with a window at
+    least as large, and the uncompressed frame otherwise. If the
+    compressed payload would not be smaller, only the uncompressed
+    frame is kept.
+
+    Copies share the same frames, and copying is cheap. The frames
+    are immutable, so the same object may be sent on streams running
+    on different threads. Streams in the client role must mask every
+    frame with a new key, and send the payload through their write
+    buffer instead of using the prepared frames.
+
+    @par Example
+    @code
+    websocket::prepared_message msg(net::buffer(text), false, pmd);
+    for(auto& ws : sessions)
+        ws->async_write_prepared(msg,
+            [](error_code ec, std::size_t)
+            {
+                ...
+            });
+    @endcode
+
+    @see stream::async_write_prepared, stream::write_prepared
+*/
+class prepared_message
+{
+    struct impl_type;
+
+    boost::shared_ptr<impl_type> impl_;
+
+    template<class NextLayer, bool deflateSupported, class Role>
+    friend class stream;
+
+    BOOST_BEAST_DECL
+    void*
+    prepare(std::size_t size, bool binary);
+
+    BOOST_BEAST_DECL
+    void
+    commit(permessage_deflate const& opts);
+
+    BOOST_BEAST_DECL
+    net::const_buffer
+    frame(bool deflated) const noexcept;
+
+    BOOST_BEAST_DECL
+    int
+    window_bits() const noexcept;
+
+public:
+    /// Constructor
+    prepared_message() = default;
+
+    /** Constructor
+
+        The payload is copied, and the frames are built.
+
+        @param payload The message payload.
+
+        @param binary `true` to send a binary message,
+        `false` to send a text message.
+
+        @param opts The permessage-deflate options of the streams
+        the message will be sent on. The compressed frame is built
+        if `opts.server_enable` is `true`.
+    */
+    template<class ConstBufferSequence>
+    explicit
+    prepared_message(
+        ConstBufferSequence const& payload,
+        bool binary = false,
+        permessage_deflate const& opts = {});
+
+    /// Returns `true` if the message is binary
+    BOOST_BEAST_DECL
+    bool
+    binary() const noexcept;
+
+    /// Returns `true` if a compressed frame was built
+    BOOST_BEAST_DECL
+    bool
+    deflated() const noexcept;
+
+    /// Returns the size of the payload
+    BOOST_BEAST_DECL
+    std::size_t
+    size() const noexcept;
+
+    /// Returns the payload
+    BOOST_BEAST_DECL
+    net::const_buffer
+    payload() const noexcept;
+};
+
+} // websocket
+} // beast
+} // boost
+
+#include <boost/beast/websocket/impl/prepared_message.hpp>
+#ifdef BOOST_BEAST_HEADER_ONLY
+#include <boost/beast/websocket/impl/prepared_message.ipp>
+#endif
+
+#endif
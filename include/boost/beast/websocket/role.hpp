@@ -0,0 +1,89 @@
+//
+// Copyright (c) 2016-2019 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/boostorg/beast
+//
+
+#ifndef BOOST_BEAST_WEBSOCKET_ROLE_HPP
+#define BOOST_BEAST_WEBSOCKET_ROLE_HPP
+
+#include <boost/beast/core/detail/config.hpp>
+#include <boost/beast/core/role.hpp>
+
+namespace boost {
+namespace beast {
+namespace websocket {
+
+/** Role tag for a stream which may be used in either role.
+
+    The role of the stream is decided at run time, by
+    performing the client handshake or accepting a
+    connection. This is the default.
+
+    @see stream
+*/
+struct any_role
+{
+};
+
+/** Role tag for a stream which only accepts connections.
+
+    Streams with this tag may not perform the client
+    handshake. Since such a stream never masks the frames
+    it sends, the code for masking outgoing frames and
+    generating keys is left out of the read and write paths.
+
+    @see stream
+*/
+struct server_role
+{
+};
+
+/** Role tag for a stream which only performs the client handshake.
+
+    Streams with this tag may not accept connections. The
+    checks of the role made for every frame are resolved
+    at compile time.
+
+    @see stream
+*/
+struct client_role
+{
+};
+
+namespace detail {
+
+// Returns `true` if the stream is in the client role,
+// as a constant when the tag leaves only one choice.
+
+inline
+bool
+is_client(any_role, role_type role) noexcept
+{
+    return role == role_type::client;
+}
+
+constexpr
+bool
+is_client(server_role, role_type) noexcept
+{
+    return false;
+}
+
+constexpr
+bool
+is_client(client_role, role_type) noexcept
+{
+    return true;
+}
+
+} // detail
+
+} // websocket
+} // beast
+} // boost
+
+#endif
@@ -13,6 +13,7 @@
 #include <boost/beast/core/detail/config.hpp>
 #include <boost/beast/websocket/error.hpp>
 #include <boost/beast/websocket/option.hpp>
+#include <boost/beast/websocket/prepared_message.hpp>
 #include <boost/beast/websocket/rfc6455.hpp>
 #include <boost/beast/websocket/stream_base.hpp>
 #include <boost/beast/websocket/stream_fwd.hpp>
@@ -23,6 +24,7 @@
 #include <boost/beast/core/role.hpp>
 #include <boost/beast/core/stream_traits.hpp>
 #include <boost/beast/core/string.hpp>
+#include <boost/beast/core/timeout_service.hpp>
 #include <boost/beast/http/detail/type_traits.hpp>
 #include <boost/asio/async_result.hpp>
 #include <boost/asio/error.hpp>
@@ -34,6 +36,7 @@
 #include <memory>
 #include <type_traits>
 #include <random>
+#include <vector>
 
 namespace boost {
 namespace beast {
@@ -102,6 +105,14 @@ class frame_test;
     deflate options (set by the caller at runtime) must still have the
     feature enabled for a successful negotiation to occur.
 
+    @tparam Role The role tag, one of @ref any_role, @ref server_role,
+    or @ref client_role. A stream restricted to one role by its tag
+    decides at compile time whether outgoing frames are masked, and
+    leaves out the code for the other role. Performing the client
+    handshake on a @ref server_role stream, or accepting a connection
+    on a @ref client_role stream, is a compile-time error. For this
+    reason such streams may not be explicitly instantiated.
+
     @note A stream object must not be moved or destroyed while there
     are pending asynchronous operations associated with it.
 
@@ -123,7 +134,8 @@ class frame_test;
 */
 template<
     class NextLayer,
-    bool deflateSupported>
+    bool deflateSupported,
+    class Role>
 class stream
 #if ! BOOST_BEAST_DOXYGEN
     : private stream_base
@@ -357,6 +369,31 @@ public:
     void set_option(timeout const& opt);
 #endif
 
+    /** Track the timeouts of this stream with a shared timeout service.
+
+        By default each stream waits on its own timer to implement
+        the handshake, close and idle timeouts set with the
+        @ref timeout option, and to send keep-alive pings. After this
+        function is called, the stream instead arms an entry in the
+        hashed timing wheel of `svc`, which costs no allocation and
+        no system timer each time the timeout is restarted. Timeouts
+        and keep-alive pings may then happen up to one
+        @ref timeout_service::resolution later than requested.
+
+        When the timeout expires, it is handled in a function posted
+        to the executor of the next layer, rather than to the executor
+        associated with the completion handler of the pending operation.
+
+        This function must not be called while any asynchronous
+        operation is outstanding.
+
+        @param svc The service to use. It is usually obtained with
+        `net::use_service<timeout_service>(ioc)`, where `ioc` is the
+        I/O context of the stream.
+    */
+    void
+    use_timeout_service(timeout_service& svc);
+
     /** Set the permessage-deflate extension options
 
         @throws invalid_argument if `deflateSupported == false`, and either
@@ -527,6 +564,42 @@ public:
     void
     secure_prng(bool value);
 
+    /** Set the pooled read buffer option.
+
+        The stream keeps a small buffer for receiving frame headers
+        and control frames. When this option is `true`, the storage
+        for that buffer is borrowed from a thread-local pool and
+        handed back whenever the stream starts waiting for a new
+        frame with no received data left over. If the next layer
+        reads directly from a socket, as `net::ip::tcp::socket` and
+        @ref beast::basic_stream do, the stream first waits for the
+        socket to become readable and only then borrows the buffer,
+        so that an idle connection holds no read buffer at all.
+        Other next layers, for example an SSL stream, still read into
+        a borrowed buffer while idle.
+
+        Enabling the option reduces the memory used by servers with
+        many mostly idle connections, at the cost of an additional
+        wait operation for each frame received after an idle period.
+
+        The default setting is `false`.
+
+        @par Example
+        Enabling the pooled read buffer.
+        @code
+            ws.pooled_read_buffer(true);
+        @endcode
+
+        @param value `true` if the read buffer should be returned
+        to the pool while the stream is idle.
+    */
+    void
+    pooled_read_buffer(bool value);
+
+    /// Returns `true` if the pooled read buffer option is set.
+    bool
+    pooled_read_buffer() const;
+
     /** Set the write buffer size option.
 
         Sets the size of the write buffer used by the implementation to
@@ -585,6 +658,37 @@ public:
     bool
     text() const;
 
+    /** Set the send queue limit option.
+
+        This sets the high-water mark of the queue holding the frames
+        of messages passed to @ref async_send which have not been
+        written yet. When the queue holds more bytes than the limit,
+        the completion handler of @ref async_send is not invoked
+        until the queue has been written down to the limit or below,
+        which lets a fast producer wait for a slow connection instead
+        of growing the queue without bound.
+
+        The default setting is 65536.
+
+        @par Example
+        Setting the send queue limit.
+        @code
+            ws.send_queue_limit(1024 * 1024);
+        @endcode
+
+        @param amount The limit, in bytes.
+    */
+    void
+    send_queue_limit(std::size_t amount);
+
+    /// Returns the send queue limit.
+    std::size_t
+    send_queue_limit() const;
+
+    /// Returns the number of bytes in the send queue.
+    std::size_t
+    send_queue_size() const;
+
     /*
         timer settings
 
@@ -1942,6 +2046,211 @@ public:
 
     //--------------------------------------------------------------------------
 
+    /** Read one or more complete messages.
+
+        This function is used to read at least one complete message,
+        followed by as many of the messages which were received along
+        with it as will fit in `max_messages`, into a single buffer.
+
+        The call blocks until one of the following is true:
+
+        @li A complete message is received, and the next message
+            is not entirely in the stream's read buffer.
+
+        @li `max_messages` complete messages are received.
+
+        @li A close frame is received. In this case the error indicated by
+            the function will be @ref error::closed.
+
+        @li An error occurs.
+
+        Messages after the first are only read when the stream's read
+        buffer already holds all of them, in a single frame, so that no
+        more calls to the next layer's `read_some` are made once the
+        first message has been received.
+
+        Received message data is appended to the buffer, one message
+        after another. The container `messages` is cleared, and an
+        element is appended to it for each message read, holding the
+        offset of its payload from the start of the buffer's readable
+        bytes, the size of its payload, and whether it is binary.
+        If an error occurs, `messages` holds the messages received
+        completely before it, and the buffer may hold part of the
+        message which failed after them.
+
+        Control frames are handled as described for @ref read.
+
+        @return The number of message payload bytes appended to the buffer.
+
+        @param buffer A dynamic buffer to append message data to.
+
+        @param messages The container to hold the location of each
+        message in the buffer. Its capacity is kept from call to call.
+
+        @param max_messages The largest number of messages to read.
+        This must be greater than zero.
+
+        @throws system_error Thrown on failure.
+    */
+    template<class DynamicBuffer>
+    std::size_t
+    read_many(
+        DynamicBuffer& buffer,
+        std::vector<message_info>& messages,
+        std::size_t max_messages);
+
+    /** Read one or more complete messages.
+
+        This function is used to read at least one complete message,
+        followed by as many of the messages which were received along
+        with it as will fit in `max_messages`, into a single buffer.
+
+        The call blocks until one of the following is true:
+
+        @li A complete message is received, and the next message
+            is not entirely in the stream's read buffer.
+
+        @li `max_messages` complete messages are received.
+
+        @li A close frame is received. In this case the error indicated by
+            the function will be @ref error::closed.
+
+        @li An error occurs.
+
+        Messages after the first are only read when the stream's read
+        buffer already holds all of them, in a single frame, so that no
+        more calls to the next layer's `read_some` are made once the
+        first message has been received.
+
+        Received message data is appended to the buffer, one message
+        after another. The container `messages` is cleared, and an
+        element is appended to it for each message read, holding the
+        offset of its payload from the start of the buffer's readable
+        bytes, the size of its payload, and whether it is binary.
+        If an error occurs, `messages` holds the messages received
+        completely before it, and the buffer may hold part of the
+        message which failed after them.
+
+        Control frames are handled as described for @ref read.
+
+        @return The number of message payload bytes appended to the buffer.
+
+        @param buffer A dynamic buffer to append message data to.
+
+        @param messages The container to hold the location of each
+        message in the buffer. Its capacity is kept from call to call.
+
+        @param max_messages The largest number of messages to read.
+        This must be greater than zero.
+
+        @param ec Set to indicate what error occurred, if any.
+    */
+    template<class DynamicBuffer>
+    std::size_t
+    read_many(
+        DynamicBuffer& buffer,
+        std::vector<message_info>& messages,
+        std::size_t max_messages,
+        error_code& ec);
+
+    /** Read one or more complete messages asynchronously.
+
+        This function is used to asynchronously read at least one
+        complete message, followed by as many of the messages which
+        were received along with it as will fit in `max_messages`,
+        into a single buffer. Applications which process messages in
+        batches use it to invoke one completion handler for all the
+        messages which arrived together, and to see their payloads
+        one after another in the same buffer.
+
+        This call always returns immediately. The asynchronous operation
+        will continue until one of the following conditions is true:
+
+        @li A complete message is received, and the next message
+            is not entirely in the stream's read buffer.
+
+        @li `max_messages` complete messages are received.
+
+        @li A close frame is received. In this case the error indicated by
+            the function will be @ref error::closed.
+
+        @li An error occurs.
+
+        Messages after the first are only read when the stream's read
+        buffer already holds all of them, in a single frame, so that no
+        more calls to the next layer's `async_read_some` are made once
+        the first message has been received. The program must ensure
+        that no other calls to @ref read, @ref read_some, @ref async_read,
+        or @ref async_read_some are performed until this operation
+        completes.
+
+        Received message data is appended to the buffer, one message
+        after another. The container `messages` is cleared, and an
+        element is appended to it for each message read, holding the
+        offset of its payload from the start of the buffer's readable
+        bytes, the size of its payload, and whether it is binary.
+        If an error occurs, `messages` holds the messages received
+        completely before it, and the buffer may hold part of the
+        message which failed after them.
+
+        Control frames are handled as described for @ref async_read.
+
+        @param buffer A dynamic buffer to append message data to.
+
+        @param messages The container to hold the location of each
+        message in the buffer. Its capacity is kept from call to call.
+        The object must remain valid until the completion handler is
+        called.
+
+        @param max_messages The largest number of messages to read.
+        This must be greater than zero.
+
+        @param handler The completion handler to invoke when the operation
+        completes. The implementation takes ownership of the handler by
+        performing a decay-copy. The equivalent function signature of
+        the handler must be:
+        @code
+        void handler(
+            error_code const& ec,       // Result of operation
+            std::size_t bytes_written   // Number of bytes appended to buffer
+        );
+        @endcode
+        Regardless of whether the asynchronous operation completes
+        immediately or not, the handler will not be invoked from within
+        this function. Invocation of the handler will be performed in a
+        manner equivalent to using `net::post`.
+
+        @par Example
+        @code
+        ws.async_read_many(buffer, messages, 64,
+            [&](error_code ec, std::size_t)
+            {
+                if(ec)
+                    return fail(ec);
+                auto const p = static_cast<char const*>(
+                    buffer.data().data());
+                for(auto const& m : messages)
+                    on_message(string_view(p + m.offset, m.size));
+                buffer.clear();
+            });
+        @endcode
+    */
+    template<
+        class DynamicBuffer,
+        BOOST_BEAST_ASYNC_TPARAM2 ReadHandler =
+            net::default_completion_token_t<
+                executor_type>>
+    BOOST_BEAST_ASYNC_RESULT2(ReadHandler)
+    async_read_many(
+        DynamicBuffer& buffer,
+        std::vector<message_info>& messages,
+        std::size_t max_messages,
+        ReadHandler&& handler =
+            net::default_completion_token_t<
+                executor_type>{});
+
+    //--------------------------------------------------------------------------
+
     /** Read some message data.
 
         This function is used to read some message data.
@@ -2541,6 +2850,343 @@ public:
             net::default_completion_token_t<
                 executor_type>{});
 
+    /** Write a prepared message.
+
+        This function is used to write a complete message which was
+        serialized ahead of time.
+
+        The call blocks until one of the following is true:
+
+        @li The message is written.
+
+        @li An error occurs.
+
+        The algorithm, known as a <em>composed operation</em>, is implemented
+        in terms of calls to the next layer's `write_some` function.
+
+        The message opcode is taken from the prepared message, and the
+        @ref binary and @ref auto_fragment options are not used; the
+        message is always sent as a single frame. In the server role
+        the prepared frame is sent unchanged, in the compressed form if
+        permessage-deflate was negotiated with a window at least as large
+        as the one used to prepare it.
+
+        @param msg The message to send.
+
+        @return The number of bytes sent from the payload.
+
+        @throws system_error Thrown on failure.
+
+        @see prepared_message
+    */
+    std::size_t
+    write_prepared(prepared_message const& msg);
+
+    /** Write a prepared message.
+
+        This function is used to write a complete message which was
+        serialized ahead of time.
+
+        The call blocks until one of the following is true:
+
+        @li The message is written.
+
+        @li An error occurs.
+
+        The algorithm, known as a <em>composed operation</em>, is implemented
+        in terms of calls to the next layer's `write_some` function.
+
+        The message opcode is taken from the prepared message, and the
+        @ref binary and @ref auto_fragment options are not used; the
+        message is always sent as a single frame. In the server role
+        the prepared frame is sent unchanged, in the compressed form if
+        permessage-deflate was negotiated with a window at least as large
+        as the one used to prepare it.
+
+        @param msg The message to send.
+
+        @param ec Set to indicate what error occurred, if any.
+
+        @return The number of bytes sent from the payload. If an error
+        occurred, this will be zero.
+
+        @see prepared_message
+    */
+    std::size_t
+    write_prepared(prepared_message const& msg, error_code& ec);
+
+    /** Write a prepared message asynchronously.
+
+        This function is used to asynchronously write a complete message
+        which was serialized ahead of time. It is intended for sending
+        the same message to many streams.
+
+        This call always returns immediately. The asynchronous operation
+        will continue until one of the following conditions is true:
+
+        @li The message is written.
+
+        @li An error occurs.
+
+        The algorithm, known as a <em>composed asynchronous operation</em>,
+        is implemented in terms of calls to the next layer's
+        `async_write_some` function. The program must ensure that no other
+        calls to @ref write, @ref write_some, @ref async_write,
+        @ref async_write_some or @ref async_write_prepared are performed
+        until this operation completes, and that no message is partially
+        written.
+
+        The message opcode is taken from the prepared message, and the
+        @ref binary and @ref auto_fragment options are not used; the
+        message is always sent as a single frame. In the server role
+        the prepared frame is sent unchanged, in the compressed form if
+        permessage-deflate was negotiated with a window at least as large
+        as the one used to prepare it. Sending the compressed form restarts
+        the compressor of the stream. In the client role the payload is
+        masked through the write buffer as with @ref async_write.
+
+        @param msg The message to send. The implementation holds a copy
+        of this object, which shares the frames, until the operation
+        completes.
+
+        @param handler The completion handler to invoke when the operation
+        completes. The implementation takes ownership of the handler by
+        performing a decay-copy. The equivalent function signature of
+        the handler must be:
+        @code
+        void handler(
+            error_code const& ec,           // Result of operation
+            std::size_t bytes_transferred   // Number of bytes sent from the
+                                            // payload, or zero on error.
+        );
+        @endcode
+        Regardless of whether the asynchronous operation completes
+        immediately or not, the handler will not be invoked from within
+        this function. Invocation of the handler will be performed in a
+        manner equivalent to using `net::post`.
+
+        @see prepared_message
+    */
+    template<
+        BOOST_BEAST_ASYNC_TPARAM2 WriteHandler =
+            net::default_completion_token_t<
+                executor_type>>
+    BOOST_BEAST_ASYNC_RESULT2(WriteHandler)
+    async_write_prepared(
+        prepared_message const& msg,
+        WriteHandler&& handler =
+            net::default_completion_token_t<
+                executor_type>{});
+
+    /** Write a complete message in place.
+
+        This function is used to write a complete message from buffers
+        owned by the caller, without copying the payload.
+
+        The call blocks until one of the following is true:
+
+        @li The message is written.
+
+        @li An error occurs.
+
+        The algorithm, known as a <em>composed operation</em>, is implemented
+        in terms of calls to the next layer's `write_some` function.
+
+        The message opcode is set by the @ref binary option. The
+        @ref auto_fragment option is not used, and the message is
+        never compressed, even when permessage-deflate is negotiated;
+        it is always sent as a single frame, with the frame header
+        and the payload sent together in one gathered write. In the
+        client role the payload is masked in place, so no copy of it
+        is made into the write buffer.
+
+        @param buffers The buffers containing the message to send. In
+        the client role the contents are masked when the function
+        returns, and the caller must restore or discard them.
+
+        @return The number of bytes sent from the buffers.
+
+        @throws system_error Thrown on failure.
+    */
+    template<class MutableBufferSequence>
+    std::size_t
+    write_inplace(MutableBufferSequence const& buffers);
+
+    /** Write a complete message in place.
+
+        This function is used to write a complete message from buffers
+        owned by the caller, without copying the payload.
+
+        The call blocks until one of the following is true:
+
+        @li The message is written.
+
+        @li An error occurs.
+
+        The algorithm, known as a <em>composed operation</em>, is implemented
+        in terms of calls to the next layer's `write_some` function.
+
+        The message opcode is set by the @ref binary option. The
+        @ref auto_fragment option is not used, and the message is
+        never compressed, even when permessage-deflate is negotiated;
+        it is always sent as a single frame, with the frame header
+        and the payload sent together in one gathered write. In the
+        client role the payload is masked in place, so no copy of it
+        is made into the write buffer.
+
+        @param buffers The buffers containing the message to send. In
+        the client role the contents are masked when the function
+        returns, and the caller must restore or discard them.
+
+        @param ec Set to indicate what error occurred, if any.
+
+        @return The number of bytes sent from the buffers.
+    */
+    template<class MutableBufferSequence>
+    std::size_t
+    write_inplace(
+        MutableBufferSequence const& buffers, error_code& ec);
+
+    /** Write a complete message in place asynchronously.
+
+        This function is used to asynchronously write a complete message
+        from buffers owned by the caller, without copying the payload.
+
+        This call always returns immediately. The asynchronous operation
+        will continue until one of the following conditions is true:
+
+        @li The message is written.
+
+        @li An error occurs.
+
+        The algorithm, known as a <em>composed asynchronous operation</em>,
+        is implemented in terms of calls to the next layer's
+        `async_write_some` function. The program must ensure that no other
+        calls to @ref write, @ref write_some, @ref async_write,
+        @ref async_write_some, @ref async_write_prepared or
+        @ref async_write_inplace are performed until this operation
+        completes, and that no message is partially written.
+
+        The message opcode is set by the @ref binary option. The
+        @ref auto_fragment option is not used, and the message is
+        never compressed, even when permessage-deflate is negotiated;
+        it is always sent as a single frame, with the frame header
+        and the payload sent together in one gathered write. In the
+        client role the payload is masked in place, so no copy of it
+        is made into the write buffer.
+
+        @param buffers The buffers containing the message to send. The
+        implementation will make copies of the buffers object as needed,
+        but ownership of the underlying memory is not transferred. The
+        caller is responsible for ensuring that the memory locations
+        pointed to by buffers remain valid until the completion handler
+        is called. In the client role the contents are masked when the
+        operation completes, and the caller must restore or discard them.
+
+        @param handler The completion handler to invoke when the operation
+        completes. The implementation takes ownership of the handler by
+        performing a decay-copy. The equivalent function signature of
+        the handler must be:
+        @code
+        void handler(
+            error_code const& ec,           // Result of operation
+            std::size_t bytes_transferred   // Number of bytes sent from the
+                                            // buffers.
+        );
+        @endcode
+        Regardless of whether the asynchronous operation completes
+        immediately or not, the handler will not be invoked from within
+        this function. Invocation of the handler will be performed in a
+        manner equivalent to using `net::post`.
+    */
+    template<
+        class MutableBufferSequence,
+        BOOST_BEAST_ASYNC_TPARAM2 WriteHandler =
+            net::default_completion_token_t<
+                executor_type>>
+    BOOST_BEAST_ASYNC_RESULT2(WriteHandler)
+    async_write_inplace(
+        MutableBufferSequence const& buffers,
+        WriteHandler&& handler =
+            net::default_completion_token_t<
+                executor_type>{});
+
+    /** Queue a complete message for sending asynchronously.
+
+        This function is used to send a complete message without
+        waiting for other writes on the stream to finish. The message
+        is sent as a single, uncompressed frame of the type selected
+        with @ref text or @ref binary, and the frame is copied into
+        a queue owned by the stream, so the buffers need not remain
+        valid after the call returns.
+
+        Frames which are queued while the stream is busy writing are
+        sent together, with one call to the next layer's `async_write_some`
+        for all of them when possible, as soon as the previous write
+        finishes. Other write operations and pings are sent between
+        these batches and are not delayed by them. A close frame is
+        sent after all of the messages queued before it.
+
+        Unlike @ref async_write, any number of calls to this function
+        may be made without waiting for the completion of the previous
+        ones, and they may be made while an @ref async_write is pending.
+        The completion handler is invoked once the message is in the
+        queue, if the queue does not hold more than the limit set with
+        @ref send_queue_limit, or once enough of the queue has been
+        written otherwise. An error writing queued frames is reported
+        to the operations on the stream which follow it.
+
+        While a message started with @ref write_some or
+        @ref async_write_some is incomplete, the queued frames
+        are held until it is finished. If the stream is closed
+        before that, the frames still queued are discarded.
+
+        @param buffers The buffers containing the message to send.
+
+        @param handler The completion handler to invoke when the operation
+        completes. The implementation takes ownership of the handler by
+        performing a decay-copy. The equivalent function signature of
+        the handler must be:
+        @code
+        void handler(
+            error_code const& ec,           // Result of operation
+            std::size_t bytes_transferred   // Number of bytes queued from the
+                                            // buffers. If an error occurred,
+                                            // this will be zero.
+        );
+        @endcode
+        Regardless of whether the asynchronous operation completes
+        immediately or not, the handler will not be invoked from within
+        this function. Invocation of the handler will be performed in a
+        manner equivalent to using `net::post`.
+
+        @par Example
+        @code
+        void on_message(std::string const& s)
+        {
+            for(auto& ws : sessions)
+                ws->async_send(net::buffer(s),
+                    [](error_code ec, std::size_t)
+                    {
+                        ...
+                    });
+        }
+        @endcode
+
+        @see send_queue_limit
+    */
+    template<
+        class ConstBufferSequence,
+        BOOST_BEAST_ASYNC_TPARAM2 WriteHandler =
+            net::default_completion_token_t<
+                executor_type>>
+    BOOST_BEAST_ASYNC_RESULT2(WriteHandler)
+    async_send(
+        ConstBufferSequence const& buffers,
+        WriteHandler&& handler =
+            net::default_completion_token_t<
+                executor_type>{});
+
 private:
     template<class, class>  class accept_op;
     template<class>         class close_op;
@@ -2549,9 +3195,14 @@ private:
     template<class>         class idle_ping_op;
     template<class, class>  class read_some_op;
     template<class, class>  class read_op;
+    template<class, class>  class read_many_op;
     template<class>         class response_op;
     template<class, class>  class write_some_op;
     template<class, class>  class write_op;
+    template<class>         class write_prepared_op;
+    template<class, class>  class write_inplace_op;
+    template<class, class>  class send_op;
+    template<class>         class send_flush_op;
 
     struct run_accept_op;
     struct run_close_op;
@@ -2560,9 +3211,13 @@ private:
     struct run_idle_ping_op;
     struct run_read_some_op;
     struct run_read_op;
+    struct run_read_many_op;
     struct run_response_op;
     struct run_write_some_op;
     struct run_write_op;
+    struct run_write_prepared_op;
+    struct run_write_inplace_op;
+    struct run_send_op;
 
     static void default_decorate_req(request_type&) {}
     static void default_decorate_res(response_type&) {}
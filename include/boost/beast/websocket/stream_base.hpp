@@ -14,6 +14,7 @@
 #include <boost/beast/websocket/detail/decorator.hpp>
 #include <boost/beast/core/role.hpp>
 #include <chrono>
+#include <cstddef>
 #include <type_traits>
 
 namespace boost {
@@ -54,7 +55,7 @@ struct stream_base
     {
         detail::decorator d_;
 
-        template<class, bool>
+        template<class, bool, class>
         friend class stream;
 
     public:
@@ -159,6 +160,20 @@ struct stream_base
         }
     };
 
+    /** The location of a message read by @ref stream::read_many.
+    */
+    struct message_info
+    {
+        /// The offset of the payload from the start of the buffer
+        std::size_t offset;
+
+        /// The size of the payload
+        std::size_t size;
+
+        /// `true` if this is a binary message
+        bool binary;
+    };
+
 protected:
     enum class status
     {
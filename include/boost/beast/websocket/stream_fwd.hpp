@@ -11,6 +11,7 @@
 #define BOOST_BEAST_WEBSOCKET_STREAM_FWD_HPP
 
 #include <boost/beast/core/detail/config.hpp>
+#include <boost/beast/websocket/role.hpp>
 
 //[code_websocket_1h
 
@@ -20,7 +21,8 @@ namespace websocket {
 
 template<
     class NextLayer,
-    bool deflateSupported = true>
+    bool deflateSupported = true,
+    class Role = any_role>
 class stream;
 
 } // websocket
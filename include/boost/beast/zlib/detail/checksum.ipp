@@ -0,0 +1,83 @@
+//
+// Copyright (c) 2016-2019 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/boostorg/beast
+//
+
+#ifndef BOOST_BEAST_ZLIB_DETAIL_CHECKSUM_IPP
+#define BOOST_BEAST_ZLIB_DETAIL_CHECKSUM_IPP
+
+#include <boost/beast/zlib/detail/checksum.hpp>
+
+namespace boost {
+namespace beast {
+namespace zlib {
+namespace detail {
+
+struct crc32_table
+{
+    std::uint32_t v[256];
+
+    crc32_table() noexcept
+    {
+        for(std::uint32_t n = 0; n < 256; ++n)
+        {
+            std::uint32_t c = n;
+            for(int k = 0; k < 8; ++k)
+                c = (c & 1) ? 0xedb88320UL ^ (c >> 1) : c >> 1;
+            v[n] = c;
+        }
+    }
+};
+
+std::uint32_t
+crc32(
+    std::uint32_t crc,
+    void const* data,
+    std::size_t size) noexcept
+{
+    static crc32_table const table;
+    auto p = static_cast<unsigned char const*>(data);
+    crc = crc ^ 0xffffffffUL;
+    while(size--)
+        crc = table.v[(crc ^ *p++) & 0xff] ^ (crc >> 8);
+    return crc ^ 0xffffffffUL;
+}
+
+std::uint32_t
+adler32(
+    std::uint32_t adler,
+    void const* data,
+    std::size_t size) noexcept
+{
+    // largest n such that 255n(n+1)/2 + (n+1)(65520) <= 2^32-1
+    std::size_t constexpr nmax = 5552;
+    std::uint32_t constexpr base = 65521;
+
+    auto p = static_cast<unsigned char const*>(data);
+    std::uint32_t a = adler & 0xffff;
+    std::uint32_t b = adler >> 16;
+    while(size > 0)
+    {
+        auto n = size < nmax ? size : nmax;
+        size -= n;
+        while(n--)
+        {
+            a += *p++;
+            b += a;
+        }
+        a %= base;
+        b %= base;
+    }
+    return (b << 16) | a;
+}
+
+} // detail
+} // zlib
+} // beast
+} // boost
+
+#endif
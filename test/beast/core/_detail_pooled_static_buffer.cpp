@@ -0,0 +1,99 @@
+//
+// Copyright (c) 2016-2019 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/boostorg/beast
+//
+
+// Test that header file is self-contained.
+#include <boost/beast/core/detail/pooled_static_buffer.hpp>
+
+#include <boost/beast/core/detail/wait_read.hpp>
+#include <boost/beast/core/tcp_stream.hpp>
+#include <boost/beast/core/buffer_traits.hpp>
+#include <boost/beast/core/buffers_to_string.hpp>
+#include <boost/beast/core/ostream.hpp>
+#include <boost/beast/_experimental/test/stream.hpp>
+#include <boost/beast/_experimental/unit_test/suite.hpp>
+#include <boost/asio/ip/tcp.hpp>
+
+namespace boost {
+namespace beast {
+namespace detail {
+
+BOOST_STATIC_ASSERT(net::is_dynamic_buffer<
+    pooled_static_buffer<1536>>::value);
+
+BOOST_STATIC_ASSERT(is_wait_readable<
+    net::ip::tcp::socket>::value);
+BOOST_STATIC_ASSERT(is_wait_readable<tcp_stream>::value);
+BOOST_STATIC_ASSERT(! is_wait_readable<test::stream>::value);
+
+class pooled_static_buffer_test : public beast::unit_test::suite
+{
+public:
+    void
+    testBuffer()
+    {
+        pooled_static_buffer<64> b;
+        BEAST_EXPECT(! b.is_acquired());
+        BEAST_EXPECT(b.size() == 0);
+        BEAST_EXPECT(b.capacity() == 64);
+        BEAST_EXPECT(b.max_size() == 64);
+        BEAST_EXPECT(buffer_bytes(b.data()) == 0);
+        BEAST_EXPECT(buffer_bytes(b.cdata()) == 0);
+        b.consume(10);
+        b.commit(0);
+        b.clear();
+        BEAST_EXPECT(b.release());
+        BEAST_EXPECT(! b.is_acquired());
+
+        ostream(b) << "Hello";
+        BEAST_EXPECT(b.is_acquired());
+        BEAST_EXPECT(buffers_to_string(b.data()) == "Hello");
+        BEAST_EXPECT(! b.release());
+        BEAST_EXPECT(b.is_acquired());
+        BEAST_EXPECT(buffers_to_string(b.data()) == "Hello");
+
+        // wraps around
+        b.consume(3);
+        b.commit(net::buffer_copy(b.prepare(60),
+            net::buffer(std::string(60, '*'))));
+        BEAST_EXPECT(b.size() == 62);
+        BEAST_EXPECT(buffers_to_string(b.data()) ==
+            "lo" + std::string(60, '*'));
+        try
+        {
+            b.prepare(3);
+            fail("", __FILE__, __LINE__);
+        }
+        catch(std::length_error const&)
+        {
+            pass();
+        }
+
+        b.consume(b.size());
+        BEAST_EXPECT(b.release());
+        BEAST_EXPECT(! b.is_acquired());
+        BEAST_EXPECT(b.size() == 0);
+
+        b.acquire();
+        BEAST_EXPECT(b.is_acquired());
+        b.acquire();
+        BEAST_EXPECT(b.release());
+    }
+
+    void
+    run() override
+    {
+        testBuffer();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(beast,core,pooled_static_buffer);
+
+} // detail
+} // beast
+} // boost
@@ -23,6 +23,7 @@
 #include <boost/beast/http/string_body.hpp>
 #include <boost/beast/http/write.hpp>
 #include <boost/asio/ip/tcp.hpp>
+#include <boost/asio/read.hpp>
 #include <boost/asio/spawn.hpp>
 #include <boost/asio/strand.hpp>
 #include <boost/asio/write.hpp>
@@ -501,6 +502,17 @@ public:
             ioc.restart();
         }
 
+        {
+            // success, with a timeout too far away to represent
+            test_server srv("*", ep, log);
+            stream_type s(ioc);
+            s.socket().connect(srv.local_endpoint());
+            s.expires_after((std::chrono::steady_clock::duration::max)());
+            s.async_read_some(mb, handler({}, 1));
+            ioc.run();
+            ioc.restart();
+        }
+
         {
             // empty buffer
             test_server srv("*", ep, log);
@@ -1394,6 +1406,232 @@ public:
         }
     }
 
+    void
+    testTimeoutService()
+    {
+        using stream_type = basic_stream<tcp,
+            net::io_context::executor_type>;
+
+        char buf[4];
+        net::io_context ioc;
+        auto& svc = net::use_service<timeout_service>(ioc);
+        svc.resolution(std::chrono::milliseconds(10));
+        net::mutable_buffer mb(buf, sizeof(buf));
+        auto const ep = net::ip::tcp::endpoint(
+            net::ip::make_address("127.0.0.1"), 0);
+
+        {
+            // success, with timeout
+            test_server srv("*", ep, log);
+            stream_type s(ioc);
+            s.use_timeout_service(svc);
+            s.socket().connect(srv.local_endpoint());
+            s.expires_after(std::chrono::seconds(30));
+            s.async_read_some(mb, handler({}, 1));
+            ioc.run();
+            ioc.restart();
+            BEAST_EXPECT(svc.size() == 0);
+        }
+
+        {
+            // read timeout
+            test_server srv("", ep, log);
+            stream_type s(ioc);
+            s.use_timeout_service(svc);
+            s.socket().connect(srv.local_endpoint());
+            s.expires_after(std::chrono::milliseconds(20));
+            s.async_read_some(mb, handler(error::timeout, 0));
+            ioc.run();
+            ioc.restart();
+            BEAST_EXPECT(! s.socket().is_open());
+        }
+
+        {
+            // write timeout
+            test_server srv("", ep, log);
+            stream_type s(ioc);
+            s.use_timeout_service(svc);
+            s.socket().connect(srv.local_endpoint());
+            s.expires_at(std::chrono::steady_clock::now());
+            s.async_write_some(net::const_buffer{},
+                handler(error::timeout, 0));
+            ioc.run();
+            ioc.restart();
+        }
+
+        {
+            // connect timeout
+            test_acceptor a;
+            stream_type s(ioc);
+            s.use_timeout_service(svc);
+            s.expires_after(std::chrono::seconds(30));
+            s.async_connect(a.ep,
+                [this](error_code ec)
+                {
+                    BEAST_EXPECTS(! ec, ec.message());
+                });
+            ioc.run();
+            ioc.restart();
+            BEAST_EXPECT(svc.size() == 0);
+        }
+
+        {
+            // stream destroyed
+            test_server srv("", ep, log);
+            {
+                stream_type s(ioc);
+                s.use_timeout_service(svc);
+                s.socket().connect(srv.local_endpoint());
+                s.expires_after(std::chrono::milliseconds(10));
+                s.async_read_some(mb,
+                    [](error_code, std::size_t)
+                    {
+                    });
+            }
+            ioc.run();
+            ioc.restart();
+            BEAST_EXPECT(svc.size() == 0);
+        }
+
+        {
+            // closed during a rate limit wait, then reused
+            using rate_stream_type = basic_stream<tcp,
+                net::io_context::executor_type,
+                simple_rate_policy>;
+            test_server srv1("**", ep, log);
+            test_server srv2("*", ep, log);
+            rate_stream_type s(ioc);
+            s.use_timeout_service(svc);
+            s.rate_policy().read_limit(1);
+            s.socket().connect(srv1.local_endpoint());
+            s.expires_after(std::chrono::seconds(30));
+            s.async_read_some(mb,
+                [&](error_code ec, std::size_t n)
+                {
+                    BEAST_EXPECTS(! ec, ec.message());
+                    BEAST_EXPECT(n == 1);
+                    s.async_read_some(mb, handler(
+                        net::error::operation_aborted, 0));
+                    s.close();
+                });
+            ioc.run();
+            ioc.restart();
+            BEAST_EXPECT(svc.size() == 0);
+
+            s.socket().connect(srv2.local_endpoint());
+            s.expires_after(std::chrono::seconds(30));
+            s.async_read_some(mb,
+                [&](error_code ec, std::size_t n)
+                {
+                    BEAST_EXPECTS(! ec, ec.message());
+                    BEAST_EXPECT(n == 1);
+                    // stop the rate timer
+                    s.close();
+                });
+            ioc.run();
+            ioc.restart();
+            BEAST_EXPECT(svc.size() == 0);
+        }
+    }
+
+    void
+    testAsyncWait()
+    {
+        using stream_type = basic_stream<tcp,
+            net::io_context::executor_type>;
+
+        net::io_context ioc;
+        auto const ep = net::ip::tcp::endpoint(
+            net::ip::make_address("127.0.0.1"), 0);
+
+        {
+            // readable, with timeout
+            test_server srv("*", ep, log);
+            stream_type s(ioc);
+            s.socket().connect(srv.local_endpoint());
+            s.expires_after(std::chrono::seconds(30));
+            s.async_wait(net::socket_base::wait_read,
+                [this](error_code ec)
+                {
+                    BEAST_EXPECTS(! ec, ec.message());
+                });
+            ioc.run();
+            ioc.restart();
+            BEAST_EXPECT(s.socket().available() > 0);
+        }
+
+        {
+            // writable, no timeout
+            test_server srv("", ep, log);
+            stream_type s(ioc);
+            s.socket().connect(srv.local_endpoint());
+            s.async_wait(net::socket_base::wait_write,
+                [this](error_code ec)
+                {
+                    BEAST_EXPECTS(! ec, ec.message());
+                });
+            ioc.run();
+            ioc.restart();
+        }
+
+        {
+            // read timeout
+            test_server srv("", ep, log);
+            stream_type s(ioc);
+            s.socket().connect(srv.local_endpoint());
+            s.expires_after(std::chrono::milliseconds(20));
+            s.async_wait(net::socket_base::wait_read,
+                [this](error_code ec)
+                {
+                    BEAST_EXPECTS(ec == error::timeout,
+                        ec.message());
+                });
+            ioc.run();
+            ioc.restart();
+            BEAST_EXPECT(! s.socket().is_open());
+        }
+    }
+
+    void
+    testSharedRatePolicy()
+    {
+        using stream_type = basic_stream<tcp,
+            net::io_context::executor_type,
+            shared_rate_policy>;
+
+        // two streams share a read budget of 100KB/s
+        // with a 10KB burst, reading 20KB each.
+        std::string const body(20000, '*');
+        net::io_context ioc;
+        auto const ep = net::ip::tcp::endpoint(
+            net::ip::make_address("127.0.0.1"), 0);
+        test_server srv(body, ep, log);
+        auto const b = std::make_shared<
+            shared_rate_policy::bucket>(100000, 10000);
+        std::string s0, s1;
+        stream_type st0(shared_rate_policy(b, nullptr), ioc);
+        stream_type st1(shared_rate_policy(b, nullptr), ioc);
+        BEAST_EXPECT(b->users() == 2);
+        st0.socket().connect(srv.local_endpoint());
+        st1.socket().connect(srv.local_endpoint());
+        auto const start = std::chrono::steady_clock::now();
+        auto const on_read =
+            [this](error_code ec, std::size_t)
+            {
+                BEAST_EXPECTS(ec == net::error::eof, ec.message());
+            };
+        net::async_read(st0, net::dynamic_buffer(s0), on_read);
+        net::async_read(st1, net::dynamic_buffer(s1), on_read);
+        ioc.run();
+        auto const elapsed =
+            std::chrono::steady_clock::now() - start;
+        BEAST_EXPECT(s0 == body);
+        BEAST_EXPECT(s1 == body);
+        // (40000 - 10000) bytes at 100000 bytes per second
+        BEAST_EXPECT(elapsed >= std::chrono::milliseconds(250));
+        BEAST_EXPECT(elapsed < std::chrono::seconds(5));
+    }
+
     void
     run()
     {
@@ -1404,6 +1642,9 @@ public:
         testMembers();
         testJavadocs();
         testIssue1589();
+        testTimeoutService();
+        testAsyncWait();
+        testSharedRatePolicy();
 
 #if BOOST_ASIO_HAS_CO_AWAIT
         // test for compilation success only
@@ -10,7 +10,11 @@
 // Test that header file is self-contained.
 #include <boost/beast/core/buffered_read_stream.hpp>
 
+#include <boost/beast/core/buffers_to_string.hpp>
+#include <boost/beast/core/flat_buffer.hpp>
+#include <boost/beast/core/flat_static_buffer.hpp>
 #include <boost/beast/core/multi_buffer.hpp>
+#include <boost/beast/core/ostream.hpp>
 #include <boost/beast/_experimental/test/stream.hpp>
 #include <boost/beast/_experimental/unit_test/suite.hpp>
 #include <boost/beast/core/bind_handler.hpp>
@@ -214,6 +218,76 @@ public:
         BEAST_EXPECT(n < limit);
     }
 
+    void
+    testFill(yield_context do_yield)
+    {
+        {
+            // bytes are appended, then read back
+            test::stream ts(ioc_, "Hello");
+            buffered_read_stream<
+                test::stream&, flat_buffer> srs(ts);
+            ostream(srs.buffer()) << "GET";
+            error_code ec;
+            auto n = srs.fill(ec);
+            BEAST_EXPECTS(! ec, ec.message());
+            BEAST_EXPECT(n == 5);
+            BEAST_EXPECT(buffers_to_string(
+                srs.buffer().data()) == "GETHello");
+            srs.buffer().consume(3);
+            std::string s(5, 0);
+            n = net::read(srs, net::buffer(&s[0], s.size()));
+            BEAST_EXPECT(n == 5);
+            BEAST_EXPECT(s == "Hello");
+            ts.close_remote();
+            srs.fill(ec);
+            BEAST_EXPECT(ec == net::error::eof);
+        }
+
+        {
+            // asynchronous, read in pieces
+            test::stream ts(ioc_, "Hello, world!");
+            ts.read_size(5);
+            buffered_read_stream<
+                test::stream&, flat_buffer> srs(ts);
+            error_code ec;
+            auto n = srs.async_fill(do_yield[ec]);
+            BEAST_EXPECTS(! ec, ec.message());
+            BEAST_EXPECT(n == 5);
+            n = srs.async_fill(do_yield[ec]);
+            BEAST_EXPECTS(! ec, ec.message());
+            BEAST_EXPECT(n == 5);
+            BEAST_EXPECT(buffers_to_string(
+                srs.buffer().data()) == "Hello, wor");
+        }
+
+        {
+            // buffer is full
+            test::stream ts(ioc_, "Hello");
+            buffered_read_stream<
+                test::stream&, flat_static_buffer<4>> srs(ts);
+            error_code ec;
+            auto n = srs.fill(ec);
+            BEAST_EXPECTS(! ec, ec.message());
+            BEAST_EXPECT(n == 4);
+            n = srs.fill(ec);
+            BEAST_EXPECT(ec == net::error::no_buffer_space);
+            BEAST_EXPECT(n == 0);
+            n = srs.async_fill(do_yield[ec]);
+            BEAST_EXPECT(ec == net::error::no_buffer_space);
+            BEAST_EXPECT(n == 0);
+            try
+            {
+                srs.fill();
+                fail("", __FILE__, __LINE__);
+            }
+            catch(system_error const& e)
+            {
+                BEAST_EXPECT(e.code() ==
+                    net::error::no_buffer_space);
+            }
+        }
+    }
+
     struct copyable_handler
     {
         template<class... Args>
@@ -247,6 +321,10 @@ public:
         {
             testRead(yield);
         });
+        yield_to([&](yield_context yield)
+        {
+            testFill(yield);
+        });
         testAsyncLoop();
 
 #if BOOST_ASIO_HAS_CO_AWAIT
@@ -46,6 +46,9 @@ public:
     void run() override
     {
         check(condition::timeout, error::timeout);
+        check(error::bad_proxy_header);
+        BEAST_EXPECT(make_error_code(error::bad_proxy_header) !=
+            condition::timeout);
     }
 };
 
@@ -15,7 +15,9 @@
 #include <boost/beast/_experimental/unit_test/suite.hpp>
 #include <boost/beast/_experimental/test/stream.hpp>
 #include <boost/beast/core/role.hpp>
+#include <array>
 #include <initializer_list>
+#include <string>
 #include <vector>
 #if BOOST_ASIO_HAS_CO_AWAIT
 #include <boost/asio/use_awaitable.hpp>
@@ -209,6 +211,92 @@ public:
         check({1,2,3},      4,    3, true);
         check({1,2,3},      7,    6, true);
         check({1,2,3,4},    3,    3, true);
+        check({0,2,3},      0,    2, false);
+        check({0,0,2,3},    1,    2, false);
+        check({0,1,2},      3,    3, true);
+        check({0,0},        1,    0, false);
+    }
+
+    void
+    testCoalesce()
+    {
+        net::io_context ioc;
+        std::string const s0(9000, 'a');
+        std::string const s1(3000, 'b');
+        std::string const s2(200, 'c');
+        std::array<net::const_buffer, 3> const bs{{
+            net::buffer(s0), net::buffer(s1), net::buffer(s2)}};
+
+        auto const check =
+            [&](std::size_t limit, std::size_t expected)
+            {
+                // sync
+                {
+                    flat_stream<test::stream> s(ioc);
+                    test::stream ts(ioc);
+                    s.next_layer().connect(ts);
+                    s.coalesce_limit(limit);
+                    BEAST_EXPECT(s.coalesce_limit() == limit);
+                    error_code ec;
+                    auto const n = s.write_some(bs, ec);
+                    BEAST_EXPECTS(! ec, ec.message());
+                    BEAST_EXPECT(n == expected);
+                    BEAST_EXPECT(ts.str() ==
+                        (s0 + s1 + s2).substr(0, expected));
+                }
+
+                // async
+                {
+                    flat_stream<test::stream> s(ioc);
+                    test::stream ts(ioc);
+                    s.next_layer().connect(ts);
+                    s.coalesce_limit(limit);
+                    std::size_t n = 0;
+                    s.async_write_some(bs,
+                        [&](error_code ec, std::size_t bytes_transferred)
+                        {
+                            BEAST_EXPECTS(! ec, ec.message());
+                            n = bytes_transferred;
+                        });
+                    ioc.run();
+                    ioc.restart();
+                    BEAST_EXPECT(n == expected);
+                    BEAST_EXPECT(ts.str() ==
+                        (s0 + s1 + s2).substr(0, expected));
+                }
+            };
+
+        BEAST_EXPECT(flat_stream<test::stream>(ioc).coalesce_limit() ==
+            detail::flat_stream_base::max_size);
+        check(detail::flat_stream_base::max_size, 12200);
+        check(12000, 12000);
+        check(9001, 9000);
+        check(9000, 9000);
+        check(0, 9000);
+
+        // leading empty buffers are skipped
+        {
+            std::array<net::const_buffer, 3> const bs2{{
+                net::const_buffer(), net::buffer(s0), net::buffer(s1)}};
+            flat_stream<test::stream> s(ioc);
+            test::stream ts(ioc);
+            s.next_layer().connect(ts);
+            s.coalesce_limit(0);
+            error_code ec;
+            BEAST_EXPECT(s.write_some(bs2, ec) == s0.size());
+            BEAST_EXPECTS(! ec, ec.message());
+            std::size_t n = 0;
+            s.async_write_some(bs2,
+                [&](error_code ec, std::size_t bytes_transferred)
+                {
+                    BEAST_EXPECTS(! ec, ec.message());
+                    n = bytes_transferred;
+                });
+            ioc.run();
+            ioc.restart();
+            BEAST_EXPECT(n == s0.size());
+            BEAST_EXPECT(ts.str() == s0 + s0);
+        }
     }
 
 #if BOOST_ASIO_HAS_CO_AWAIT
@@ -232,6 +320,7 @@ public:
     {
         testMembers();
         testSplit();
+        testCoalesce();
 #if BOOST_ASIO_HAS_CO_AWAIT
     boost::ignore_unused(&flat_stream_test::testAwaitableCompiles);
 #endif
@@ -0,0 +1,143 @@
+//
+// Copyright (c) 2016-2019 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/boostorg/beast
+//
+
+// Test that header file is self-contained.
+#include <boost/beast/core/pooled_allocator.hpp>
+
+#include "test_buffer.hpp"
+
+#include <boost/beast/core/ostream.hpp>
+#include <boost/beast/_experimental/unit_test/suite.hpp>
+#include <thread>
+#include <vector>
+
+namespace boost {
+namespace beast {
+
+BOOST_STATIC_ASSERT(
+    is_mutable_dynamic_buffer<pooled_flat_buffer>::value);
+
+class pooled_allocator_test : public beast::unit_test::suite
+{
+public:
+    void
+    testBlockCache()
+    {
+        using detail::block_cache;
+        BEAST_EXPECT(block_cache::block_size(1) == 512);
+        BEAST_EXPECT(block_cache::block_size(512) == 512);
+        BEAST_EXPECT(block_cache::block_size(513) == 1024);
+        BEAST_EXPECT(block_cache::block_size(
+            1024 * 1024) == 1024 * 1024);
+        BEAST_EXPECT(block_cache::block_size(
+            1024 * 1024 + 1) == 1024 * 1024 + 1);
+
+        // same thread reuse
+        {
+            auto const p = block_cache::allocate(1000);
+            block_cache::deallocate(p, 1000);
+            auto const q = block_cache::allocate(600);
+            BEAST_EXPECT(q == p);
+            block_cache::deallocate(q, 600);
+        }
+
+        // uncached sizes
+        {
+            std::size_t const n = 2 * 1024 * 1024;
+            auto const p = block_cache::allocate(n);
+            block_cache::deallocate(p, n);
+            block_cache::deallocate(nullptr, n);
+        }
+
+        // free list limit
+        {
+            std::vector<void*> v;
+            for(int i = 0; i < 8; ++i)
+                v.push_back(block_cache::allocate(512 * 1024));
+            for(auto p : v)
+                block_cache::deallocate(p, 512 * 1024);
+        }
+    }
+
+    void
+    testCrossThread()
+    {
+        using detail::block_cache;
+        std::vector<void*> v;
+        for(int i = 0; i < 16; ++i)
+            v.push_back(block_cache::allocate(4096));
+        std::thread t(
+            [&v]
+            {
+                for(auto p : v)
+                    block_cache::deallocate(p, 4096);
+                v.clear();
+            });
+        t.join();
+        BEAST_EXPECT(v.empty());
+    }
+
+    void
+    testAllocator()
+    {
+        pooled_allocator<char> a;
+        pooled_allocator<int> b(a);
+        BEAST_EXPECT(a == b);
+        BEAST_EXPECT(! (a != b));
+
+        auto const p = b.allocate(200);
+        b.deallocate(p, 200);
+        auto const q = a.allocate(800);
+        BEAST_EXPECT(static_cast<void*>(q) == p);
+        a.deallocate(q, 800);
+
+        std::vector<int, pooled_allocator<int>> v;
+        for(int i = 0; i < 1000; ++i)
+            v.push_back(i);
+        BEAST_EXPECT(v[999] == 999);
+    }
+
+    void
+    testFlatBuffer()
+    {
+        {
+            pooled_flat_buffer b(30);
+            BEAST_EXPECT(b.max_size() == 30);
+            test_dynamic_buffer(b);
+        }
+
+        // storage released by one buffer
+        // is picked up by the next one
+        void const* data;
+        {
+            pooled_flat_buffer b;
+            ostream(b) << std::string(1000, '*');
+            data = b.data().data();
+        }
+        {
+            pooled_flat_buffer b;
+            b.prepare(1000);
+            BEAST_EXPECT(b.data().data() == data);
+        }
+    }
+
+    void
+    run() override
+    {
+        testBlockCache();
+        testCrossThread();
+        testAllocator();
+        testFlatBuffer();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(beast,core,pooled_allocator);
+
+} // beast
+} // boost
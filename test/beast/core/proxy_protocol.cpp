@@ -0,0 +1,354 @@
+//
+// Copyright (c) 2016-2019 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/boostorg/beast
+//
+
+// Test that header file is self-contained.
+#include <boost/beast/core/proxy_protocol.hpp>
+
+#include <boost/beast/_experimental/unit_test/suite.hpp>
+#include <boost/beast/_experimental/test/stream.hpp>
+#include <boost/beast/_experimental/test/handler.hpp>
+#include <boost/beast/core/buffers_to_string.hpp>
+#include <boost/beast/core/flat_buffer.hpp>
+#include <boost/beast/core/flat_static_buffer.hpp>
+#include <boost/beast/core/multi_buffer.hpp>
+#include <boost/beast/core/string.hpp>
+#include <array>
+#include <string>
+
+namespace boost {
+namespace beast {
+
+class proxy_protocol_test : public unit_test::suite
+{
+public:
+    using endpoint = net::ip::tcp::endpoint;
+
+    static
+    endpoint
+    ep(char const* addr, unsigned short port)
+    {
+        return endpoint(net::ip::make_address(addr), port);
+    }
+
+    static
+    std::string
+    v2(
+        unsigned char ver_cmd,
+        unsigned char fam,
+        std::string const& payload)
+    {
+        std::string s(
+            "\x0D\x0A\x0D\x0A\x00\x0D\x0A\x51\x55\x49\x54\x0A", 12);
+        s += static_cast<char>(ver_cmd);
+        s += static_cast<char>(fam);
+        s += static_cast<char>(payload.size() >> 8);
+        s += static_cast<char>(payload.size() & 0xff);
+        return s + payload;
+    }
+
+    // Every proper prefix needs more input, and the
+    // complete header is consumed exactly.
+    void
+    good(
+        string_view s,
+        int version,
+        bool proxied,
+        endpoint const& src = {},
+        endpoint const& dst = {})
+    {
+        std::string const extra = "GET / HTTP/1.1\r\n";
+        for(std::size_t i = 0; i < s.size(); ++i)
+        {
+            error_code ec;
+            proxy_header h;
+            auto const n = detail::parse_proxy_header(
+                net::const_buffer(s.data(), i), h, ec);
+            if(! BEAST_EXPECTS(! ec && n == 0,
+                std::to_string(i)))
+                return;
+        }
+        // in one buffer, and split in two
+        std::string const full = std::string(s) + extra;
+        for(std::size_t i = 0; i <= full.size(); i += 7)
+        {
+            std::array<net::const_buffer, 2> const bs{{
+                net::const_buffer(full.data(), i),
+                net::const_buffer(full.data() + i, full.size() - i)}};
+            error_code ec;
+            proxy_header h;
+            auto const n = detail::parse_proxy_header(bs, h, ec);
+            BEAST_EXPECTS(! ec, ec.message());
+            BEAST_EXPECT(n == s.size());
+            BEAST_EXPECT(h.version == version);
+            BEAST_EXPECT(h.proxied == proxied);
+            BEAST_EXPECT(h.source == src);
+            BEAST_EXPECT(h.destination == dst);
+        }
+    }
+
+    void
+    bad(string_view s)
+    {
+        error_code ec;
+        proxy_header h;
+        auto const n = detail::parse_proxy_header(
+            net::const_buffer(s.data(), s.size()), h, ec);
+        BEAST_EXPECTS(ec == error::bad_proxy_header,
+            std::string(s));
+        BEAST_EXPECT(n == 0);
+    }
+
+    void
+    testParseV1()
+    {
+        good("PROXY TCP4 192.168.0.1 192.168.0.11 56324 443\r\n", 1, true,
+            ep("192.168.0.1", 56324), ep("192.168.0.11", 443));
+        good("PROXY TCP6 ::1 2001:db8::1 65535 0\r\n", 1, true,
+            ep("::1", 65535), ep("2001:db8::1", 0));
+        good("PROXY UNKNOWN\r\n", 1, false);
+        good("PROXY UNKNOWN ffff:f...f:ffff ffff:f...f:ffff 65535 65535\r\n", 1, false);
+
+        // the longest possible header
+        std::string const longest =
+            "PROXY UNKNOWN " + std::string(91, 'x') + "\r\n";
+        BEAST_EXPECT(longest.size() == 107);
+        good(longest, 1, false);
+        bad("PROXY UNKNOWN " + std::string(92, 'x') + "\r\n");
+
+        bad("GET / HTTP/1.1\r\n");
+        bad("PROXX");
+        bad("PROXY \r\n");
+        bad("PROXY TCP5 1.2.3.4 1.2.3.4 1 2\r\n");
+        bad("PROXY TCP4 1.2.3.4 1.2.3.4 1\r\n");
+        bad("PROXY TCP4 1.2.3.4 1.2.3.4 1 2 \r\n");
+        bad("PROXY TCP4 1.2.3.4  1.2.3.4 1 2\r\n");
+        bad("PROXY TCP4 1.2.3.4 1.2.3.4 1 65536\r\n");
+        bad("PROXY TCP4 1.2.3.4 1.2.3.4 1 01\r\n");
+        bad("PROXY TCP4 1.2.3.4 1.2.3.4 1 2x\r\n");
+        bad("PROXY TCP4 1.2.3.256 1.2.3.4 1 2\r\n");
+        bad("PROXY TCP4 ::1 ::1 1 2\r\n");
+        bad("PROXY TCP6 1.2.3.4 1.2.3.4 1 2\r\n");
+        bad("PROXY TCP4 1.2.3.4 1.2.3.4 1 2\r\r\n");
+        bad("PROXY TCP4 1.2.3.4 1.2.3.4 1 2\n");
+    }
+
+    void
+    testParseV2()
+    {
+        std::string const in4(
+            "\xc0\xa8\x00\x01" "\xc0\xa8\x00\x0b"
+            "\xdc\x04" "\x01\xbb", 12);
+        std::string const in6(
+            "\x20\x01\x0d\xb8\x00\x00\x00\x00"
+            "\x00\x00\x00\x00\x00\x00\x00\x01"
+            "\x00\x00\x00\x00\x00\x00\x00\x00"
+            "\x00\x00\x00\x00\x00\x00\x00\x01"
+            "\xff\xff" "\x00\x50", 36);
+        std::string const tlv("\x04\x00\x03""abc", 6);
+
+        good(v2(0x21, 0x11, in4), 2, true,
+            ep("192.168.0.1", 56324), ep("192.168.0.11", 443));
+        good(v2(0x21, 0x11, in4 + tlv), 2, true,
+            ep("192.168.0.1", 56324), ep("192.168.0.11", 443));
+        good(v2(0x21, 0x21, in6), 2, true,
+            ep("2001:db8::1", 65535), ep("::1", 80));
+
+        // LOCAL
+        good(v2(0x20, 0x00, ""), 2, false);
+        good(v2(0x20, 0x11, in4), 2, false);
+
+        // UDP, UNSPEC and AF_UNIX carry no TCP endpoints
+        good(v2(0x21, 0x12, in4), 2, false);
+        good(v2(0x21, 0x00, tlv), 2, false);
+        good(v2(0x21, 0x31, std::string(216, '\0')), 2, false);
+
+        // a large TLV section is skipped
+        good(v2(0x21, 0x11, in4 + std::string(4000, 'x')), 2, true,
+            ep("192.168.0.1", 56324), ep("192.168.0.11", 443));
+
+        bad(v2(0x11, 0x11, in4));
+        bad(v2(0x22, 0x11, in4));
+        bad(v2(0x21, 0x41, in4));
+        bad(v2(0x21, 0x13, in4));
+        bad(v2(0x21, 0x11, in4.substr(0, 11)));
+        bad(v2(0x21, 0x21, in4));
+        bad(v2(0x21, 0x31, in6));
+        bad(std::string(
+            "\x0D\x0A\x0D\x0A\x00\x0D\x0A\x51\x55\x49\x54\x0B", 12));
+        bad("\r\nGET");
+    }
+
+    void
+    testRead()
+    {
+        net::io_context ioc;
+        std::string const hdr =
+            "PROXY TCP4 192.168.0.1 192.168.0.11 56324 443\r\n";
+
+        // trailing data is left in the buffer
+        {
+            error_code ec;
+            flat_buffer b;
+            proxy_header h;
+            test::stream s1(ioc);
+            s1.append(hdr + "GET / HTTP/1.1\r\n");
+            auto const n = read_proxy_header(s1, b, h, ec);
+            BEAST_EXPECTS(! ec, ec.message());
+            BEAST_EXPECT(n == hdr.size());
+            BEAST_EXPECT(h.proxied);
+            BEAST_EXPECT(h.source == ep("192.168.0.1", 56324));
+            BEAST_EXPECT(buffers_to_string(b.data()) ==
+                "GET / HTTP/1.1\r\n");
+        }
+
+        // one byte at a time, into a multi_buffer
+        {
+            error_code ec;
+            multi_buffer b(64);
+            proxy_header h;
+            test::stream s1(ioc);
+            s1.read_size(1);
+            s1.append(v2(0x21, 0x11, std::string(
+                "\x01\x02\x03\x04" "\x05\x06\x07\x08"
+                "\x00\x01" "\x00\x02", 12)));
+            auto const n = read_proxy_header(s1, b, h, ec);
+            BEAST_EXPECTS(! ec, ec.message());
+            BEAST_EXPECT(n == 28);
+            BEAST_EXPECT(h.version == 2);
+            BEAST_EXPECT(h.destination == ep("5.6.7.8", 2));
+            BEAST_EXPECT(b.size() == 0);
+        }
+
+        // invalid
+        {
+            error_code ec;
+            flat_buffer b;
+            proxy_header h;
+            test::stream s1(ioc);
+            s1.append("GET / HTTP/1.1\r\n");
+            BEAST_EXPECT(read_proxy_header(s1, b, h, ec) == 0);
+            BEAST_EXPECTS(ec == error::bad_proxy_header, ec.message());
+        }
+
+        // buffer too small
+        {
+            error_code ec;
+            flat_static_buffer<16> b;
+            proxy_header h;
+            test::stream s1(ioc);
+            s1.append(hdr);
+            BEAST_EXPECT(read_proxy_header(s1, b, h, ec) == 0);
+            BEAST_EXPECTS(ec == net::error::no_buffer_space,
+                ec.message());
+        }
+
+        // eof
+        {
+            error_code ec;
+            flat_buffer b;
+            proxy_header h;
+            test::stream s1(ioc);
+            auto s2 = test::connect(s1);
+            s1.append("PROXY TCP4");
+            s2.close();
+            BEAST_EXPECT(read_proxy_header(s1, b, h, ec) == 0);
+            BEAST_EXPECTS(ec == net::error::eof, ec.message());
+        }
+    }
+
+    void
+    testAsyncRead()
+    {
+        net::io_context ioc;
+        std::string const hdr =
+            "PROXY TCP6 ::1 ::2 1 2\r\n";
+
+        // already in the buffer
+        {
+            flat_buffer b;
+            proxy_header h;
+            test::stream s1(ioc);
+            b.commit(net::buffer_copy(
+                b.prepare(hdr.size()), net::buffer(hdr)));
+            async_read_proxy_header(s1, b, h,
+                [&](error_code ec, std::size_t n)
+                {
+                    BEAST_EXPECTS(! ec, ec.message());
+                    BEAST_EXPECT(n == hdr.size());
+                });
+            test::run(ioc);
+            BEAST_EXPECT(h.proxied);
+            BEAST_EXPECT(h.destination == ep("::2", 2));
+            BEAST_EXPECT(b.size() == 0);
+        }
+
+        // split across reads
+        {
+            flat_buffer b;
+            proxy_header h;
+            test::stream s1(ioc);
+            s1.read_size(5);
+            s1.append(hdr + "abc");
+            async_read_proxy_header(s1, b, h,
+                test::success_handler());
+            test::run(ioc);
+            BEAST_EXPECT(h.source == ep("::1", 1));
+            BEAST_EXPECT(buffers_to_string(b.data()) == "a");
+        }
+
+        // invalid
+        {
+            flat_buffer b;
+            proxy_header h;
+            test::stream s1(ioc);
+            s1.append("PROXY TCP4 ::1 ::2 1 2\r\n");
+            async_read_proxy_header(s1, b, h,
+                test::fail_handler(error::bad_proxy_header));
+            test::run(ioc);
+        }
+
+        // buffer too small
+        {
+            flat_static_buffer<8> b;
+            proxy_header h;
+            test::stream s1(ioc);
+            s1.append(hdr);
+            async_read_proxy_header(s1, b, h,
+                test::fail_handler(net::error::no_buffer_space));
+            test::run(ioc);
+        }
+
+        // eof
+        {
+            flat_buffer b;
+            proxy_header h;
+            test::stream s1(ioc);
+            auto s2 = test::connect(s1);
+            s1.append("PROXY");
+            s2.close();
+            async_read_proxy_header(s1, b, h,
+                test::fail_handler(net::error::eof));
+            test::run(ioc);
+        }
+    }
+
+    void
+    run() override
+    {
+        testParseV1();
+        testParseV2();
+        testRead();
+        testAsyncRead();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(beast,core,proxy_protocol);
+
+} // beast
+} // boost
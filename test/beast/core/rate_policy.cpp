@@ -41,13 +41,53 @@ namespace beast {
 class rate_policy_test : public unit_test::suite
 {
 public:
+    void
+    testSharedRatePolicy()
+    {
+        using bucket = shared_rate_policy::bucket;
+
+        {
+            shared_rate_policy p;
+            BEAST_EXPECT(! p.read_bucket());
+            BEAST_EXPECT(! p.write_bucket());
+        }
+
+        auto root = std::make_shared<bucket>(1000);
+        auto b = std::make_shared<bucket>(4000, 8000, root);
+        BEAST_EXPECT(b->rate() == 4000);
+        BEAST_EXPECT(b->parent() == root);
+        BEAST_EXPECT(b->users() == 0);
+        b->rate(2000);
+        BEAST_EXPECT(b->rate() == 2000);
+        {
+            shared_rate_policy p1(nullptr, b);
+            BEAST_EXPECT(p1.write_bucket() == b);
+            BEAST_EXPECT(b->users() == 1);
+            BEAST_EXPECT(root->users() == 1);
+            {
+                auto p2 = p1;
+                BEAST_EXPECT(b->users() == 2);
+                auto p3 = std::move(p2);
+                BEAST_EXPECT(b->users() == 2);
+                p2 = p3;
+                BEAST_EXPECT(b->users() == 3);
+                p2 = shared_rate_policy(b, b);
+                BEAST_EXPECT(b->users() == 4);
+                BEAST_EXPECT(root->users() == 4);
+            }
+            BEAST_EXPECT(b->users() == 1);
+        }
+        BEAST_EXPECT(b->users() == 0);
+        BEAST_EXPECT(root->users() == 0);
+    }
+
     void
     run() override
     {
         boost::ignore_unused(unlimited_rate_policy{});
         boost::ignore_unused(simple_rate_policy{});
 
-        pass();
+        testSharedRatePolicy();
     }
 };
 
@@ -0,0 +1,207 @@
+//
+// Copyright (c) 2016-2019 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/boostorg/beast
+//
+
+// Test that header file is self-contained.
+#include <boost/beast/core/timeout_service.hpp>
+
+#include <boost/beast/_experimental/unit_test/suite.hpp>
+#include <boost/asio/io_context.hpp>
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace boost {
+namespace beast {
+
+class timeout_service_test : public beast::unit_test::suite
+{
+public:
+    struct counted : timeout_service::entry
+    {
+        int n = 0;
+
+        counted()
+            : timeout_service::entry(
+                [](timeout_service::entry& e)
+                {
+                    ++static_cast<counted&>(e).n;
+                })
+        {
+        }
+    };
+
+    using clock_type = timeout_service::clock_type;
+
+    void
+    testExpire()
+    {
+        net::io_context ioc;
+        auto& svc = net::use_service<timeout_service>(ioc);
+        BEAST_EXPECT(&svc == &net::use_service<timeout_service>(ioc));
+        svc.resolution(std::chrono::milliseconds(10));
+        BEAST_EXPECT(svc.resolution() == std::chrono::milliseconds(10));
+        BEAST_EXPECT(svc.size() == 0);
+
+        counted e1, e2, e3;
+        auto const start = clock_type::now();
+        svc.arm(e1, start + std::chrono::milliseconds(30));
+        svc.arm(e2, start);
+        svc.arm(e3, start + std::chrono::hours(1));
+        BEAST_EXPECT(svc.size() == 3);
+        BEAST_EXPECT(svc.disarm(e3));
+        BEAST_EXPECT(! svc.disarm(e3));
+        BEAST_EXPECT(svc.size() == 2);
+
+        // the timer stops once nothing is armed
+        ioc.run();
+        BEAST_EXPECT(clock_type::now() - start >=
+            std::chrono::milliseconds(30));
+        BEAST_EXPECT(e1.n == 1);
+        BEAST_EXPECT(e2.n == 1);
+        BEAST_EXPECT(e3.n == 0);
+        BEAST_EXPECT(svc.size() == 0);
+        BEAST_EXPECT(! svc.disarm(e1));
+
+        // re-arm after the timer stopped
+        ioc.restart();
+        svc.arm(e1, clock_type::now());
+        ioc.run();
+        BEAST_EXPECT(e1.n == 2);
+    }
+
+    void
+    testMany()
+    {
+        net::io_context ioc;
+        auto& svc = net::use_service<timeout_service>(ioc);
+        svc.resolution(std::chrono::milliseconds(1));
+
+        // more entries than slots, with
+        // deadlines spread over several rounds
+        std::vector<counted> v(2000);
+        auto const start = clock_type::now();
+        for(std::size_t i = 0; i < v.size(); ++i)
+            svc.arm(v[i], start + std::chrono::milliseconds(i % 700));
+        for(std::size_t i = 0; i < v.size(); i += 2)
+            BEAST_EXPECT(svc.disarm(v[i]));
+        ioc.run();
+        std::size_t fired = 0;
+        for(std::size_t i = 0; i < v.size(); ++i)
+        {
+            BEAST_EXPECT(v[i].n == (i % 2 ? 1 : 0));
+            fired += v[i].n;
+        }
+        BEAST_EXPECT(fired == v.size() / 2);
+    }
+
+    void
+    testDestroy()
+    {
+        net::io_context ioc;
+        auto& svc = net::use_service<timeout_service>(ioc);
+        {
+            counted e;
+            svc.arm(e, clock_type::now() + std::chrono::hours(1));
+            BEAST_EXPECT(svc.size() == 1);
+        }
+        BEAST_EXPECT(svc.size() == 0);
+
+        // shutdown with entries armed
+        counted e;
+        {
+            net::io_context ioc2;
+            net::use_service<timeout_service>(ioc2).arm(
+                e, clock_type::now() + std::chrono::hours(1));
+        }
+        BEAST_EXPECT(e.n == 0);
+    }
+
+    // An entry whose callback signals when it starts and
+    // stalls until the destructor of the entry has begun.
+    struct stalled : timeout_service::entry
+    {
+        std::atomic<bool>& started;
+        std::atomic<bool>& destroying;
+        std::atomic<bool>& finished;
+
+        stalled(
+            std::atomic<bool>& started_,
+            std::atomic<bool>& destroying_,
+            std::atomic<bool>& finished_)
+            : timeout_service::entry(&on_expire)
+            , started(started_)
+            , destroying(destroying_)
+            , finished(finished_)
+        {
+        }
+
+        ~stalled()
+        {
+            destroying = true;
+        }
+
+        static
+        void
+        on_expire(timeout_service::entry& e)
+        {
+            auto& s = static_cast<stalled&>(e);
+            auto& destroying = s.destroying;
+            auto& finished = s.finished;
+            s.started = true;
+            auto const until = clock_type::now() +
+                std::chrono::seconds(5);
+            while(! destroying && clock_type::now() < until)
+                std::this_thread::yield();
+            std::this_thread::sleep_for(
+                std::chrono::milliseconds(20));
+            finished = true;
+        }
+    };
+
+    void
+    testDestroyWhileFiring()
+    {
+        // The destructor waits for a running callback
+        net::io_context ioc;
+        auto& svc = net::use_service<timeout_service>(ioc);
+        svc.resolution(std::chrono::milliseconds(1));
+        std::atomic<bool> started{false};
+        std::atomic<bool> destroying{false};
+        std::atomic<bool> finished{false};
+        std::unique_ptr<stalled> e(
+            new stalled(started, destroying, finished));
+        svc.arm(*e, clock_type::now());
+        std::thread t(
+            [&]
+            {
+                ioc.run();
+            });
+        while(! started)
+            std::this_thread::yield();
+        e.reset();
+        BEAST_EXPECT(finished);
+        t.join();
+        BEAST_EXPECT(svc.size() == 0);
+    }
+
+    void
+    run() override
+    {
+        testExpire();
+        testMany();
+        testDestroy();
+        testDestroyWhileFiring();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(beast,core,timeout_service);
+
+} // beast
+} // boost
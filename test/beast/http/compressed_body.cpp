@@ -0,0 +1,489 @@
+//
+// Copyright (c) 2016-2019 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/boostorg/beast
+//
+
+// Test that header file is self-contained.
+#include <boost/beast/http/compressed_body.hpp>
+
+#include <boost/beast/core/buffer_traits.hpp>
+#include <boost/beast/http/buffer_body.hpp>
+#include <boost/beast/http/read.hpp>
+#include <boost/beast/http/string_body.hpp>
+#include <boost/beast/http/write.hpp>
+#include <boost/beast/zlib/inflate_stream.hpp>
+#include <boost/beast/_experimental/test/stream.hpp>
+#include <boost/beast/_experimental/unit_test/suite.hpp>
+#include <boost/asio/io_context.hpp>
+#include <string>
+
+namespace boost {
+namespace beast {
+namespace http {
+
+BOOST_STATIC_ASSERT(is_body<compressed_body<string_body>>::value);
+BOOST_STATIC_ASSERT(is_body_writer<compressed_body<string_body>>::value);
+BOOST_STATIC_ASSERT(is_body_reader<compressed_body<string_body>>::value);
+
+class compressed_body_test
+    : public beast::unit_test::suite
+{
+    net::io_context ioc_;
+
+public:
+    static
+    std::string
+    make_text(std::size_t n)
+    {
+        std::string s;
+        s.reserve(n);
+        std::uint32_t v = 1;
+        while(s.size() < n)
+        {
+            v = v * 1103515245 + 12345;
+            s.append("{\"id\":");
+            s.append(std::to_string(v % 1000));
+            s.append(",\"ok\":true},");
+        }
+        s.resize(n);
+        return s;
+    }
+
+    static
+    std::uint32_t
+    get_le(string_view s, std::size_t pos)
+    {
+        std::uint32_t v = 0;
+        for(int i = 3; i >= 0; --i)
+            v = (v << 8) | static_cast<unsigned char>(s[pos + i]);
+        return v;
+    }
+
+    static
+    std::uint32_t
+    get_be(string_view s, std::size_t pos)
+    {
+        std::uint32_t v = 0;
+        for(int i = 0; i < 4; ++i)
+            v = (v << 8) | static_cast<unsigned char>(s[pos + i]);
+        return v;
+    }
+
+    std::string
+    inflate(string_view in)
+    {
+        zlib::inflate_stream zi;
+        std::string out;
+        out.resize(in.size() * 10 + 1024);
+        zlib::z_params zs;
+        zs.next_in = in.data();
+        zs.avail_in = in.size();
+        zs.next_out = &out[0];
+        zs.avail_out = out.size();
+        error_code ec;
+        zi.write(zs, zlib::Flush::finish, ec);
+        BEAST_EXPECTS(ec == zlib::error::end_of_stream, ec.message());
+        out.resize(zs.total_out);
+        return out;
+    }
+
+    template<class Body>
+    std::string
+    serialize(response<Body> const& res)
+    {
+        test::stream ts{ioc_}, tr{ioc_};
+        ts.connect(tr);
+        error_code ec;
+        write(ts, res, ec);
+        BEAST_EXPECTS(! ec, ec.message());
+        return std::string(tr.str());
+    }
+
+    std::string
+    get_body(std::string const& wire)
+    {
+        response_parser<string_body> p;
+        p.eager(true);
+        p.body_limit(boost::none);
+        error_code ec;
+        p.put(net::buffer(wire), ec);
+        BEAST_EXPECTS(! ec, ec.message());
+        BEAST_EXPECT(p.is_done());
+        return p.get().body();
+    }
+
+    void
+    testGzip(std::size_t size)
+    {
+        auto const text = make_text(size);
+        response<compressed_body<string_body>> res{status::ok, 11};
+        res.set(field::content_encoding, "gzip");
+        res.body().content = text;
+        res.prepare_payload();
+        BEAST_EXPECT(res.chunked());
+
+        auto const body = get_body(serialize(res));
+        if(! BEAST_EXPECT(body.size() >= 18))
+            return;
+        BEAST_EXPECT(static_cast<unsigned char>(body[0]) == 0x1f);
+        BEAST_EXPECT(static_cast<unsigned char>(body[1]) == 0x8b);
+        BEAST_EXPECT(body[2] == 8);
+        auto const out = inflate(string_view(
+            body.data() + 10, body.size() - 18));
+        BEAST_EXPECT(out == text);
+        BEAST_EXPECT(get_le(body, body.size() - 8) ==
+            zlib::detail::crc32(0, text.data(), text.size()));
+        BEAST_EXPECT(get_le(body, body.size() - 4) ==
+            static_cast<std::uint32_t>(text.size()));
+        if(size > 1000)
+            BEAST_EXPECT(body.size() < text.size());
+    }
+
+    void
+    testDeflate()
+    {
+        auto const text = make_text(100000);
+        response<compressed_body<string_body>> res{status::ok, 11};
+        res.body().coding = content_coding::deflate;
+        res.body().level = 1;
+        res.body().content = text;
+        res.prepare_payload();
+
+        auto const body = get_body(serialize(res));
+        if(! BEAST_EXPECT(body.size() >= 6))
+            return;
+        BEAST_EXPECT(((static_cast<unsigned char>(body[0]) << 8) |
+            static_cast<unsigned char>(body[1])) % 31 == 0);
+        auto const out = inflate(string_view(
+            body.data() + 2, body.size() - 6));
+        BEAST_EXPECT(out == text);
+        BEAST_EXPECT(get_be(body, body.size() - 4) ==
+            zlib::detail::adler32(1, text.data(), text.size()));
+    }
+
+    void
+    testIdentity()
+    {
+        response<compressed_body<string_body>> res{status::ok, 11};
+        res.body().coding = content_coding::identity;
+        res.body().content = "Hello, world!";
+        res.prepare_payload();
+        BEAST_EXPECT(serialize(res) ==
+            "HTTP/1.1 200 OK\r\n"
+            "Transfer-Encoding: chunked\r\n"
+            "\r\n"
+            "d\r\n"
+            "Hello, world!"
+            "\r\n"
+            "0\r\n\r\n");
+    }
+
+    void
+    testBufferBody()
+    {
+        // The inner writer may ask for more buffers
+        auto text = make_text(5000);
+        response<compressed_body<buffer_body>> res{status::ok, 11};
+        res.chunked(true);
+        res.body().content.data = nullptr;
+        res.body().content.more = true;
+
+        test::stream ts{ioc_}, tr{ioc_};
+        ts.connect(tr);
+        response_serializer<compressed_body<buffer_body>> sr{res};
+        error_code ec;
+        write_header(ts, sr, ec);
+        BEAST_EXPECTS(! ec, ec.message());
+        std::size_t pos = 0;
+        while(pos < text.size())
+        {
+            auto const n = (std::min)(
+                std::size_t{777}, text.size() - pos);
+            res.body().content.data = &text[pos];
+            res.body().content.size = n;
+            pos += n;
+            write(ts, sr, ec);
+            if(ec == error::need_buffer)
+                ec = {};
+            BEAST_EXPECTS(! ec, ec.message());
+        }
+        res.body().content.data = nullptr;
+        res.body().content.more = false;
+        write(ts, sr, ec);
+        BEAST_EXPECTS(! ec, ec.message());
+        BEAST_EXPECT(sr.is_done());
+
+        auto const body = get_body(std::string(tr.str()));
+        if(! BEAST_EXPECT(body.size() >= 18))
+            return;
+        BEAST_EXPECT(inflate(string_view(
+            body.data() + 10, body.size() - 18)) == text);
+    }
+
+    std::string
+    encode(std::string const& text, content_coding coding)
+    {
+        response<compressed_body<string_body>> res{status::ok, 11};
+        res.body().coding = coding;
+        res.body().content = text;
+        res.prepare_payload();
+        return get_body(serialize(res));
+    }
+
+    // Parse a request with the given encoded body, delivering
+    // the input to the parser in pieces of at most `step` octets.
+    template<class Check>
+    void
+    parse(
+        string_view coding,
+        string_view body,
+        std::size_t step,
+        Check const& check,
+        boost::optional<std::uint64_t> limit = boost::none)
+    {
+        std::string wire =
+            "POST / HTTP/1.1\r\n"
+            "Content-Length: " + std::to_string(body.size()) + "\r\n";
+        if(! coding.empty())
+            wire += "Content-Encoding: " + std::string(coding) + "\r\n";
+        wire += "\r\n";
+        wire.append(body.data(), body.size());
+
+        request_parser<compressed_body<string_body>> p;
+        p.eager(true);
+        p.body_limit(boost::none);
+        if(limit)
+            p.get().body().body_limit = limit;
+        error_code ec;
+        std::size_t pos = 0;
+        std::size_t end = 0;
+        while(! p.is_done())
+        {
+            end = (std::min)(end + step, wire.size());
+            pos += p.put(net::buffer(
+                wire.data() + pos, end - pos), ec);
+            if(ec == error::need_more && end < wire.size())
+            {
+                ec = {};
+                continue;
+            }
+            if(ec)
+                break;
+        }
+        check(p, ec);
+    }
+
+    void
+    testRead()
+    {
+        using parser_type =
+            request_parser<compressed_body<string_body>>;
+        auto const text = make_text(100000);
+        auto const expect =
+            [&](string_view s)
+            {
+                return [this, s](parser_type& p, error_code ec)
+                {
+                    BEAST_EXPECTS(! ec, ec.message());
+                    BEAST_EXPECT(p.get().body().content == s);
+                };
+            };
+        auto const fail =
+            [&](error_code e)
+            {
+                return [this, e](parser_type&, error_code ec)
+                {
+                    BEAST_EXPECTS(ec == e, ec.message());
+                };
+            };
+
+        auto const gz = encode(text, content_coding::gzip);
+        auto const df = encode(text, content_coding::deflate);
+
+        // gzip and deflate, in various pieces
+        for(std::size_t step : {std::size_t{1}, std::size_t{7},
+            std::size_t{4096}, gz.size() + 1024})
+        {
+            parse("gzip", gz, step, expect(text));
+            parse("deflate", df, step, expect(text));
+        }
+        parse("x-gzip", gz, 1024,
+            [&](parser_type& p, error_code ec)
+            {
+                BEAST_EXPECTS(! ec, ec.message());
+                BEAST_EXPECT(p.get().body().coding ==
+                    content_coding::gzip);
+            });
+
+        // identity
+        parse("", "Hello", 1,
+            [&](parser_type& p, error_code ec)
+            {
+                BEAST_EXPECTS(! ec, ec.message());
+                BEAST_EXPECT(p.get().body().content == "Hello");
+                BEAST_EXPECT(p.get().body().coding ==
+                    content_coding::identity);
+            });
+        parse("identity", "Hello", 1, expect("Hello"));
+
+        // raw deflate sent as "deflate"
+        auto const raw = df.substr(2, df.size() - 6);
+        parse("deflate", raw, 3, expect(text));
+
+        // gzip header with optional fields
+        {
+            std::string s;
+            s += "\x1f\x8b\x08";
+            s.push_back(0x1e); // FHCRC FEXTRA FNAME FCOMMENT
+            s.append(6, '\0');
+            s += "\x03";
+            s.push_back(0);
+            s += "xyz";
+            s += "name";
+            s.push_back(0);
+            s += "comment";
+            s.push_back(0);
+            s += "\xab\xcd";
+            s.append(gz.substr(10));
+            parse("gzip", s, 1, expect(text));
+        }
+
+        // limits
+        {
+            std::string zeros(1024 * 1024, '\0');
+            auto const bomb = encode(zeros, content_coding::gzip);
+            BEAST_EXPECT(bomb.size() < 2048);
+            parse("gzip", bomb, bomb.size(),
+                fail(error::body_limit), std::uint64_t{65536});
+            parse("gzip", bomb, bomb.size(),
+                expect(zeros), std::uint64_t{1024 * 1024});
+            parse("gzip", bomb, 1, expect(zeros));
+        }
+
+        // errors
+        {
+            auto bad = gz;
+            bad[bad.size() - 6] ^= 1;
+            parse("gzip", bad, 1024,
+                fail(error::bad_content_encoding));
+            parse("gzip", gz.substr(0, gz.size() - 4), 1024,
+                fail(error::partial_message));
+            parse("gzip", gz + "x", 1024,
+                fail(error::bad_content_encoding));
+            parse("gzip", "this is not gzip", 1024,
+                fail(error::bad_content_encoding));
+            parse("br", gz, 1024,
+                fail(error::bad_content_encoding));
+            bad = df;
+            bad[bad.size() - 1] ^= 1;
+            parse("deflate", bad, 1024,
+                fail(error::bad_content_encoding));
+        }
+    }
+
+    // A body which stops accepting octets without an error
+    // once it holds `capacity` of them.
+    struct capped_body
+    {
+        static std::size_t constexpr capacity = 1000;
+
+        using value_type = std::string;
+
+        class reader
+        {
+            value_type& s_;
+
+        public:
+            template<bool isRequest, class Fields>
+            reader(header<isRequest, Fields>&, value_type& s)
+                : s_(s)
+            {
+            }
+
+            void
+            init(boost::optional<std::uint64_t> const&,
+                error_code& ec)
+            {
+                ec = {};
+            }
+
+            template<class ConstBufferSequence>
+            std::size_t
+            put(ConstBufferSequence const& buffers,
+                error_code& ec)
+            {
+                ec = {};
+                auto const n = (std::min)(
+                    buffer_bytes(buffers), capacity - s_.size());
+                auto const size = s_.size();
+                s_.resize(size + n);
+                return net::buffer_copy(
+                    net::buffer(&s_[size], n), buffers);
+            }
+
+            void
+            finish(error_code& ec)
+            {
+                ec = {};
+            }
+        };
+    };
+
+    void
+    testCappedBody()
+    {
+        // The wrapped reader making no progress is an error
+        auto const gz = encode(
+            make_text(100000), content_coding::gzip);
+        std::string wire =
+            "POST / HTTP/1.1\r\n"
+            "Content-Encoding: gzip\r\n"
+            "Content-Length: " + std::to_string(gz.size()) + "\r\n"
+            "\r\n" + gz;
+        request_parser<compressed_body<capped_body>> p;
+        p.eager(true);
+        p.body_limit(boost::none);
+        error_code ec;
+        p.put(net::buffer(wire), ec);
+        BEAST_EXPECTS(ec == error::need_buffer, ec.message());
+        BEAST_EXPECT(p.get().body().content.size() ==
+            capped_body::capacity);
+    }
+
+    void
+    testChecksum()
+    {
+        string_view s = "123456789";
+        BEAST_EXPECT(zlib::detail::crc32(
+            0, s.data(), s.size()) == 0xcbf43926);
+        BEAST_EXPECT(zlib::detail::crc32(zlib::detail::crc32(
+            0, s.data(), 4), s.data() + 4, 5) == 0xcbf43926);
+        string_view w = "Wikipedia";
+        BEAST_EXPECT(zlib::detail::adler32(
+            1, w.data(), w.size()) == 0x11e60398);
+    }
+
+    void
+    run() override
+    {
+        testChecksum();
+        testGzip(0);
+        testGzip(10);
+        testGzip(200000);
+        testDeflate();
+        testIdentity();
+        testBufferBody();
+        testRead();
+        testCappedBody();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(beast,http,compressed_body);
+
+} // http
+} // beast
+} // boost
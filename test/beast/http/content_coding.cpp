@@ -0,0 +1,79 @@
+//
+// Copyright (c) 2016-2019 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/boostorg/beast
+//
+
+// Test that header file is self-contained.
+#include <boost/beast/http/content_coding.hpp>
+
+#include <boost/beast/_experimental/unit_test/suite.hpp>
+
+namespace boost {
+namespace beast {
+namespace http {
+
+class content_coding_test
+    : public beast::unit_test::suite
+{
+public:
+    void
+    testStrings()
+    {
+        auto const good =
+            [&](content_coding c)
+            {
+                BEAST_EXPECT(string_to_content_coding(to_string(c)) == c);
+            };
+        good(content_coding::identity);
+        good(content_coding::deflate);
+        good(content_coding::gzip);
+
+        BEAST_EXPECT(string_to_content_coding("GZip") == content_coding::gzip);
+        BEAST_EXPECT(string_to_content_coding("x-gzip") == content_coding::gzip);
+        BEAST_EXPECT(string_to_content_coding("br") == content_coding::unknown);
+        BEAST_EXPECT(string_to_content_coding("") == content_coding::unknown);
+    }
+
+    void
+    testNegotiate()
+    {
+        auto const check =
+            [&](string_view s, content_coding c)
+            {
+                BEAST_EXPECTS(negotiate_content_coding(s) == c, s);
+            };
+        check("", content_coding::identity);
+        check("gzip", content_coding::gzip);
+        check("deflate", content_coding::deflate);
+        check("deflate, gzip", content_coding::gzip);
+        check("gzip, deflate, br", content_coding::gzip);
+        check("br", content_coding::identity);
+        check("*", content_coding::gzip);
+        check("gzip;q=0.5, deflate", content_coding::deflate);
+        check("gzip;q=0, deflate;q=0", content_coding::identity);
+        check("*;q=0.1, gzip;q=0", content_coding::deflate);
+        check("gzip;q=0.5, identity", content_coding::identity);
+        check("gzip;q=1.0, identity;q=0.5", content_coding::gzip);
+        check("gzip;q=1.5", content_coding::identity);
+        check("gzip;q=x", content_coding::identity);
+        check("gzip ; q=0.001", content_coding::gzip);
+        check("x-gzip", content_coding::gzip);
+    }
+
+    void
+    run() override
+    {
+        testStrings();
+        testNegotiate();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(beast,http,content_coding);
+
+} // http
+} // beast
+} // boost
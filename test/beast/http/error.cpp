@@ -68,6 +68,7 @@ public:
 
         check("beast.http", error::stale_parser);
         check("beast.http", error::short_read);
+        check("beast.http", error::bad_content_encoding);
     }
 };
 
@@ -13,12 +13,15 @@
 #include "test_parser.hpp"
 
 #include <boost/beast/core/ostream.hpp>
+#include <boost/beast/core/pooled_allocator.hpp>
+#include <boost/beast/core/tcp_stream.hpp>
 #include <boost/beast/core/flat_static_buffer.hpp>
 #include <boost/beast/http/fields.hpp>
 #include <boost/beast/http/dynamic_body.hpp>
 #include <boost/beast/http/parser.hpp>
 #include <boost/beast/http/string_body.hpp>
 #include <boost/beast/_experimental/test/stream.hpp>
+#include <boost/beast/_experimental/test/tcp.hpp>
 #include <boost/beast/_experimental/unit_test/suite.hpp>
 #include <boost/beast/test/yield_to.hpp>
 #include <boost/asio/io_context.hpp>
@@ -711,6 +714,73 @@ public:
     }
 
 
+    void
+    testWaitReadable()
+    {
+        net::io_context ioc;
+        net::ip::tcp::socket s1(ioc);
+        net::ip::tcp::socket s2(ioc);
+        test::connect(s1, s2);
+        string_view const req =
+            "GET / HTTP/1.1\r\n"
+            "Content-Length: 5\r\n"
+            "\r\n"
+            "*****";
+        pooled_flat_buffer b;
+
+        {
+            // no buffer is prepared while waiting
+            request_parser<string_body> p;
+            BEAST_EXPECT(! p.wait_readable());
+            p.wait_readable(true);
+            BEAST_EXPECT(p.wait_readable());
+            bool invoked = false;
+            async_read(s2, b, p,
+                [&](error_code ec, std::size_t n)
+                {
+                    BEAST_EXPECTS(! ec, ec.message());
+                    BEAST_EXPECT(n == req.size());
+                    invoked = true;
+                });
+            ioc.poll();
+            BEAST_EXPECT(! invoked);
+            BEAST_EXPECT(b.capacity() == 0);
+            net::write(s1, net::buffer(req.data(), req.size()));
+            test::run(ioc);
+            BEAST_EXPECT(invoked);
+            BEAST_EXPECT(p.get().body() == "*****");
+            BEAST_EXPECT(b.size() == 0);
+            b.shrink_to_fit();
+            BEAST_EXPECT(b.capacity() == 0);
+        }
+
+        {
+            // synchronous
+            net::write(s1, net::buffer(req.data(), req.size()));
+            request_parser<string_body> p;
+            p.wait_readable(true);
+            error_code ec;
+            read(s2, b, p, ec);
+            BEAST_EXPECTS(! ec, ec.message());
+            BEAST_EXPECT(p.get().body() == "*****");
+        }
+
+        {
+            // the timeout of the stream applies to the wait
+            tcp_stream ts(std::move(s2));
+            ts.expires_after(std::chrono::milliseconds(20));
+            request_parser<string_body> p;
+            p.wait_readable(true);
+            async_read_header(ts, b, p,
+                [&](error_code ec, std::size_t)
+                {
+                    BEAST_EXPECTS(ec == beast::error::timeout,
+                        ec.message());
+                });
+            test::run(ioc);
+        }
+    }
+
     void
     run() override
     {
@@ -734,6 +804,7 @@ public:
         testRegression430();
         testReadGrind();
         testAsioHandlerInvoke();
+        testWaitReadable();
 #if BOOST_ASIO_HAS_CO_AWAIT
         boost::ignore_unused(&read_test::testAwaitableCompiles);
 #endif
@@ -170,6 +170,7 @@ public:
         cs("a; \t i\t=\t \t1\t ", "a;i=1");
         ce("a;i=1;j=2;k=3");
         ce("a;i=1;j=2;k=3,b;i=4;j=5;k=6");
+        ce("a;i=1,b");
 
         cq("ab;x=\" \"", "ab;x= ");
         cq("ab;x=\"\\\"\"", "ab;x=\"");
@@ -0,0 +1,139 @@
+//
+// Copyright (c) 2016-2019 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/boostorg/beast
+//
+
+// Test that header file is self-contained.
+#include <boost/beast/http/rope_body.hpp>
+
+#include <boost/beast/core/buffer_traits.hpp>
+#include <boost/beast/core/buffers_to_string.hpp>
+#include <boost/beast/http/parser.hpp>
+#include <boost/beast/http/write.hpp>
+#include <boost/beast/_experimental/test/stream.hpp>
+#include <boost/beast/_experimental/unit_test/suite.hpp>
+#include <boost/asio/io_context.hpp>
+#include <iterator>
+
+namespace boost {
+namespace beast {
+namespace http {
+
+BOOST_STATIC_ASSERT(is_body<rope_body>::value);
+BOOST_STATIC_ASSERT(is_body_writer<rope_body>::value);
+BOOST_STATIC_ASSERT(is_body_reader<rope_body>::value);
+BOOST_STATIC_ASSERT(net::is_const_buffer_sequence<
+    rope_body::value_type::const_buffers_type>::value);
+
+struct rope_body_test
+    : public beast::unit_test::suite
+{
+    void
+    testValue()
+    {
+        rope_body::value_type v;
+        BEAST_EXPECT(v.empty());
+        BEAST_EXPECT(v.segments() == 0);
+
+        auto const frag = std::make_shared<
+            std::string const>("<p>cached</p>");
+        v.append(net::buffer("<html>", 6));
+        v.append(frag, net::buffer(*frag));
+        v.append(net::const_buffer{});
+        v.append(std::string("</html>"));
+        BEAST_EXPECT(v.segments() == 3);
+        BEAST_EXPECT(v.size() == 26);
+        BEAST_EXPECT(frag.use_count() == 2);
+        BEAST_EXPECT(buffers_to_string(v.buffers()) ==
+            "<html><p>cached</p></html>");
+        BEAST_EXPECT(std::next(
+            v.buffers().begin())->data() == frag->data());
+
+        shared_body::value_type const sb(std::string("!"));
+        v.append(sb);
+        BEAST_EXPECT(v.segments() == 4);
+        BEAST_EXPECT(sb.owner().use_count() == 2);
+
+        v.clear();
+        BEAST_EXPECT(v.empty());
+        BEAST_EXPECT(frag.use_count() == 1);
+        BEAST_EXPECT(sb.owner().use_count() == 1);
+    }
+
+    void
+    testWrite()
+    {
+        net::io_context ioc;
+        response<rope_body> res{status::ok, 11};
+        res.body().append(net::buffer("Hello", 5));
+        res.body().append(std::string(", "));
+        res.body().append(net::buffer("world!", 6));
+        res.prepare_payload();
+        {
+            test::stream ts{ioc}, tr{ioc};
+            ts.connect(tr);
+            error_code ec;
+            write(ts, res, ec);
+            BEAST_EXPECTS(! ec, ec.message());
+            BEAST_EXPECT(tr.str() ==
+                "HTTP/1.1 200 OK\r\n"
+                "Content-Length: 13\r\n"
+                "\r\n"
+                "Hello, world!");
+        }
+        res.chunked(true);
+        {
+            test::stream ts{ioc}, tr{ioc};
+            ts.connect(tr);
+            error_code ec;
+            write(ts, res, ec);
+            BEAST_EXPECTS(! ec, ec.message());
+            BEAST_EXPECT(tr.str() ==
+                "HTTP/1.1 200 OK\r\n"
+                "Transfer-Encoding: chunked\r\n"
+                "\r\n"
+                "d\r\n"
+                "Hello, world!"
+                "\r\n"
+                "0\r\n\r\n");
+        }
+    }
+
+    void
+    testReader()
+    {
+        string_view s =
+            "HTTP/1.1 200 OK\r\n"
+            "Content-Length: 5\r\n"
+            "\r\n"
+            "*****";
+        response_parser<rope_body> p;
+        p.eager(true);
+        error_code ec;
+        p.put(net::buffer(s.data(), s.size()), ec);
+        BEAST_EXPECTS(! ec, ec.message());
+        if(! BEAST_EXPECT(p.is_done()))
+            return;
+        BEAST_EXPECT(p.get().body().segments() == 1);
+        BEAST_EXPECT(buffers_to_string(
+            p.get().body().buffers()) == "*****");
+    }
+
+    void
+    run() override
+    {
+        testValue();
+        testWrite();
+        testReader();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(beast,http,rope_body);
+
+} // http
+} // beast
+} // boost
@@ -0,0 +1,117 @@
+//
+// Copyright (c) 2016-2019 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/boostorg/beast
+//
+
+// Test that header file is self-contained.
+#include <boost/beast/http/shared_body.hpp>
+
+#include <boost/beast/core/buffer_traits.hpp>
+#include <boost/beast/core/buffers_to_string.hpp>
+#include <boost/beast/http/parser.hpp>
+#include <boost/beast/_experimental/unit_test/suite.hpp>
+#include <vector>
+
+namespace boost {
+namespace beast {
+namespace http {
+
+BOOST_STATIC_ASSERT(is_body<shared_body>::value);
+BOOST_STATIC_ASSERT(is_body_writer<shared_body>::value);
+BOOST_STATIC_ASSERT(is_body_reader<shared_body>::value);
+
+struct shared_body_test
+    : public beast::unit_test::suite
+{
+    void
+    testValue()
+    {
+        using B = shared_body;
+        B::value_type v;
+        BEAST_EXPECT(v.empty());
+        BEAST_EXPECT(v.owner() == nullptr);
+
+        v = B::value_type(std::string("Hello, world!"));
+        BEAST_EXPECT(v.size() == 13);
+        BEAST_EXPECT(v.view() == "Hello, world!");
+
+        auto const v2 = v;
+        BEAST_EXPECT(v2.data() == v.data());
+        BEAST_EXPECT(v.owner().use_count() == 2);
+
+        v.clear();
+        BEAST_EXPECT(v.empty());
+        BEAST_EXPECT(v2.view() == "Hello, world!");
+        BEAST_EXPECT(v2.owner().use_count() == 1);
+
+        auto const sp = std::make_shared<
+            std::vector<char>>(5, 'x');
+        B::value_type v3(sp, net::buffer(*sp));
+        BEAST_EXPECT(v3.view() == "xxxxx");
+        BEAST_EXPECT(sp.use_count() == 2);
+    }
+
+    void
+    testWriter()
+    {
+        using B = shared_body;
+        B::value_type const v(
+            std::make_shared<std::string const>("abc"));
+        response<B> res1{status::ok, 11, v};
+        response<B> res2{status::ok, 11, v};
+        BEAST_EXPECT(B::size(res1.body()) == 3);
+
+        B::writer w1{res1, res1.body()};
+        B::writer w2{res2, res2.body()};
+        error_code ec;
+        w1.init(ec);
+        BEAST_EXPECTS(! ec, ec.message());
+        w2.init(ec);
+        BEAST_EXPECTS(! ec, ec.message());
+        auto const b1 = w1.get(ec);
+        BEAST_EXPECTS(! ec, ec.message());
+        auto const b2 = w2.get(ec);
+        BEAST_EXPECTS(! ec, ec.message());
+        if(! BEAST_EXPECT(b1 && b2))
+            return;
+        BEAST_EXPECT(! b1->second);
+        BEAST_EXPECT(b1->first.data() == b2->first.data());
+        BEAST_EXPECT(buffers_to_string(b1->first) == "abc");
+    }
+
+    void
+    testReader()
+    {
+        string_view s =
+            "HTTP/1.1 200 OK\r\n"
+            "Content-Length: 5\r\n"
+            "\r\n"
+            "*****";
+        response_parser<shared_body> p;
+        p.eager(true);
+        error_code ec;
+        p.put(net::buffer(s.data(), s.size()), ec);
+        BEAST_EXPECTS(! ec, ec.message());
+        if(! BEAST_EXPECT(p.is_done()))
+            return;
+        BEAST_EXPECT(p.get().body().view() == "*****");
+    }
+
+    void
+    run() override
+    {
+        testValue();
+        testWriter();
+        testReader();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(beast,http,shared_body);
+
+} // http
+} // beast
+} // boost
@@ -9,3 +9,288 @@
 
 // Test that header file is self-contained.
 #include <boost/beast/ssl/ssl_stream.hpp>
+
+#include <boost/beast/_experimental/unit_test/suite.hpp>
+#include <boost/asio/connect.hpp>
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/ip/tcp.hpp>
+#include <boost/asio/read.hpp>
+#include <boost/asio/write.hpp>
+#include <openssl/evp.h>
+#include "example/common/server_certificate.hpp"
+#include <functional>
+#include <string>
+#include <thread>
+
+namespace boost {
+namespace beast {
+
+class ssl_stream_test : public unit_test::suite
+{
+public:
+    using tcp = net::ip::tcp;
+    using stream_type = ssl_stream<tcp::socket>;
+
+    // A connected pair of streams after a handshake
+    struct pair
+    {
+        net::io_context ioc;
+        net::ssl::context sctx;
+        net::ssl::context cctx;
+        stream_type server;
+        stream_type client;
+
+        explicit
+        pair(net::ssl::context::method m)
+            : sctx(m)
+            , cctx(m)
+            , server(ioc, (load_server_certificate(sctx), sctx))
+            , client(ioc, cctx)
+        {
+        }
+
+        bool
+        handshake(error_code& ec)
+        {
+            tcp::acceptor a(ioc, tcp::endpoint(
+                net::ip::make_address_v4("127.0.0.1"), 0));
+            client.next_layer().connect(a.local_endpoint());
+            a.accept(server.next_layer());
+            error_code ec1;
+            std::thread t(
+                [&]
+                {
+                    server.handshake(
+                        net::ssl::stream_base::server, ec1);
+                });
+            client.handshake(net::ssl::stream_base::client, ec);
+            t.join();
+            if(! ec)
+                ec = ec1;
+            return ! ec;
+        }
+    };
+
+    void
+    roundtrip(pair& p)
+    {
+        std::string const s = "Hello, world!";
+        std::string r(s.size(), 0);
+        error_code ec;
+        net::write(p.server, net::buffer(s), ec);
+        BEAST_EXPECTS(! ec, ec.message());
+        net::read(p.client, net::buffer(&r[0], r.size()), ec);
+        BEAST_EXPECTS(! ec, ec.message());
+        BEAST_EXPECT(r == s);
+        r.assign(s.size(), 0);
+        net::write(p.client, net::buffer(s), ec);
+        BEAST_EXPECTS(! ec, ec.message());
+        net::read(p.server, net::buffer(&r[0], r.size()), ec);
+        BEAST_EXPECTS(! ec, ec.message());
+        BEAST_EXPECT(r == s);
+
+        r.assign(s.size(), 0);
+        net::async_write(p.server, net::buffer(s),
+            [&](error_code ec, std::size_t)
+            {
+                BEAST_EXPECTS(! ec, ec.message());
+            });
+        net::async_read(p.client, net::buffer(&r[0], r.size()),
+            [&](error_code ec, std::size_t)
+            {
+                BEAST_EXPECTS(! ec, ec.message());
+            });
+        p.ioc.run();
+        p.ioc.restart();
+        BEAST_EXPECT(r == s);
+    }
+
+    void
+    testKtlsUnsupported()
+    {
+        // not connected
+        {
+            net::io_context ioc;
+            net::ssl::context ctx(net::ssl::context::tlsv12);
+            stream_type ss(ioc, ctx);
+            error_code ec;
+            ss.enable_ktls(ec);
+            BEAST_EXPECT(ec == net::error::operation_not_supported);
+            BEAST_EXPECT(! ss.ktls());
+        }
+
+        // TLS 1.3 keys are not available
+        {
+            pair p(net::ssl::context::tlsv13);
+            error_code ec;
+            if(! BEAST_EXPECTS(p.handshake(ec), ec.message()))
+                return;
+            p.server.enable_ktls(ec);
+            BEAST_EXPECT(ec == net::error::operation_not_supported);
+            BEAST_EXPECT(! p.server.ktls());
+            roundtrip(p);
+        }
+    }
+
+    void
+    testKtls()
+    {
+        pair p(net::ssl::context::tlsv12);
+        error_code ec;
+        if(! BEAST_EXPECTS(p.handshake(ec), ec.message()))
+            return;
+        p.server.enable_ktls(ec);
+        if(ec)
+        {
+            // Kernel without the tls module, the
+            // stream keeps working through OpenSSL.
+            BEAST_EXPECT(! p.server.ktls());
+            roundtrip(p);
+            return;
+        }
+        BEAST_EXPECT(p.server.ktls());
+        p.client.enable_ktls(ec);
+        BEAST_EXPECTS(! ec, ec.message());
+        roundtrip(p);
+
+        // close_notify is seen as end of file
+        p.server.async_shutdown(
+            [&](error_code ec)
+            {
+                BEAST_EXPECTS(! ec, ec.message());
+            });
+        char c;
+        p.client.async_read_some(net::buffer(&c, 1),
+            [&](error_code ec, std::size_t)
+            {
+                BEAST_EXPECT(ec == net::error::eof);
+            });
+        p.ioc.run();
+    }
+
+    void
+    testKtlsShutdownFull()
+    {
+        // close_notify waits for room in the send buffer
+        pair p(net::ssl::context::tlsv12);
+        error_code ec;
+        if(! BEAST_EXPECTS(p.handshake(ec), ec.message()))
+            return;
+        p.server.enable_ktls(ec);
+        if(ec)
+            return;
+        p.client.enable_ktls(ec);
+        BEAST_EXPECTS(! ec, ec.message());
+
+        p.server.next_layer().non_blocking(true);
+        std::string const chunk(16384, '*');
+        std::size_t sent = 0;
+        for(;;)
+        {
+            auto const n = p.server.write_some(
+                net::buffer(chunk), ec);
+            if(ec)
+                break;
+            sent += n;
+        }
+        BEAST_EXPECTS(ec == net::error::would_block, ec.message());
+        p.server.next_layer().non_blocking(false);
+
+        bool shut = false;
+        p.server.async_shutdown(
+            [&](error_code ec)
+            {
+                BEAST_EXPECTS(! ec, ec.message());
+                shut = true;
+            });
+        std::size_t got = 0;
+        std::string buf(chunk.size(), 0);
+        std::function<void(error_code, std::size_t)> on_read =
+            [&](error_code ec, std::size_t n)
+            {
+                got += n;
+                if(ec)
+                {
+                    BEAST_EXPECTS(ec == net::error::eof, ec.message());
+                    return;
+                }
+                p.client.async_read_some(
+                    net::buffer(&buf[0], buf.size()), on_read);
+            };
+        p.client.async_read_some(
+            net::buffer(&buf[0], buf.size()), on_read);
+        p.ioc.run();
+        BEAST_EXPECT(shut);
+        BEAST_EXPECT(got == sent);
+    }
+
+#if BOOST_BEAST_HAS_KTLS
+    // Encrypt a record with the keys which would be
+    // given to the kernel, and decrypt it with OpenSSL.
+    void
+    testKtlsKeys()
+    {
+        pair p(net::ssl::context::tlsv12);
+        SSL_CTX_set_cipher_list(p.cctx.native_handle(),
+            "ECDHE-RSA-AES128-GCM-SHA256");
+        error_code ec;
+        if(! BEAST_EXPECTS(p.handshake(ec), ec.message()))
+            return;
+        detail::ktls_crypto_info ci;
+        if(! BEAST_EXPECT(detail::ktls_get_crypto_info(
+                p.server.native_handle(), true, ci)))
+            return;
+        BEAST_EXPECT(ci.info.cipher_type == TLS_CIPHER_AES_GCM_128);
+        auto const& k = ci.aes_gcm_128;
+
+        std::string const s = "Hello, world!";
+        unsigned char const len = static_cast<unsigned char>(s.size());
+        unsigned char nonce[12];
+        std::memcpy(nonce, k.salt, 4);
+        std::memcpy(nonce + 4, k.rec_seq, 8);
+        unsigned char aad[13];
+        std::memcpy(aad, k.rec_seq, 8);
+        aad[8] = 23; aad[9] = 3; aad[10] = 3; aad[11] = 0; aad[12] = len;
+
+        // header, explicit nonce, ciphertext, tag
+        unsigned char rec[5 + 8 + 64 + 16];
+        rec[0] = 23; rec[1] = 3; rec[2] = 3; rec[3] = 0;
+        rec[4] = static_cast<unsigned char>(8 + len + 16);
+        std::memcpy(rec + 5, k.rec_seq, 8);
+        EVP_CIPHER_CTX* const ctx = EVP_CIPHER_CTX_new();
+        int n;
+        EVP_EncryptInit_ex(ctx, EVP_aes_128_gcm(), nullptr, k.key, nonce);
+        EVP_EncryptUpdate(ctx, nullptr, &n, aad, sizeof(aad));
+        EVP_EncryptUpdate(ctx, rec + 13, &n,
+            reinterpret_cast<unsigned char const*>(s.data()), len);
+        EVP_EncryptFinal_ex(ctx, rec + 13 + len, &n);
+        EVP_CIPHER_CTX_ctrl(ctx,
+            EVP_CTRL_GCM_GET_TAG, 16, rec + 13 + len);
+        EVP_CIPHER_CTX_free(ctx);
+        net::write(p.server.next_layer(),
+            net::buffer(rec, 13 + len + 16), ec);
+        BEAST_EXPECTS(! ec, ec.message());
+
+        std::string r(s.size(), 0);
+        net::read(p.client, net::buffer(&r[0], r.size()), ec);
+        BEAST_EXPECTS(! ec, ec.message());
+        BEAST_EXPECT(r == s);
+    }
+#endif
+
+    void
+    run() override
+    {
+        testKtlsUnsupported();
+        testKtls();
+        testKtlsShutdownFull();
+#if BOOST_BEAST_HAS_KTLS
+        testKtlsKeys();
+#endif
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(beast,ssl,ssl_stream);
+
+} // beast
+} // boost
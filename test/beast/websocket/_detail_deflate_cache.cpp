@@ -0,0 +1,246 @@
+//
+// Copyright (c) 2016-2019 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/boostorg/beast
+//
+
+// Test that header file is self-contained.
+#include <boost/beast/websocket/detail/deflate_cache.hpp>
+
+#include "test.hpp"
+
+#include <memory>
+#include <vector>
+
+namespace boost {
+namespace beast {
+namespace websocket {
+namespace detail {
+
+class deflate_cache_test : public websocket_test_suite
+{
+public:
+    static
+    boost::shared_ptr<deflate_cache::entry const>
+    find(permessage_deflate const& pmd, std::size_t size)
+    {
+        return deflate_cache::find(pmd.compLevel,
+            pmd.server_max_window_bits, pmd.memLevel, size);
+    }
+
+    void
+    testCache()
+    {
+        deflate_cache::insert(nullptr);
+        BEAST_EXPECT(! deflate_cache::find(8, 15, 4, 1));
+        auto e = deflate_cache::acquire();
+        if(! BEAST_EXPECT(e))
+            return;
+        e->level = 8;
+        e->window_bits = 15;
+        e->mem_level = 4;
+        e->in = "*";
+        e->out = "?";
+        auto const p = e.get();
+        deflate_cache::insert(std::move(e));
+        BEAST_EXPECT(deflate_cache::find(8, 15, 4, 1).get() == p);
+        BEAST_EXPECT(! deflate_cache::find(7, 15, 4, 1));
+        BEAST_EXPECT(! deflate_cache::find(8, 14, 4, 1));
+        BEAST_EXPECT(! deflate_cache::find(8, 15, 5, 1));
+        BEAST_EXPECT(! deflate_cache::find(8, 15, 4, 2));
+        {
+            // in use, a new entry is made
+            auto const h = deflate_cache::find(8, 15, 4, 1);
+            auto const e2 = deflate_cache::acquire();
+            BEAST_EXPECT(e2.get() != p);
+            BEAST_EXPECT(deflate_cache::find(8, 15, 4, 1) == h);
+        }
+        {
+            // not in use, the entry is reused
+            auto const e2 = deflate_cache::acquire();
+            BEAST_EXPECT(e2.get() == p);
+            BEAST_EXPECT(e2->in.empty());
+            BEAST_EXPECT(e2->out.empty());
+            BEAST_EXPECT(! deflate_cache::find(8, 15, 4, 1));
+        }
+    }
+
+    void
+    testStream()
+    {
+        permessage_deflate pmd;
+        pmd.client_enable = true;
+        pmd.server_enable = true;
+        pmd.server_no_context_takeover = true;
+        std::string const s = text(5000);
+        flat_buffer b;
+
+        deflate_cache::insert(nullptr);
+        pair p1(pmd);
+        pair p2(pmd);
+        p1.wss.write(net::buffer(s));
+        auto const e = find(pmd, s.size());
+        if(! BEAST_EXPECT(e))
+            return;
+        BEAST_EXPECT(e->in == s);
+        BEAST_EXPECT(e->out.size() < s.size());
+        p1.wsc.read(b);
+        BEAST_EXPECT(buffers_to_string(b.data()) == s);
+        b.clear();
+
+        // the cached output is sent, in small frames
+        p2.wss.write_buffer_bytes(64);
+        p2.wss.write(buffers_cat(
+            net::buffer(s.data(), 10),
+            net::buffer(s.data() + 10, s.size() - 10)));
+        BEAST_EXPECT(find(pmd, s.size()) == e);
+        p2.wsc.read(b);
+        BEAST_EXPECT(buffers_to_string(b.data()) == s);
+        b.clear();
+
+        // async
+        std::size_t n = 0;
+        p2.wss.async_write(net::buffer(s),
+            [&](error_code ec, std::size_t bytes_transferred)
+            {
+                BEAST_EXPECTS(! ec, ec.message());
+                n = bytes_transferred;
+            });
+        p2.ioc.run();
+        p2.ioc.restart();
+        BEAST_EXPECT(n == s.size());
+        BEAST_EXPECT(find(pmd, s.size()) == e);
+        p2.wsc.read(b);
+        BEAST_EXPECT(buffers_to_string(b.data()) == s);
+        b.clear();
+
+        // a different message of the same size
+        std::string s2 = s;
+        s2[100] = '*';
+        p1.wss.write(net::buffer(s2));
+        auto const e2 = find(pmd, s2.size());
+        BEAST_EXPECT(e2 && e2 != e);
+        p1.wsc.read(b);
+        BEAST_EXPECT(buffers_to_string(b.data()) == s2);
+        b.clear();
+
+        // a message in parts is not cached
+        p1.wss.write_some(false, net::buffer(s));
+        p1.wss.write_some(true, net::buffer(s));
+        BEAST_EXPECT(find(pmd, s2.size()) == e2);
+        p1.wsc.read(b);
+        BEAST_EXPECT(buffers_to_string(b.data()) == s + s);
+        b.clear();
+
+        // context takeover is not cached
+        {
+            permessage_deflate pmd2 = pmd;
+            pmd2.server_no_context_takeover = false;
+            pair p3(pmd2);
+            p3.wss.write(net::buffer(s));
+            BEAST_EXPECT(find(pmd, s2.size()) == e2);
+            p3.wsc.read(b);
+            BEAST_EXPECT(buffers_to_string(b.data()) == s);
+            b.clear();
+        }
+
+        // a different window size is not a match
+        {
+            permessage_deflate pmd2 = pmd;
+            pmd2.server_max_window_bits = 10;
+            pair p3(pmd2);
+            p3.wss.write(net::buffer(s2));
+            auto const e3 = find(pmd2, s2.size());
+            BEAST_EXPECT(e3 && e3 != e2);
+            p3.wsc.read(b);
+            BEAST_EXPECT(buffers_to_string(b.data()) == s2);
+            b.clear();
+        }
+
+        // client role
+        {
+            permessage_deflate pmd2 = pmd;
+            pmd2.server_no_context_takeover = false;
+            pmd2.client_no_context_takeover = true;
+            pair p3(pmd2);
+            pair p4(pmd2);
+            p3.wsc.write(net::buffer(s));
+            p4.wsc.write(net::buffer(s));
+            p3.wss.read(b);
+            BEAST_EXPECT(buffers_to_string(b.data()) == s);
+            b.clear();
+            p4.wss.read(b);
+            BEAST_EXPECT(buffers_to_string(b.data()) == s);
+            b.clear();
+        }
+    }
+
+    void
+    testBroadcast()
+    {
+        permessage_deflate pmd;
+        pmd.client_enable = true;
+        pmd.server_enable = true;
+        pmd.server_no_context_takeover = true;
+
+        // compressed output larger than the write buffer
+        std::string s(20000, '\0');
+        std::uint32_t v = 1;
+        for(auto& c : s)
+        {
+            v = v * 1103515245 + 12345;
+            c = static_cast<char>(v >> 24);
+        }
+
+        deflate_cache::insert(nullptr);
+        std::vector<std::unique_ptr<pair>> v4;
+        for(int i = 0; i < 4; ++i)
+            v4.emplace_back(new pair(pmd));
+        std::size_t sent = 0;
+        for(auto& p : v4)
+        {
+            p->wss.binary(true);
+            p->wss.async_write(net::buffer(s),
+                [&](error_code ec, std::size_t)
+                {
+                    BEAST_EXPECTS(! ec, ec.message());
+                    ++sent;
+                });
+        }
+
+        // every stream is sending the same entry
+        auto const e = find(pmd, s.size());
+        if(! BEAST_EXPECT(e))
+            return;
+        BEAST_EXPECT(e->out.size() > 4096);
+        BEAST_EXPECT(e.use_count() == 4 + 2);
+
+        for(auto& p : v4)
+        {
+            p->ioc.run();
+            flat_buffer b;
+            p->wsc.read(b);
+            BEAST_EXPECT(buffers_to_string(b.data()) == s);
+        }
+        BEAST_EXPECT(sent == 4);
+        BEAST_EXPECT(e.use_count() == 2);
+    }
+
+    void
+    run() override
+    {
+        testCache();
+        testStream();
+        testBroadcast();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(beast,websocket,deflate_cache);
+
+} // detail
+} // websocket
+} // beast
+} // boost
@@ -0,0 +1,154 @@
+//
+// Copyright (c) 2016-2019 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/boostorg/beast
+//
+
+// Test that header file is self-contained.
+#include <boost/beast/websocket/detail/zlib_pool.hpp>
+
+#include "test.hpp"
+
+#include <vector>
+
+namespace boost {
+namespace beast {
+namespace websocket {
+namespace detail {
+
+class zlib_pool_test : public websocket_test_suite
+{
+public:
+    // Takes every idle object out of the pool
+    struct drain
+    {
+        std::vector<std::unique_ptr<zlib::deflate_stream>> zo;
+        std::vector<std::unique_ptr<zlib::inflate_stream>> zi;
+
+        drain()
+        {
+            while(zlib_pool::idle_deflate() > 0)
+                zo.push_back(zlib_pool::acquire_deflate());
+            while(zlib_pool::idle_inflate() > 0)
+                zi.push_back(zlib_pool::acquire_inflate());
+        }
+    };
+
+    void
+    testPool()
+    {
+        drain d;
+        BEAST_EXPECT(zlib_pool::idle_deflate() == 0);
+        BEAST_EXPECT(zlib_pool::idle_inflate() == 0);
+
+        auto zo = zlib_pool::acquire_deflate();
+        auto zi = zlib_pool::acquire_inflate();
+        BEAST_EXPECT(zo && zi);
+        auto const po = zo.get();
+        auto const pi = zi.get();
+        zlib_pool::release(std::move(zo));
+        zlib_pool::release(std::move(zi));
+        BEAST_EXPECT(zlib_pool::idle_deflate() == 1);
+        BEAST_EXPECT(zlib_pool::idle_inflate() == 1);
+        BEAST_EXPECT(zlib_pool::acquire_deflate().get() == po);
+        BEAST_EXPECT(zlib_pool::acquire_inflate().get() == pi);
+        BEAST_EXPECT(zlib_pool::idle_deflate() == 0);
+        BEAST_EXPECT(zlib_pool::idle_inflate() == 0);
+
+        // null is ignored
+        zlib_pool::release(
+            std::unique_ptr<zlib::deflate_stream>{});
+        BEAST_EXPECT(zlib_pool::idle_deflate() == 0);
+
+        // at most max_size are kept
+        for(std::size_t i = 0; i <= zlib_pool::max_size; ++i)
+            zlib_pool::release(std::unique_ptr<
+                zlib::deflate_stream>(new zlib::deflate_stream));
+        BEAST_EXPECT(
+            zlib_pool::idle_deflate() == zlib_pool::max_size);
+    }
+
+    void
+    testStream()
+    {
+        permessage_deflate pmd;
+        pmd.client_enable = true;
+        pmd.server_enable = true;
+        flat_buffer b;
+
+        // without context takeover, the zlib
+        // state is given back after each message
+        {
+            permessage_deflate nct = pmd;
+            nct.server_no_context_takeover = true;
+            nct.client_no_context_takeover = true;
+            pair p(nct);
+            drain d;
+            for(char c = 'a'; c < 'd'; ++c)
+            {
+                auto const s = text(5000, c);
+                p.wss.write(net::buffer(s));
+                BEAST_EXPECT(zlib_pool::idle_deflate() == 1);
+                p.wsc.read(b);
+                BEAST_EXPECT(zlib_pool::idle_inflate() == 1);
+                BEAST_EXPECT(buffers_to_string(b.data()) == s);
+                b.clear();
+
+                p.wsc.async_write(net::buffer(s),
+                    [&](error_code ec, std::size_t)
+                    {
+                        BEAST_EXPECTS(! ec, ec.message());
+                    });
+                p.wss.async_read(b,
+                    [&](error_code ec, std::size_t)
+                    {
+                        BEAST_EXPECTS(! ec, ec.message());
+                    });
+                p.ioc.run();
+                p.ioc.restart();
+                BEAST_EXPECT(zlib_pool::idle_deflate() == 1);
+                BEAST_EXPECT(zlib_pool::idle_inflate() == 1);
+                BEAST_EXPECT(buffers_to_string(b.data()) == s);
+                b.clear();
+            }
+        }
+
+        // with context takeover, the stream keeps
+        // its zlib state until it is destroyed
+        {
+            drain d;
+            {
+                pair p(pmd);
+                for(char c = 'a'; c < 'd'; ++c)
+                {
+                    auto const s = text(5000, c);
+                    p.wss.write(net::buffer(s));
+                    p.wsc.read(b);
+                    BEAST_EXPECT(buffers_to_string(b.data()) == s);
+                    b.clear();
+                }
+                BEAST_EXPECT(zlib_pool::idle_deflate() == 0);
+                BEAST_EXPECT(zlib_pool::idle_inflate() == 0);
+            }
+            BEAST_EXPECT(zlib_pool::idle_deflate() == 1);
+            BEAST_EXPECT(zlib_pool::idle_inflate() == 1);
+        }
+    }
+
+    void
+    run() override
+    {
+        testPool();
+        testStream();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(beast,websocket,zlib_pool);
+
+} // detail
+} // websocket
+} // beast
+} // boost
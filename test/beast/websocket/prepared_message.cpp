@@ -0,0 +1,244 @@
+//
+// Copyright (c) 2016-2019 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/boostorg/beast
+//
+
+// Test that header file is self-contained.
+#include <boost/beast/websocket/prepared_message.hpp>
+
+#include "test.hpp"
+
+
+namespace boost {
+namespace beast {
+namespace websocket {
+
+class prepared_message_test : public websocket_test_suite
+{
+public:
+    void
+    testMessage()
+    {
+        permessage_deflate pmd;
+        pmd.server_enable = true;
+
+        {
+            prepared_message m;
+            BEAST_EXPECT(! m.binary());
+            BEAST_EXPECT(! m.deflated());
+            BEAST_EXPECT(m.size() == 0);
+        }
+        {
+            std::string const s = text(1000);
+            prepared_message m(net::buffer(s), true);
+            BEAST_EXPECT(m.binary());
+            BEAST_EXPECT(! m.deflated());
+            BEAST_EXPECT(m.size() == s.size());
+            BEAST_EXPECT(buffers_to_string(m.payload()) == s);
+        }
+        {
+            // buffer sequence
+            std::string const s = text(1000);
+            prepared_message m(buffers_cat(
+                net::buffer(s.data(), 10),
+                net::buffer(s.data() + 10, s.size() - 10)),
+                false, pmd);
+            BEAST_EXPECT(! m.binary());
+            BEAST_EXPECT(m.deflated());
+            BEAST_EXPECT(buffers_to_string(m.payload()) == s);
+        }
+        {
+            // too small to compress
+            prepared_message m(net::buffer("x", 1), false, pmd);
+            BEAST_EXPECT(! m.deflated());
+        }
+        {
+            permessage_deflate bad = pmd;
+            bad.server_max_window_bits = 8;
+            try
+            {
+                prepared_message m(net::buffer("x", 1), false, bad);
+                fail("", __FILE__, __LINE__);
+            }
+            catch(std::invalid_argument const&)
+            {
+                pass();
+            }
+        }
+    }
+
+    void
+    testWrite(
+        permessage_deflate const& client,
+        permessage_deflate const& server,
+        permessage_deflate const& prep)
+    {
+        pair p(client, server);
+        if(! BEAST_EXPECT(p.wss.is_open()))
+            return;
+        std::string const s = text(5000);
+        prepared_message const m(net::buffer(s), false, prep);
+        prepared_message const mb(net::buffer(s), true, prep);
+        flat_buffer b;
+
+        // sync
+        BEAST_EXPECT(p.wss.write_prepared(m) == s.size());
+        p.wsc.read(b);
+        BEAST_EXPECT(p.wsc.got_text());
+        BEAST_EXPECT(buffers_to_string(b.data()) == s);
+        b.clear();
+
+        // a regular message from the compressor after
+        // a prepared one, then a prepared one again
+        p.wss.text(true);
+        p.wss.write(net::buffer(s));
+        p.wss.write_prepared(mb);
+        p.wsc.read(b);
+        BEAST_EXPECT(buffers_to_string(b.data()) == s);
+        b.clear();
+        p.wsc.read(b);
+        BEAST_EXPECT(p.wsc.got_binary());
+        BEAST_EXPECT(buffers_to_string(b.data()) == s);
+        b.clear();
+
+        // async
+        std::size_t n = 0;
+        p.wss.async_write_prepared(m,
+            [&](error_code ec, std::size_t bytes_transferred)
+            {
+                BEAST_EXPECTS(! ec, ec.message());
+                n = bytes_transferred;
+                p.wss.async_write_prepared(prepared_message{},
+                    [&](error_code ec, std::size_t)
+                    {
+                        BEAST_EXPECTS(! ec, ec.message());
+                    });
+            });
+        p.ioc.run();
+        p.ioc.restart();
+        BEAST_EXPECT(n == s.size());
+        p.wsc.read(b);
+        BEAST_EXPECT(buffers_to_string(b.data()) == s);
+        b.clear();
+        p.wsc.read(b);
+        BEAST_EXPECT(p.wsc.got_text());
+        BEAST_EXPECT(b.size() == 0);
+
+        // client role masks the payload
+        p.wsc.write_buffer_bytes(1000);
+        BEAST_EXPECT(p.wsc.write_prepared(mb) == s.size());
+        p.wss.read(b);
+        BEAST_EXPECT(p.wss.got_binary());
+        BEAST_EXPECT(buffers_to_string(b.data()) == s);
+        b.clear();
+        p.wsc.async_write_prepared(m,
+            [&](error_code ec, std::size_t bytes_transferred)
+            {
+                BEAST_EXPECTS(! ec, ec.message());
+                n = bytes_transferred;
+            });
+        p.ioc.run();
+        p.ioc.restart();
+        BEAST_EXPECT(n == s.size());
+        p.wss.read(b);
+        BEAST_EXPECT(p.wss.got_text());
+        BEAST_EXPECT(buffers_to_string(b.data()) == s);
+    }
+
+    void
+    testWrite()
+    {
+        permessage_deflate none;
+        permessage_deflate pmd;
+        pmd.client_enable = true;
+        pmd.server_enable = true;
+
+        // no compression
+        testWrite(none, none, none);
+        testWrite(none, none, pmd);
+
+        // context takeover
+        testWrite(pmd, pmd, pmd);
+        testWrite(pmd, pmd, none);
+
+        // no context takeover
+        {
+            permessage_deflate nct = pmd;
+            nct.server_no_context_takeover = true;
+            testWrite(nct, nct, pmd);
+        }
+
+        // negotiated window is smaller
+        {
+            permessage_deflate small = pmd;
+            small.server_max_window_bits = 10;
+            testWrite(small, small, pmd);
+        }
+    }
+
+    void
+    testClosed()
+    {
+        pair p({}, {});
+        prepared_message const m(net::buffer("*", 1));
+        flat_buffer b;
+        p.wsc.async_close({}, [](error_code){});
+        p.wss.async_read(b, [](error_code, std::size_t){});
+        p.ioc.run();
+        try
+        {
+            p.wss.write_prepared(m);
+            fail("", __FILE__, __LINE__);
+        }
+        catch(system_error const& se)
+        {
+            BEAST_EXPECTS(
+                se.code() == net::error::operation_aborted,
+                se.code().message());
+        }
+
+        // a failed write reports no bytes
+        for(bool client : {false, true})
+        {
+            pair p2({}, {});
+            auto& ws = client ? p2.wsc : p2.wss;
+            ws.next_layer().close();
+            error_code ec;
+            BEAST_EXPECT(ws.write_prepared(m, ec) == 0);
+            BEAST_EXPECTS(ec, ec.message());
+        }
+        for(bool client : {false, true})
+        {
+            pair p2({}, {});
+            auto& ws = client ? p2.wsc : p2.wss;
+            ws.next_layer().close();
+            std::size_t n = 1;
+            ws.async_write_prepared(m,
+                [&](error_code ec, std::size_t bytes_transferred)
+                {
+                    BEAST_EXPECTS(ec, ec.message());
+                    n = bytes_transferred;
+                });
+            p2.ioc.run();
+            BEAST_EXPECT(n == 0);
+        }
+    }
+
+    void
+    run() override
+    {
+        testMessage();
+        testWrite();
+        testClosed();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(beast,websocket,prepared_message);
+
+} // websocket
+} // beast
+} // boost
@@ -12,7 +12,9 @@
 
 #include <boost/beast/_experimental/test/stream.hpp>
 #include <boost/beast/_experimental/test/tcp.hpp>
+#include <boost/beast/core/buffers_to_string.hpp>
 #include <boost/beast/core/flat_buffer.hpp>
+#include <boost/beast/core/tcp_stream.hpp>
 
 namespace boost {
 namespace beast {
@@ -139,10 +141,115 @@ public:
         }
     }
 
+    static
+    void
+    connect(net::ip::tcp::socket& s1, net::ip::tcp::socket& s2)
+    {
+        test::connect(s1, s2);
+    }
+
+    static
+    void
+    connect(tcp_stream& s1, tcp_stream& s2)
+    {
+        test::connect(s1.socket(), s2.socket());
+    }
+
+    static
+    void
+    connect(test::stream& s1, test::stream& s2)
+    {
+        test::connect(s1, s2);
+    }
+
+    template<class NextLayer>
+    void
+    doPooledReadBuffer(net::io_context& ioc)
+    {
+        stream<NextLayer> ws1(ioc);
+        stream<NextLayer> ws2(ioc);
+        BEAST_EXPECT(! ws2.pooled_read_buffer());
+        ws2.pooled_read_buffer(true);
+        BEAST_EXPECT(ws2.pooled_read_buffer());
+        connect(ws1.next_layer(), ws2.next_layer());
+        ws1.async_handshake("test", "/", test::success_handler());
+        ws2.async_accept(test::success_handler());
+        test::run(ioc);
+
+        // idle, then a small message
+        {
+            flat_buffer b;
+            ws2.async_read(b, test::success_handler());
+            ioc.run_for(std::chrono::milliseconds(10));
+            ioc.restart();
+            ws1.async_write(net::const_buffer("Hello, world!", 13),
+                test::success_handler());
+            test::run(ioc);
+            BEAST_EXPECT(buffers_to_string(b.data()) == "Hello, world!");
+        }
+
+        // control frames and a fragmented message
+        {
+            flat_buffer b;
+            ws1.async_ping({}, test::success_handler());
+            test::run(ioc);
+            ws1.async_write_some(false,
+                net::buffer(std::string(50, '*')),
+                test::success_handler());
+            test::run(ioc);
+            ws1.async_write_some(true,
+                net::buffer(std::string(50, '*')),
+                test::success_handler());
+            ws2.async_read(b, test::success_handler());
+            test::run(ioc);
+            BEAST_EXPECT(buffers_to_string(b.data()) ==
+                std::string(100, '*'));
+        }
+
+        // several messages received together, synchronously
+        {
+            ws1.write(net::const_buffer("1", 1));
+            ws1.write(net::const_buffer("2", 1));
+            ws1.write(net::buffer(std::string(20000, '3')));
+            flat_buffer b;
+            ws2.read(b);
+            BEAST_EXPECT(buffers_to_string(b.data()) == "1");
+            b.clear();
+            ws2.read(b);
+            BEAST_EXPECT(buffers_to_string(b.data()) == "2");
+            b.clear();
+            ws2.read(b);
+            BEAST_EXPECT(buffers_to_string(b.data()) ==
+                std::string(20000, '3'));
+        }
+
+        // timeout while idle
+        {
+            flat_buffer b;
+            ws2.set_option(stream_base::timeout{
+                stream_base::none(),
+                std::chrono::milliseconds(50),
+                false});
+            ws2.async_read(b, test::fail_handler(
+                beast::error::timeout));
+            test::run(ioc);
+        }
+    }
+
+    void
+    testPooledReadBuffer()
+    {
+        net::io_context ioc;
+        doPooledReadBuffer<net::ip::tcp::socket>(ioc);
+        doPooledReadBuffer<tcp_stream>(ioc);
+        doPooledReadBuffer<test::stream>(ioc);
+    }
+
     void
     run() override
     {
         testTimeout();
+        testPooledReadBuffer();
     }
 };
 
@@ -1030,6 +1030,279 @@ public:
         }
     }
 
+    // Frames already in the read buffer are delivered together
+    void
+    testBurst()
+    {
+        for(int i = 0; i < 2; ++i)
+        {
+            bool const async = i == 1;
+            net::io_context ioc;
+            stream<test::stream> wsc{ioc};
+            stream<test::stream> wss{ioc};
+            wsc.next_layer().connect(wss.next_layer());
+            wsc.async_handshake(
+                "localhost", "/", [](error_code){});
+            wss.async_accept([](error_code){});
+            ioc.run();
+            ioc.restart();
+            std::size_t pings = 0;
+            wsc.control_callback(
+                [&](frame_type kind, string_view)
+                {
+                    if(kind == frame_type::ping)
+                        ++pings;
+                });
+            auto const read_some =
+                [&](net::mutable_buffer b, error_code& ec)
+                {
+                    if(! async)
+                        return wsc.read_some(b, ec);
+                    std::size_t n = 0;
+                    wsc.async_read_some(b,
+                        [&](error_code ec_, std::size_t n_)
+                        {
+                            ec = ec_;
+                            n = n_;
+                        });
+                    ioc.run();
+                    ioc.restart();
+                    return n;
+                };
+
+            // a message in four frames with pings
+            // in between, and a second message
+            net::write(wss.next_layer(), sbuf(
+                "\x01\x01" "a"
+                "\x00\x01" "b"
+                "\x89\x01" "1"
+                "\x89\x01" "2"
+                "\x89\x01" "3"
+                "\x00\x01" "c"
+                "\x80\x01" "d"
+                "\x81\x01" "e"));
+            auto const n0 = wsc.next_layer().nwrite();
+            char buf[64];
+            error_code ec;
+            // a control frame ends the burst
+            auto n = read_some(net::buffer(buf), ec);
+            BEAST_EXPECTS(! ec, ec.message());
+            BEAST_EXPECT(string_view(buf, n) == "ab");
+            BEAST_EXPECT(pings == 0);
+            BEAST_EXPECT(wsc.next_layer().nwrite() == n0);
+            n = read_some(net::buffer(buf), ec);
+            BEAST_EXPECTS(! ec, ec.message());
+            BEAST_EXPECT(string_view(buf, n) == "cd");
+            BEAST_EXPECT(wsc.is_message_done());
+            BEAST_EXPECT(pings == 3);
+            // only the last ping is answered
+            BEAST_EXPECT(wsc.next_layer().nwrite() == n0 + 1);
+            {
+                flat_buffer b;
+                wsc.read(b);
+                BEAST_EXPECT(buffers_to_string(b.data()) == "e");
+                BEAST_EXPECT(pings == 3);
+            }
+
+            // a full buffer ends the burst
+            net::write(wss.next_layer(), sbuf(
+                "\x01\x01" "a"
+                "\x00\x01" "b"
+                "\x80\x01" "c"));
+            n = read_some(net::buffer(buf, 2), ec);
+            BEAST_EXPECTS(! ec, ec.message());
+            BEAST_EXPECT(string_view(buf, n) == "ab");
+            BEAST_EXPECT(! wsc.is_message_done());
+            n = read_some(net::buffer(buf), ec);
+            BEAST_EXPECT(string_view(buf, n) == "c");
+            BEAST_EXPECT(wsc.is_message_done());
+
+            // an incomplete frame ends the burst
+            net::write(wss.next_layer(), sbuf(
+                "\x01\x01" "a"
+                "\x00\x02" "b"));
+            n = read_some(net::buffer(buf), ec);
+            BEAST_EXPECTS(! ec, ec.message());
+            BEAST_EXPECT(string_view(buf, n) == "a");
+            net::write(wss.next_layer(), sbuf("c" "\x80\x01" "d"));
+            n = read_some(net::buffer(buf), ec);
+            BEAST_EXPECTS(! ec, ec.message());
+            BEAST_EXPECT(string_view(buf, n) == "b");
+            n = read_some(net::buffer(buf), ec);
+            BEAST_EXPECTS(! ec, ec.message());
+            BEAST_EXPECT(string_view(buf, n) == "cd");
+            BEAST_EXPECT(wsc.is_message_done());
+
+            // data is delivered before a ping, without
+            // waiting for a write in progress
+            net::write(wss.next_layer(), sbuf(
+                "\x01\x01" "a"
+                "\x89\x00"
+                "\x80\x01" "b"));
+            bool wrote = false;
+            if(async)
+                wsc.async_write(net::buffer("x", 1),
+                    [&](error_code ec, std::size_t)
+                    {
+                        BEAST_EXPECTS(! ec, ec.message());
+                        wrote = true;
+                    });
+            n = read_some(net::buffer(buf), ec);
+            BEAST_EXPECTS(! ec, ec.message());
+            BEAST_EXPECT(string_view(buf, n) == "a");
+            BEAST_EXPECT(pings == 3);
+            BEAST_EXPECT(wrote == async);
+            n = read_some(net::buffer(buf), ec);
+            BEAST_EXPECTS(! ec, ec.message());
+            BEAST_EXPECT(string_view(buf, n) == "b");
+            BEAST_EXPECT(pings == 4);
+            BEAST_EXPECT(wsc.is_message_done());
+
+            // data is delivered before a close frame
+            net::write(wss.next_layer(), sbuf(
+                "\x01\x01" "a"
+                "\x88\x02\x03\xe8"));
+            n = read_some(net::buffer(buf), ec);
+            BEAST_EXPECTS(! ec, ec.message());
+            BEAST_EXPECT(string_view(buf, n) == "a");
+            n = read_some(net::buffer(buf), ec);
+            BEAST_EXPECTS(ec == error::closed, ec.message());
+            BEAST_EXPECT(n == 0);
+        }
+    }
+
+    void
+    testReadMany()
+    {
+        for(int i = 0; i < 2; ++i)
+        {
+            bool const async = i == 1;
+            net::io_context ioc;
+            stream<test::stream> wsc{ioc};
+            stream<test::stream> wss{ioc};
+            wsc.next_layer().connect(wss.next_layer());
+            wsc.async_handshake(
+                "localhost", "/", [](error_code){});
+            wss.async_accept([](error_code){});
+            ioc.run();
+            ioc.restart();
+            flat_buffer b;
+            std::vector<stream_base::message_info> v;
+            auto const read_many =
+                [&](std::size_t max_messages, error_code& ec)
+                {
+                    if(! async)
+                        return wsc.read_many(b, v, max_messages, ec);
+                    std::size_t n = 0;
+                    wsc.async_read_many(b, v, max_messages,
+                        [&](error_code ec_, std::size_t n_)
+                        {
+                            ec = ec_;
+                            n = n_;
+                        });
+                    ioc.run();
+                    ioc.restart();
+                    return n;
+                };
+            auto const message =
+                [&](std::size_t i)
+                {
+                    return std::string(static_cast<char const*>(
+                        b.data().data()) + v[i].offset, v[i].size);
+                };
+
+            // messages received together
+            net::write(wss.next_layer(), sbuf(
+                "\x81\x01" "a"
+                "\x82\x02" "bc"
+                "\x81\x03" "def"));
+            error_code ec;
+            auto n = read_many(10, ec);
+            BEAST_EXPECTS(! ec, ec.message());
+            BEAST_EXPECT(n == 6);
+            if(BEAST_EXPECT(v.size() == 3))
+            {
+                BEAST_EXPECT(v[0].offset == 0);
+                BEAST_EXPECT(! v[0].binary);
+                BEAST_EXPECT(message(0) == "a");
+                BEAST_EXPECT(v[1].offset == 1);
+                BEAST_EXPECT(v[1].binary);
+                BEAST_EXPECT(message(1) == "bc");
+                BEAST_EXPECT(v[2].offset == 3);
+                BEAST_EXPECT(! v[2].binary);
+                BEAST_EXPECT(message(2) == "def");
+            }
+            BEAST_EXPECT(wsc.got_text());
+
+            // at most max_messages, offsets follow
+            // the data already in the buffer
+            net::write(wss.next_layer(), sbuf(
+                "\x81\x01" "g"
+                "\x81\x01" "h"
+                "\x81\x01" "i"));
+            n = read_many(2, ec);
+            BEAST_EXPECTS(! ec, ec.message());
+            BEAST_EXPECT(n == 2);
+            if(BEAST_EXPECT(v.size() == 2))
+            {
+                BEAST_EXPECT(v[0].offset == 6);
+                BEAST_EXPECT(message(0) == "g");
+                BEAST_EXPECT(message(1) == "h");
+            }
+            b.clear();
+            n = read_many(2, ec);
+            BEAST_EXPECTS(! ec, ec.message());
+            if(BEAST_EXPECT(v.size() == 1))
+                BEAST_EXPECT(message(0) == "i");
+
+            // a fragmented or incomplete message,
+            // or a control frame, ends the batch
+            net::write(wss.next_layer(), sbuf(
+                "\x81\x01" "a"
+                "\x01\x01" "b"
+                "\x80\x01" "c"
+                "\x89\x00"
+                "\x81\x01" "d"
+                "\x81\x02" "e"));
+            b.clear();
+            n = read_many(10, ec);
+            BEAST_EXPECTS(! ec, ec.message());
+            if(BEAST_EXPECT(v.size() == 1))
+                BEAST_EXPECT(message(0) == "a");
+            b.clear();
+            n = read_many(10, ec);
+            BEAST_EXPECTS(! ec, ec.message());
+            if(BEAST_EXPECT(v.size() == 1))
+                BEAST_EXPECT(message(0) == "bc");
+            b.clear();
+            n = read_many(10, ec);
+            BEAST_EXPECTS(! ec, ec.message());
+            if(BEAST_EXPECT(v.size() == 1))
+                BEAST_EXPECT(message(0) == "d");
+            net::write(wss.next_layer(), sbuf("f"));
+            b.clear();
+            n = read_many(10, ec);
+            BEAST_EXPECTS(! ec, ec.message());
+            if(BEAST_EXPECT(v.size() == 1))
+                BEAST_EXPECT(message(0) == "ef");
+
+            // a close frame ends the batch
+            net::write(wss.next_layer(), sbuf(
+                "\x81\x01" "a"
+                "\x88\x00"));
+            b.clear();
+            n = read_many(10, ec);
+            BEAST_EXPECTS(! ec, ec.message());
+            if(BEAST_EXPECT(v.size() == 1))
+                BEAST_EXPECT(message(0) == "a");
+            b.clear();
+            n = read_many(10, ec);
+            BEAST_EXPECTS(ec == error::closed, ec.message());
+            BEAST_EXPECT(n == 0);
+            BEAST_EXPECT(v.empty());
+        }
+    }
+
     void
     run() override
     {
@@ -1040,6 +1313,8 @@ public:
         testIssue1630();
         testIssueBF1();
         testIssueBF2();
+        testBurst();
+        testReadMany();
         testMoveOnly();
         testAsioHandlerInvoke();
     }
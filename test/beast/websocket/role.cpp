@@ -0,0 +1,99 @@
+//
+// Copyright (c) 2016-2019 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/boostorg/beast
+//
+
+// Test that header file is self-contained.
+#include <boost/beast/websocket/role.hpp>
+
+#include "test.hpp"
+
+#include <boost/asio/io_context.hpp>
+
+namespace boost {
+namespace beast {
+namespace websocket {
+
+class role_test : public websocket_test_suite
+{
+public:
+    BOOST_STATIC_ASSERT(! detail::is_client(
+        server_role{}, role_type::client));
+    BOOST_STATIC_ASSERT(detail::is_client(
+        client_role{}, role_type::server));
+
+    template<class Server, class Client>
+    void
+    testRoles()
+    {
+        net::io_context ioc;
+        Server wss{ioc};
+        Client wsc{ioc};
+        wsc.next_layer().connect(wss.next_layer());
+        wss.async_accept(
+            [&](error_code ec)
+            {
+                BEAST_EXPECTS(! ec, ec.message());
+            });
+        wsc.async_handshake("localhost", "/",
+            [&](error_code ec)
+            {
+                BEAST_EXPECTS(! ec, ec.message());
+            });
+        ioc.run();
+        ioc.restart();
+        if(! BEAST_EXPECT(wss.is_open() && wsc.is_open()))
+            return;
+
+        std::string s;
+        while(s.size() < 20000)
+            s += "Hello, \xce\xba\xe1\xbd\xb9\xcf\x83\xce\xbc\xce\xb5! ";
+        flat_buffer b;
+
+        // client to server, masked
+        wsc.write(net::buffer(s));
+        wss.read(b);
+        BEAST_EXPECT(wss.got_text());
+        BEAST_EXPECT(buffers_to_string(b.data()) == s);
+        b.clear();
+
+        // server to client
+        wss.binary(true);
+        wss.write(net::buffer(s));
+        wsc.read(b);
+        BEAST_EXPECT(wsc.got_binary());
+        BEAST_EXPECT(buffers_to_string(b.data()) == s);
+        b.clear();
+
+        // invalid text from the client
+        wsc.write(net::buffer("\xff", 1));
+        error_code ec;
+        wss.read(b, ec);
+        BEAST_EXPECTS(ec == error::bad_frame_payload,
+            ec.message());
+    }
+
+    void
+    run() override
+    {
+        testRoles<
+            stream<test::stream, true, server_role>,
+            stream<test::stream, true, client_role>>();
+        testRoles<
+            stream<test::stream, false, server_role>,
+            stream<test::stream>>();
+        testRoles<
+            stream<test::stream>,
+            stream<test::stream, false, client_role>>();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(beast,websocket,role);
+
+} // websocket
+} // beast
+} // boost
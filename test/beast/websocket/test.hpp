@@ -273,6 +273,34 @@ public:
         }
     };
 
+    // A connected client and server after the handshake
+    struct pair
+    {
+        net::io_context ioc;
+        stream<test::stream> wsc{ioc};
+        stream<test::stream> wss{ioc};
+
+        explicit
+        pair(permessage_deflate const& pmd)
+            : pair(pmd, pmd)
+        {
+        }
+
+        pair(
+            permessage_deflate const& client,
+            permessage_deflate const& server)
+        {
+            wsc.set_option(client);
+            wss.set_option(server);
+            wsc.next_layer().connect(wss.next_layer());
+            wsc.async_handshake(
+                "localhost", "/", [](error_code){});
+            wss.async_accept([](error_code){});
+            ioc.run();
+            ioc.restart();
+        }
+    };
+
     template<class Test>
     void
     doFailLoop(
@@ -387,6 +415,23 @@ public:
         return net::const_buffer(&s[0], N-1);
     }
 
+    // Compressible text of n bytes, each phrase
+    // followed by c when it is not zero
+    static
+    std::string
+    text(std::size_t n, char c = 0)
+    {
+        std::string s;
+        while(s.size() < n)
+        {
+            s += "Hello, world! ";
+            if(c != 0)
+                s += c;
+        }
+        s.resize(n);
+        return s;
+    }
+
     template<
         class DynamicBuffer,
         class ConstBufferSequence>
@@ -16,6 +16,32 @@
 #include <boost/beast/core/flat_buffer.hpp>
 #include <boost/asio/ip/tcp.hpp>
 #include <boost/asio/detached.hpp>
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include <string>
+
+namespace {
+
+// Counts calls to the global operator new
+std::atomic<std::size_t> heap_allocations{0};
+
+} // (anon)
+
+void*
+operator new(std::size_t n)
+{
+    ++heap_allocations;
+    if(auto p = std::malloc(n == 0 ? 1 : n))
+        return p;
+    throw std::bad_alloc();
+}
+
+void
+operator delete(void* p) noexcept
+{
+    std::free(p);
+}
 
 namespace boost {
 namespace beast {
@@ -184,12 +210,144 @@ struct timer_test : unit_test::suite
         ioc.run();
     }
 
+    void
+    testTimeoutService()
+    {
+        net::io_context ioc;
+        auto& svc = net::use_service<timeout_service>(ioc);
+        svc.resolution(std::chrono::milliseconds(10));
+
+        // idle ping, no timeout
+
+        {
+            stream<tcp::socket> ws1(ioc);
+            stream<tcp::socket> ws2(ioc);
+            ws2.use_timeout_service(svc);
+            test::connect(ws1.next_layer(), ws2.next_layer());
+            ws1.async_accept(test::success_handler());
+            ws2.async_handshake("test", "/", test::success_handler());
+            test::run(ioc);
+
+            ws2.set_option(stream_base::timeout{
+                stream_base::none(),
+                std::chrono::milliseconds(100),
+                true});
+            flat_buffer b1;
+            flat_buffer b2;
+            int received = 0;
+            ws1.control_callback(
+                [&received](frame_type ft, string_view)
+                {
+                    ++received;
+                    BEAST_EXPECT(ft == frame_type::ping);
+                });
+            ws1.async_read(b1, test::fail_handler(
+                net::error::operation_aborted));
+            ws2.async_read(b2, test::fail_handler(
+                net::error::operation_aborted));
+            BEAST_EXPECT(svc.size() == 1);
+            test::run_for(ioc, std::chrono::milliseconds(500));
+            BEAST_EXPECT(received > 1);
+        }
+
+        test::run(ioc);
+        BEAST_EXPECT(svc.size() == 0);
+
+        // idle pings do not allocate once warmed up. The
+        // socket uses the concrete io_context executor, since
+        // any_io_executor allocates to type-erase completions.
+
+        {
+            using socket_type = net::basic_stream_socket<
+                tcp, net::io_context::executor_type>;
+            stream<socket_type> ws1(ioc.get_executor());
+            stream<socket_type> ws2(ioc.get_executor());
+            ws2.use_timeout_service(svc);
+            test::connect(ws1.next_layer(), ws2.next_layer());
+            ws1.async_accept(test::success_handler());
+            ws2.async_handshake("test", "/", test::success_handler());
+            test::run(ioc);
+
+            ws2.set_option(stream_base::timeout{
+                stream_base::none(),
+                std::chrono::milliseconds(100),
+                true});
+            flat_buffer b1;
+            flat_buffer b2;
+            int received = 0;
+            ws1.control_callback(
+                [&received](frame_type, string_view)
+                {
+                    ++received;
+                });
+            ws1.async_read(b1, test::fail_handler(
+                net::error::operation_aborted));
+            ws2.async_read(b2, test::fail_handler(
+                net::error::operation_aborted));
+            test::run_for(ioc, std::chrono::milliseconds(300));
+            BEAST_EXPECT(received > 1);
+
+            auto const n = received;
+            auto const allocs = heap_allocations.load();
+            test::run_for(ioc, std::chrono::milliseconds(500));
+            BEAST_EXPECT(received > n + 1);
+            BEAST_EXPECTS(heap_allocations.load() == allocs,
+                std::to_string(heap_allocations.load() - allocs));
+        }
+
+        test::run(ioc);
+        BEAST_EXPECT(svc.size() == 0);
+
+        // idle ping, timeout
+
+        {
+            stream<tcp::socket> ws1(ioc);
+            stream<tcp::socket> ws2(ioc);
+            ws2.use_timeout_service(svc);
+            test::connect(ws1.next_layer(), ws2.next_layer());
+            ws1.async_accept(test::success_handler());
+            ws2.async_handshake("test", "/", test::success_handler());
+            test::run(ioc);
+
+            ws2.set_option(stream_base::timeout{
+                stream_base::none(),
+                std::chrono::milliseconds(50),
+                true});
+            flat_buffer b;
+            ws2.async_read(b,
+                test::fail_handler(beast::error::timeout));
+            test::run(ioc);
+        }
+
+        test::run(ioc);
+
+        // handshake timeout
+
+        {
+            stream<tcp::socket> ws1(ioc);
+            stream<tcp::socket> ws2(ioc);
+            ws1.use_timeout_service(svc);
+            test::connect(ws1.next_layer(), ws2.next_layer());
+            ws1.set_option(stream_base::timeout{
+                std::chrono::milliseconds(50),
+                stream_base::none(),
+                false});
+            ws1.async_accept(
+                test::fail_handler(beast::error::timeout));
+            test::run(ioc);
+        }
+
+        test::run(ioc);
+        BEAST_EXPECT(svc.size() == 0);
+    }
+
     void
     run() override
     {
         testIssue1729();
         testIdlePing();
         testCloseWhileRead();
+        testTimeoutService();
     }
 };
 
@@ -10,10 +10,12 @@
 // Test that header file is self-contained.
 #include <boost/beast/websocket/detail/utf8_checker.hpp>
 
+#include <boost/beast/websocket/detail/mask.hpp>
 #include <boost/beast/core/buffers_suffix.hpp>
 #include <boost/beast/core/multi_buffer.hpp>
 #include <boost/beast/_experimental/unit_test/suite.hpp>
 #include <array>
+#include <string>
 
 namespace boost {
 namespace beast {
@@ -566,6 +568,61 @@ public:
         }
     }
 
+    void
+    testMasked()
+    {
+        // Unmasking and validating in one pass must agree
+        // with unmasking first and validating afterwards,
+        // wherever a code point or the key is split.
+        std::string text;
+        while(text.size() < 300)
+            text += "abc\xce\xba\xe1\xbd\xb9\xf0\x90\x8d\x88xyz";
+        std::uint32_t const key = 0x12345678;
+        auto const check =
+            [&](std::string s, std::size_t split, bool expected)
+            {
+                prepared_key k1;
+                prepare_key(k1, key);
+                mask_inplace(net::buffer(&s[0], s.size()), k1);
+                prepared_key k2;
+                prepare_key(k2, key);
+                utf8_checker u;
+                bool const ok =
+                    mask_utf8_inplace(net::buffer(
+                        &s[0], split), k2, u) &&
+                    mask_utf8_inplace(net::buffer(
+                        &s[split], s.size() - split), k2, u) &&
+                    u.finish();
+                BEAST_EXPECT(ok == expected);
+                return s;
+            };
+        for(std::size_t i = 0; i <= text.size(); i += 7)
+            BEAST_EXPECT(check(text, i, true) == text);
+        for(std::size_t pos : {0, 63, 64, 65, 200, 299})
+        {
+            auto bad = text;
+            bad[pos] = '\xff';
+            check(bad, 0, false);
+            check(bad, 130, false);
+        }
+        // truncated code point
+        check(text.substr(0, text.size() - 1) + "\xce", 64, false);
+
+        // buffer sequence
+        std::string s = text;
+        prepared_key k;
+        prepare_key(k, key);
+        mask_inplace(net::buffer(&s[0], s.size()), k);
+        prepare_key(k, key);
+        std::array<net::mutable_buffer, 2> bs{{
+            net::buffer(&s[0], 101),
+            net::buffer(&s[101], s.size() - 101)}};
+        utf8_checker u;
+        BEAST_EXPECT(mask_utf8_inplace(bs, k, u));
+        BEAST_EXPECT(u.finish());
+        BEAST_EXPECT(s == text);
+    }
+
     void
     run() override
     {
@@ -576,6 +633,7 @@ public:
         testWithStreamBuffer();
         testBranches();
         AutodeskTests();
+        testMasked();
         // 6.4.2
         AutobahnTest(std::vector<std::vector<std::uint8_t>>{
             { 0xCE, 0xBA, 0xE1, 0xBD, 0xB9, 0xCF, 0x83, 0xCE, 0xBC, 0xCE, 0xB5, 0xF4 },
@@ -720,6 +720,276 @@ public:
         BEAST_EXPECT(n1 < n0 + s.size());
     }
 
+    void
+    testWriteInplace()
+    {
+        permessage_deflate pmd;
+        pmd.client_enable = true;
+        pmd.server_enable = true;
+        std::string const s(5000, '*');
+
+        for(int i = 0; i < 4; ++i)
+        {
+            bool const client = (i & 1) != 0;
+            bool const async = (i & 2) != 0;
+            net::io_context ioc;
+            stream<test::stream> wsc{ioc};
+            stream<test::stream> wss{ioc};
+            wsc.set_option(pmd);
+            wss.set_option(pmd);
+            wsc.next_layer().connect(wss.next_layer());
+            wsc.async_handshake(
+                "localhost", "/", [](error_code){});
+            wss.async_accept([](error_code){});
+            ioc.run();
+            ioc.restart();
+            auto& from = client ? wsc : wss;
+            auto& to = client ? wss : wsc;
+
+            // The payload is not copied into the write buffer,
+            // and it is sent uncompressed in one write.
+            from.write_buffer_bytes(8);
+            from.binary(true);
+            std::string m = s;
+            auto const n0 = from.next_layer().nwrite();
+            auto const b0 = to.next_layer().nwrite_bytes();
+            std::size_t n = 0;
+            if(async)
+            {
+                from.async_write_inplace(buffers_cat(
+                    net::buffer(&m[0], 10),
+                    net::buffer(&m[10], m.size() - 10)),
+                    [&](error_code ec, std::size_t bytes_transferred)
+                    {
+                        BEAST_EXPECTS(! ec, ec.message());
+                        n = bytes_transferred;
+                    });
+                ioc.run();
+                ioc.restart();
+            }
+            else
+            {
+                n = from.write_inplace(net::buffer(&m[0], m.size()));
+            }
+            BEAST_EXPECT(n == s.size());
+            BEAST_EXPECT(from.next_layer().nwrite() == n0 + 1);
+            BEAST_EXPECT(to.next_layer().nwrite_bytes() ==
+                b0 + s.size() + (client ? 8 : 4));
+            // masked in place by a client
+            BEAST_EXPECT((m == s) == ! client);
+
+            flat_buffer b;
+            to.read(b);
+            BEAST_EXPECT(to.got_binary());
+            BEAST_EXPECT(buffers_to_string(b.data()) == s);
+            b.clear();
+
+            // a compressed message after it
+            from.write(net::buffer(s));
+            to.read(b);
+            BEAST_EXPECT(buffers_to_string(b.data()) == s);
+        }
+
+        // closed
+        {
+            net::io_context ioc;
+            stream<test::stream> ws{ioc};
+            std::string m = s;
+            error_code ec;
+            ws.write_inplace(net::buffer(&m[0], m.size()), ec);
+            BEAST_EXPECTS(
+                ec == net::error::operation_aborted,
+                ec.message());
+        }
+    }
+
+    void
+    testSend()
+    {
+        for(int i = 0; i < 2; ++i)
+        {
+            bool const client = i == 1;
+            net::io_context ioc;
+            stream<test::stream> wsc{ioc};
+            stream<test::stream> wss{ioc};
+            wsc.next_layer().connect(wss.next_layer());
+            wsc.async_handshake(
+                "localhost", "/", [](error_code){});
+            wss.async_accept([](error_code){});
+            ioc.run();
+            ioc.restart();
+            auto& from = client ? wsc : wss;
+            auto& to = client ? wss : wsc;
+            flat_buffer b;
+
+            // frames queued while writing are
+            // coalesced into a single write
+            auto n0 = from.next_layer().nwrite();
+            std::size_t count = 0;
+            for(auto s : {"a", "bc", "def"})
+                from.async_send(net::buffer(std::string(s)),
+                    [&](error_code ec, std::size_t)
+                    {
+                        BEAST_EXPECTS(! ec, ec.message());
+                        ++count;
+                    });
+            BEAST_EXPECT(count == 0);
+            ioc.run();
+            ioc.restart();
+            BEAST_EXPECT(count == 3);
+            BEAST_EXPECT(from.next_layer().nwrite() == n0 + 2);
+            BEAST_EXPECT(from.send_queue_size() == 0);
+            for(auto s : {"a", "bc", "def"})
+            {
+                to.read(b);
+                BEAST_EXPECT(to.got_text());
+                BEAST_EXPECT(buffers_to_string(b.data()) == s);
+                b.clear();
+            }
+
+            // mixed with async_write and async_ping
+            from.binary(true);
+            from.async_write(net::buffer("1", 1),
+                [&](error_code ec, std::size_t)
+                {
+                    BEAST_EXPECTS(! ec, ec.message());
+                });
+            from.async_send(net::buffer(std::string("2")),
+                [&](error_code ec, std::size_t n)
+                {
+                    BEAST_EXPECTS(! ec, ec.message());
+                    BEAST_EXPECT(n == 1);
+                });
+            from.async_ping({},
+                [&](error_code ec)
+                {
+                    BEAST_EXPECTS(! ec, ec.message());
+                });
+            ioc.run();
+            ioc.restart();
+            for(auto s : {"1", "2"})
+            {
+                to.read(b);
+                BEAST_EXPECT(to.got_binary());
+                BEAST_EXPECT(buffers_to_string(b.data()) == s);
+                b.clear();
+            }
+            from.text(true);
+
+            // the queue is held while a message is incomplete
+            from.async_write_some(false, net::buffer("ab", 2),
+                [&](error_code ec, std::size_t)
+                {
+                    BEAST_EXPECTS(! ec, ec.message());
+                    from.async_write_some(true,
+                        net::buffer("cd", 2),
+                        [&](error_code ec, std::size_t)
+                        {
+                            BEAST_EXPECTS(! ec, ec.message());
+                        });
+                });
+            from.async_send(net::buffer(std::string("x")),
+                [&](error_code ec, std::size_t)
+                {
+                    BEAST_EXPECTS(! ec, ec.message());
+                });
+            ioc.run();
+            ioc.restart();
+            to.read(b);
+            BEAST_EXPECT(buffers_to_string(b.data()) == "abcd");
+            b.clear();
+            to.read(b);
+            BEAST_EXPECT(buffers_to_string(b.data()) == "x");
+            b.clear();
+
+            // handlers wait above the limit
+            from.send_queue_limit(20);
+            BEAST_EXPECT(from.send_queue_limit() == 20);
+            std::string const s(10, '*');
+            std::vector<int> done;
+            for(int j = 0; j < 4; ++j)
+                from.async_send(net::buffer(s),
+                    [&, j](error_code ec, std::size_t n)
+                    {
+                        BEAST_EXPECTS(! ec, ec.message());
+                        BEAST_EXPECT(n == s.size());
+                        done.push_back(j);
+                    });
+            BEAST_EXPECT(from.send_queue_size() ==
+                4 * (s.size() + (client ? 6 : 2)));
+            BEAST_EXPECT(done.empty());
+            ioc.run();
+            ioc.restart();
+            BEAST_EXPECT((done == std::vector<int>{0, 1, 2, 3}));
+            BEAST_EXPECT(from.send_queue_size() == 0);
+            for(int j = 0; j < 4; ++j)
+            {
+                to.read(b);
+                BEAST_EXPECT(buffers_to_string(b.data()) == s);
+                b.clear();
+            }
+
+            // messages queued before a close frame are sent
+            std::size_t sent = 0;
+            for(auto m : {"x1", "x2"})
+                from.async_send(net::buffer(std::string(m)),
+                    [&](error_code ec, std::size_t n)
+                    {
+                        BEAST_EXPECTS(! ec, ec.message());
+                        BEAST_EXPECT(n == 2);
+                        ++sent;
+                    });
+
+            // after a close frame
+            from.async_close({},
+                [&](error_code ec)
+                {
+                    BEAST_EXPECTS(! ec, ec.message());
+                });
+            from.async_send(net::buffer(s),
+                [&](error_code ec, std::size_t)
+                {
+                    BEAST_EXPECTS(
+                        ec == net::error::operation_aborted,
+                        ec.message());
+                });
+            std::vector<std::string> got;
+            std::function<void(error_code, std::size_t)> on_read =
+                [&](error_code ec, std::size_t)
+                {
+                    if(ec)
+                    {
+                        BEAST_EXPECTS(ec == error::closed, ec.message());
+                        return;
+                    }
+                    got.push_back(buffers_to_string(b.data()));
+                    b.clear();
+                    to.async_read(b, on_read);
+                };
+            to.async_read(b, on_read);
+            ioc.run();
+            BEAST_EXPECT(sent == 2);
+            BEAST_EXPECT((got == std::vector<std::string>{"x1", "x2"}));
+        }
+
+        // closed
+        {
+            net::io_context ioc;
+            stream<test::stream> ws{ioc};
+            bool invoked = false;
+            ws.async_send(net::buffer("*", 1),
+                [&](error_code ec, std::size_t)
+                {
+                    invoked = true;
+                    BEAST_EXPECTS(
+                        ec == net::error::operation_aborted,
+                        ec.message());
+                });
+            ioc.run();
+            BEAST_EXPECT(invoked);
+        }
+    }
+
 #if BOOST_ASIO_HAS_CO_AWAIT
     void testAwaitableCompiles(
         stream<test::stream>& s,
@@ -746,6 +1016,8 @@ public:
         testMoveOnly();
         testIssue300();
         testIssue1666();
+        testWriteInplace();
+        testSend();
 #if BOOST_ASIO_HAS_CO_AWAIT
         boost::ignore_unused(&write_test::testAwaitableCompiles);
 #endif